@@ -38,7 +38,10 @@ endfunction()
 
 function(ngine_add_game)
     # Get parameters
-    set (options)
+    set (options
+            COOK_CONTENT # Cook content into native formats with a manifest before it is copied or packed (Desktop only)
+            PACK_CONTENT # Pack content into an archive instead of copying the directory (Desktop only)
+            )
     set (oneValueArgs
             # Game info
             NAME # Game name
@@ -252,11 +255,45 @@ function(ngine_add_game)
     # Get content dir name
     get_filename_component(CONTENT_DIR_NAME ${GAME_CONTENT_DIR} NAME)
 
+    # Cook content into the build directory, it is then copied or packed from there.
+    # This runs every build, NgineCook skips files whose output is newer than the source.
+    set(GAME_CONTENT_SOURCE_DIR ${GAME_CONTENT_DIR})
+    if (${PLATFORM} MATCHES "Desktop" AND GAME_COOK_CONTENT)
+        if (NOT TARGET NgineCook)
+            message(FATAL_ERROR "[Ngine] COOK_CONTENT requires the NgineCook tool, enable BUILD_TOOLS")
+        endif()
+
+        set(GAME_CONTENT_SOURCE_DIR ${CMAKE_CURRENT_BINARY_DIR}/${CONTENT_DIR_NAME}Cooked)
+        add_custom_target(${GAME_TARGET_NAME}Cook
+                COMMAND NgineCook
+                ${GAME_CONTENT_DIR}
+                ${GAME_CONTENT_SOURCE_DIR}
+                DEPENDS NgineCook
+                SOURCES ${GAME_CONTENT_FILES})
+        add_dependencies(${GAME_TARGET_NAME} ${GAME_TARGET_NAME}Cook)
+    endif()
+
     # Include content
-    if (${PLATFORM} MATCHES "Desktop")
+    if (${PLATFORM} MATCHES "Desktop" AND GAME_PACK_CONTENT)
+        if (NOT TARGET NginePack)
+            message(FATAL_ERROR "[Ngine] PACK_CONTENT requires the NginePack tool, enable BUILD_TOOLS")
+        endif()
+
+        # Pack content next to the executable, Resources mounts it in place of the content directory
+        add_custom_target(${GAME_TARGET_NAME}Content
+                COMMAND NginePack
+                ${GAME_CONTENT_SOURCE_DIR}
+                $<TARGET_FILE_DIR:${GAME_TARGET_NAME}>/${CONTENT_DIR_NAME}.npak
+                DEPENDS NginePack
+                SOURCES ${GAME_CONTENT_FILES})
+        if (GAME_COOK_CONTENT)
+            add_dependencies(${GAME_TARGET_NAME}Content ${GAME_TARGET_NAME}Cook)
+        endif()
+        add_dependencies(${GAME_TARGET_NAME} ${GAME_TARGET_NAME}Content)
+    elseif (${PLATFORM} MATCHES "Desktop")
         add_custom_command(TARGET ${GAME_TARGET_NAME} PRE_BUILD
                 COMMAND ${CMAKE_COMMAND} -E copy_directory
-                ${GAME_CONTENT_DIR}
+                ${GAME_CONTENT_SOURCE_DIR}
                 $<TARGET_FILE_DIR:${GAME_TARGET_NAME}>/${CONTENT_DIR_NAME})
     elseif(${PLATFORM} MATCHES "UWP")
         # Mark for deploy
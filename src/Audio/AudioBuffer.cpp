@@ -11,6 +11,8 @@
 
 #include "AudioBuffer.h"
 
+#include "AudioDevice.h"
+
 namespace NerdThings::Ngine::Audio {
     // Public Methods
     bool AudioBuffer::IsPlaying() const {
@@ -18,40 +20,43 @@ namespace NerdThings::Ngine::Audio {
     }
 
     void AudioBuffer::Pause() {
+        // The mixer skips paused buffers, no command required
         Paused = true;
     }
 
-    void AudioBuffer::Play() {
+    void AudioBuffer::Play(bool rewind_) {
+        // Already playing from where it is
+        if (!rewind_ && IsPlaying()) return;
+
         Playing = true;
         Paused = false;
-        FrameCursorPos = 0;
+        AudioDevice::__PushCommand({AudioDevice::AudioCommand::COMMAND_PLAY, this, rewind_ ? 1.0f : 0.0f});
     }
 
     void AudioBuffer::Resume() {
         Paused = false;
     }
 
-    void AudioBuffer::SetPitch(float pitch_) {
-        float pitchMul = pitch_ / Pitch;
-
-        auto newOutputSampleRate = (ma_uint32)((float)DSP.src.config.sampleRateOut/pitchMul);
-        Pitch *= (float)DSP.src.config.sampleRateOut/newOutputSampleRate;
+    void AudioBuffer::Rewind() {
+        AudioDevice::__PushCommand({AudioDevice::AudioCommand::COMMAND_REWIND, this, 0.0f});
+    }
 
-        ma_pcm_converter_set_output_sample_rate(&DSP, newOutputSampleRate);
+    void AudioBuffer::SetPitch(float pitch_) {
+        AudioDevice::__PushCommand({AudioDevice::AudioCommand::COMMAND_SET_PITCH, this, pitch_});
     }
 
     void AudioBuffer::SetVolume(float vol_) {
-        Volume = vol_;
+        AudioDevice::__PushCommand({AudioDevice::AudioCommand::COMMAND_SET_VOLUME, this, vol_});
     }
 
     void AudioBuffer::Stop() {
         if (IsPlaying()) {
             Playing = false;
             Paused = false;
-            FrameCursorPos = 0;
             TotalFramesProcessed = 0;
             IsSubBufferProcessed[0] = true;
             IsSubBufferProcessed[1] = true;
+            AudioDevice::__PushCommand({AudioDevice::AudioCommand::COMMAND_STOP, this, 0.0f});
         }
     }
-}
\ No newline at end of file
+}
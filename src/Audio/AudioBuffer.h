@@ -16,12 +16,19 @@
 
 #include "../../third-party/miniaudio/miniaudio.h"
 
+#include <atomic>
+
 namespace NerdThings::Ngine::Audio {
     enum EAudioBufferUsage {
         BUFFER_USAGE_STATIC = 0,
         BUFFER_USAGE_STREAM
     };
 
+    /*
+     * A buffer of audio mixed by the audio device.
+     * Methods queue commands for the mixer, so they never wait on the audio thread.
+     * Fields marked as owned by the audio thread must not be touched once the buffer has been played.
+     */
     struct NEAPI AudioBuffer {
         // Public Fields
 
@@ -36,19 +43,21 @@ namespace NerdThings::Ngine::Audio {
         unsigned int BufferSizeInFrames;
 
         /*
-         * PCM Data converter
+         * PCM Data converter.
+         * Owned by the audio thread.
          */
         ma_pcm_converter DSP;
 
         /*
-         * Frame cursor position
+         * Frame cursor position.
+         * Owned by the audio thread.
          */
         unsigned int FrameCursorPos;
 
         /*
          * Sub buffer processed (virtual double buffer)
          */
-        bool IsSubBufferProcessed[2];
+        std::atomic<bool> IsSubBufferProcessed[2];
 
         /*
          * Whether or not the buffer is looping
@@ -56,29 +65,26 @@ namespace NerdThings::Ngine::Audio {
         bool Looping;
 
         /*
-         * The next buffer in the list
+         * Next buffer waiting to be freed, while the release queue is full.
+         * Owned by the audio thread.
          */
-        AudioBuffer *Next;
+        AudioBuffer *NextReleased;
 
         /*
          * Whether or not the buffer is paused
          */
-        bool Paused;
+        std::atomic<bool> Paused;
 
         /*
-         * Buffer pitch
+         * Buffer pitch.
+         * Owned by the audio thread.
          */
         float Pitch;
 
         /*
          * Whether or not the buffer is playing
          */
-        bool Playing;
-
-        /*
-         * Previous buffer on the list
-         */
-        AudioBuffer *Prev;
+        std::atomic<bool> Playing;
 
         /*
          * Total frames processed in this buffer
@@ -91,7 +97,14 @@ namespace NerdThings::Ngine::Audio {
         int Usage;
 
         /*
-         * Buffer volume
+         * Slot in the mixer voice list, -1 while not playing.
+         * Owned by the audio thread.
+         */
+        int VoiceIndex;
+
+        /*
+         * Buffer volume.
+         * Owned by the audio thread.
          */
         float Volume;
 
@@ -108,15 +121,20 @@ namespace NerdThings::Ngine::Audio {
         void Pause();
 
         /*
-         * Play buffer
+         * Play buffer, from the start unless told not to rewind
          */
-        void Play();
+        void Play(bool rewind_ = true);
 
         /*
          * Resume buffer
          */
         void Resume();
 
+        /*
+         * Move the cursor back to the first frame
+         */
+        void Rewind();
+
         /*
          * Set buffer pitch
          */
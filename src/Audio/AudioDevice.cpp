@@ -11,6 +11,8 @@
 
 #include "AudioDevice.h"
 
+#include <chrono>
+
 // To start with, copying raylib so we understand how the system works
 // Then going to begin adding any improvements or features we need
 // Similarly like we did with the OpenGL abstraction
@@ -20,13 +22,20 @@ namespace NerdThings::Ngine::Audio {
 
     std::vector<Music *> AudioDevice::_ActiveMusic;
 
-    ma_mutex AudioDevice::_AudioLock;
-    AudioBuffer *AudioDevice::_BufferFirst;
-    AudioBuffer *AudioDevice::_BufferLast;
+    RingBuffer<AudioDevice::AudioCommand, AUDIO_COMMAND_QUEUE_SIZE> AudioDevice::_Commands;
     ma_context AudioDevice::_Context;
+    std::vector<AudioDevice::AudioCommand> AudioDevice::_Deferred;
+    std::mutex AudioDevice::_DeferredLock;
     ma_device AudioDevice::_Device;
-    bool AudioDevice::_Initialized = false;
-    float AudioDevice::_MasterVolume = 1.0f;
+    RingBuffer<AudioDevice::AudioDiagnostic, AUDIO_DIAGNOSTIC_QUEUE_SIZE> AudioDevice::_Diagnostics;
+    std::atomic<unsigned int> AudioDevice::_DroppedDiagnostics(0);
+    std::thread::id AudioDevice::_GameThread;
+    std::atomic<bool> AudioDevice::_Initialized(false);
+    std::atomic<float> AudioDevice::_MasterVolume(1.0f);
+    AudioBuffer *AudioDevice::_ReleaseBacklog = nullptr;
+    RingBuffer<AudioBuffer *, AUDIO_COMMAND_QUEUE_SIZE> AudioDevice::_Released;
+    unsigned int AudioDevice::_VoiceCount = 0;
+    AudioBuffer *AudioDevice::_Voices[AUDIO_MAX_VOICES];
 
     // Private Methods
 
@@ -39,7 +48,7 @@ namespace NerdThings::Ngine::Audio {
         auto currentSubBufferIndex = buffer->FrameCursorPos/subBufferSizeInFrames;
 
         if (currentSubBufferIndex > 1) {
-            ConsoleMessage("Frame cursor position moved too far forward in audio stream.", "WARN", "AudioDevice");
+            __PushDiagnostic(DIAGNOSTIC_CURSOR_OVERRUN);
             return 0;
         }
 
@@ -84,7 +93,7 @@ namespace NerdThings::Ngine::Audio {
 
                 // Stop if not looping
                 if (!buffer->Looping) {
-                    buffer->Stop();
+                    __StopVoice(buffer);
                     break;
                 }
             }
@@ -102,136 +111,273 @@ namespace NerdThings::Ngine::Audio {
         return framesRead;
     }
 
+    void AudioDevice::__FreeReleasedBuffers() {
+        AudioBuffer *buffer;
+        while (_Released.Pop(buffer)) {
+            free(buffer->Buffer);
+            delete buffer;
+        }
+    }
+
     void AudioDevice::__LogCallback(ma_context *pContext, ma_device *pDevice, ma_uint32 logLevel, const char *msg) {
         ConsoleMessage(std::string(msg), "ERR", "miniaudio");
     }
 
     void AudioDevice::__MixAudioFrames(float *framesOut_, const float *framesIn_, ma_uint32 frameCount_,
-                                       float localVolume_) {
+                                       float volume_) {
         for (ma_uint32 iFrame = 0; iFrame < frameCount_; ++iFrame) {
             for (ma_uint32 iChannel = 0; iChannel < _Device.playback.channels; ++iChannel) {
                 float *frameOut = framesOut_ + (iFrame*_Device.playback.channels);
                 const float *frameIn = framesIn_ + (iFrame*_Device.playback.channels);
 
-                frameOut[iChannel] += (frameIn[iChannel]*_MasterVolume*localVolume_);
+                frameOut[iChannel] += (frameIn[iChannel]*volume_);
             }
         }
     }
 
+    void AudioDevice::__ProcessCommands() {
+        // Retry releases that did not fit, the game thread may free a buffer as soon as it is pushed
+        while (_ReleaseBacklog != nullptr) {
+            auto next = _ReleaseBacklog->NextReleased;
+            if (!_Released.Push(_ReleaseBacklog)) break;
+            _ReleaseBacklog = next;
+        }
+
+        AudioCommand command;
+        while (_Commands.Pop(command)) {
+            auto buffer = command.Buffer;
+
+            switch (command.Type) {
+                case AudioCommand::COMMAND_PLAY: {
+                    if (command.Value != 0.0f) buffer->FrameCursorPos = 0;
+                    if (buffer->VoiceIndex >= 0) {
+                        buffer->Playing = true;
+                        break;
+                    }
+
+                    if (_VoiceCount == AUDIO_MAX_VOICES) {
+                        __PushDiagnostic(DIAGNOSTIC_VOICE_LIMIT);
+                        buffer->Playing = false;
+                        break;
+                    }
+
+                    buffer->Playing = true;
+                    buffer->VoiceIndex = _VoiceCount;
+                    _Voices[_VoiceCount++] = buffer;
+                } break;
+
+                case AudioCommand::COMMAND_RELEASE: {
+                    __StopVoice(buffer);
+
+                    // The game thread frees it, nothing here may allocate or free
+                    if (!_Released.Push(buffer)) {
+                        buffer->NextReleased = _ReleaseBacklog;
+                        _ReleaseBacklog = buffer;
+                    }
+                } break;
+
+                case AudioCommand::COMMAND_REWIND: {
+                    buffer->FrameCursorPos = 0;
+                } break;
+
+                case AudioCommand::COMMAND_SET_PITCH: {
+                    float pitchMul = command.Value / buffer->Pitch;
+
+                    auto newOutputSampleRate = (ma_uint32)((float)buffer->DSP.src.config.sampleRateOut/pitchMul);
+                    buffer->Pitch *= (float)buffer->DSP.src.config.sampleRateOut/newOutputSampleRate;
+
+                    ma_pcm_converter_set_output_sample_rate(&buffer->DSP, newOutputSampleRate);
+                } break;
+
+                case AudioCommand::COMMAND_SET_VOLUME: {
+                    buffer->Volume = command.Value;
+                } break;
+
+                case AudioCommand::COMMAND_STOP: {
+                    __StopVoice(buffer);
+                } break;
+            }
+        }
+    }
+
+    void AudioDevice::__PushCommand(const AudioCommand &command_) {
+        if (!_Initialized) return;
+
+        std::lock_guard<std::mutex> lock(_DeferredLock);
+        auto gameThread = std::this_thread::get_id() == _GameThread;
+        if (gameThread && _Deferred.empty() && _Commands.Push(command_)) return;
+
+        // Anything behind a backlog is sent with it so the order is kept
+        auto backlog = !_Deferred.empty();
+        _Deferred.push_back(command_);
+        if (gameThread && !backlog) __SendDeferredCommands();
+    }
+
+    void AudioDevice::__PushDiagnostic(AudioDiagnostic diagnostic_) {
+        if (!_Diagnostics.Push(diagnostic_)) _DroppedDiagnostics.fetch_add(1, std::memory_order_relaxed);
+    }
+
     void AudioDevice::__SendAudioDataToDevice(ma_device *pDevice, void *pFramesOut, const void *pFramesInput,
                                               ma_uint32 frameCount) {
         if (!_Initialized) return;
         // Mixing is just an accumulation, init output buffer to 0
         memset(pFramesOut, 0, frameCount*pDevice->playback.channels*ma_get_bytes_per_sample(pDevice->playback.format));
 
-        // Mutex for thread safety
-        ma_mutex_lock(&_AudioLock);
-        {
-            for (auto buffer = _BufferFirst; buffer != nullptr; buffer = buffer->Next) {
-                // Ignore stopped or paused sounds
-                if (!buffer->Playing || buffer->Paused) continue;
+        // Catch up with the game thread
+        __ProcessCommands();
 
-                ma_uint32 framesRead = 0;
+        auto masterVolume = _MasterVolume.load(std::memory_order_relaxed);
 
-                while(true) {
-                    if (framesRead > frameCount) {
-                        ConsoleMessage("Mixed too many frames from audio buffer.", "WARN", "AudioDevice");
-                        break;
-                    }
+        for (unsigned int i = 0; i < _VoiceCount;) {
+            auto buffer = _Voices[i];
 
-                    if (framesRead == frameCount) break;
+            // Ignore paused sounds
+            if (buffer->Paused) {
+                i++;
+                continue;
+            }
 
-                    // Read as much as we can
-                    ma_uint32 framesToRead = (frameCount - framesRead);
+            ma_uint32 framesRead = 0;
 
-                    while (framesToRead > 0) {
-                        float tmpBuffer[1024];
+            while(true) {
+                if (framesRead > frameCount) {
+                    __PushDiagnostic(DIAGNOSTIC_MIX_OVERRUN);
+                    break;
+                }
 
-                        ma_uint32 framesToReadRightNow = framesToRead;
-                        if (framesToReadRightNow > sizeof(tmpBuffer)/sizeof(tmpBuffer[0])/DEVICE_CHANNELS) {
-                            framesToReadRightNow = sizeof(tmpBuffer)/sizeof(tmpBuffer[0])/DEVICE_CHANNELS;
-                        }
+                if (framesRead == frameCount) break;
 
-                        ma_uint32 framesJustRead = (ma_uint32)ma_pcm_converter_read(&buffer->DSP, tmpBuffer, framesToReadRightNow);
-                        if (framesJustRead > 0) {
-                            float *framesOut = (float *)pFramesOut + (framesRead*_Device.playback.channels);
-                            float *framesIn = tmpBuffer;
+                // Read as much as we can
+                ma_uint32 framesToRead = (frameCount - framesRead);
 
-                            __MixAudioFrames(framesOut, framesIn, framesJustRead, buffer->Volume);
+                while (framesToRead > 0) {
+                    float tmpBuffer[1024];
 
-                            framesToRead -= framesJustRead;
-                            framesRead += framesJustRead;
-                        }
+                    ma_uint32 framesToReadRightNow = framesToRead;
+                    if (framesToReadRightNow > sizeof(tmpBuffer)/sizeof(tmpBuffer[0])/DEVICE_CHANNELS) {
+                        framesToReadRightNow = sizeof(tmpBuffer)/sizeof(tmpBuffer[0])/DEVICE_CHANNELS;
+                    }
 
-                        if (framesJustRead < framesToReadRightNow) {
-                            if (!buffer->Looping) {
-                                buffer->Stop();
-                                break;
-                            } else {
-                                buffer->FrameCursorPos = 0;
-                                continue;
-                            }
-                        }
+                    ma_uint32 framesJustRead = (ma_uint32)ma_pcm_converter_read(&buffer->DSP, tmpBuffer, framesToReadRightNow);
+                    if (framesJustRead > 0) {
+                        float *framesOut = (float *)pFramesOut + (framesRead*_Device.playback.channels);
+                        float *framesIn = tmpBuffer;
+
+                        __MixAudioFrames(framesOut, framesIn, framesJustRead, masterVolume*buffer->Volume);
+
+                        framesToRead -= framesJustRead;
+                        framesRead += framesJustRead;
                     }
 
-                    if (framesToRead > 0) break;
+                    if (framesJustRead < framesToReadRightNow) {
+                        if (!buffer->Looping) {
+                            __StopVoice(buffer);
+                            break;
+                        } else {
+                            buffer->FrameCursorPos = 0;
+                            continue;
+                        }
+                    }
                 }
+
+                if (framesToRead > 0) break;
             }
+
+            // A stopped buffer was swapped out for the last voice, which still needs mixing
+            if (i < _VoiceCount && _Voices[i] == buffer) i++;
         }
-        ma_mutex_unlock(&_AudioLock);
     }
 
-    void AudioDevice::__TrackAudioBuffer(AudioBuffer *buffer_) {
-        if (!_Initialized) return;
-        ma_mutex_lock(&_AudioLock);
-        {
-            if (_BufferFirst == nullptr) _BufferFirst = buffer_;
-            else {
-                _BufferLast->Next = buffer_;
-                buffer_->Prev = _BufferLast;
+    void AudioDevice::__SendDeferredCommands() {
+        __FreeReleasedBuffers();
+
+        // The audio thread empties the queue every period, so this only waits if the game floods it or the device stalls
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(AUDIO_COMMAND_TIMEOUT);
+        unsigned int sent = 0;
+        while (sent < _Deferred.size()) {
+            if (_Commands.Push(_Deferred[sent])) {
+                sent++;
+                continue;
             }
 
-            _BufferLast = buffer_;
+            // Nothing empties the queue while the device is stopped, so apply the commands here
+            if (!ma_device_is_started(&_Device)) {
+                __ProcessCommands();
+                __FreeReleasedBuffers();
+                continue;
+            }
+
+            if (std::chrono::steady_clock::now() >= deadline) {
+                ConsoleMessage("Audio thread is not keeping up, " + std::to_string(_Deferred.size() - sent) + " commands will be sent later.", "WARN", "AudioDevice");
+                break;
+            }
+
+            __FreeReleasedBuffers();
+            std::this_thread::yield();
         }
-        ma_mutex_unlock(&_AudioLock);
+
+        _Deferred.erase(_Deferred.begin(), _Deferred.begin() + sent);
     }
 
-    void AudioDevice::__UntrackAudioBuffer(AudioBuffer *buffer_) {
-        if (!_Initialized) return;
-        ma_mutex_lock(&_AudioLock);
-        {
-            if (buffer_->Prev == nullptr) _BufferFirst = buffer_->Next;
-            else buffer_->Prev->Next = buffer_->Next;
+    void AudioDevice::__StopVoice(AudioBuffer *buffer_) {
+        buffer_->Playing = false;
+        buffer_->Paused = false;
+        buffer_->FrameCursorPos = 0;
 
-            if (buffer_->Next == nullptr) _BufferLast = buffer_->Prev;
-            else buffer_->Next->Prev = buffer_->Prev;
+        if (buffer_->VoiceIndex < 0) return;
 
-            buffer_->Prev = nullptr;
-            buffer_->Next = nullptr;
-        }
-        ma_mutex_unlock(&_AudioLock);
+        // Swap the last voice into the gap
+        auto last = _Voices[--_VoiceCount];
+        _Voices[buffer_->VoiceIndex] = last;
+        last->VoiceIndex = buffer_->VoiceIndex;
+        buffer_->VoiceIndex = -1;
     }
 
     // Public Methods
 
     void AudioDevice::CloseAudioBuffer(AudioBuffer *buffer_) {
-        if (!_Initialized) return;
-        if (buffer_ != nullptr) {
-            // Untrack buffer
-            __UntrackAudioBuffer(buffer_);
+        if (buffer_ == nullptr) return;
 
-            // Delete
+        // Without an audio thread nothing else can be using it
+        if (!_Initialized) {
             free(buffer_->Buffer);
             delete buffer_;
+            return;
         }
+
+        // Free anything already released, then hand this buffer back through the audio thread so it is never freed mid-mix
+        if (std::this_thread::get_id() == _GameThread) __FreeReleasedBuffers();
+        __PushCommand({AudioCommand::COMMAND_RELEASE, buffer_, 0.0f});
     }
 
     void AudioDevice::Close() {
         if (_Initialized) {
+            // Stop the audio thread, then apply whatever it did not get to
+            ma_device_uninit(&_Device);
+            {
+                std::lock_guard<std::mutex> lock(_DeferredLock);
+                __SendDeferredCommands();
+            }
+            __ProcessCommands();
+            __FreeReleasedBuffers();
+
+            while (_ReleaseBacklog != nullptr) {
+                auto next = _ReleaseBacklog->NextReleased;
+                free(_ReleaseBacklog->Buffer);
+                delete _ReleaseBacklog;
+                _ReleaseBacklog = next;
+            }
+
+            // Buffers still playing belong to their sounds, a new device starts with no voices
+            for (unsigned int i = 0; i < _VoiceCount; i++) {
+                _Voices[i]->Playing = false;
+                _Voices[i]->VoiceIndex = -1;
+                _Voices[i] = nullptr;
+            }
+            _VoiceCount = 0;
+
             _Initialized = false;
 
-            ma_mutex_uninit(&_AudioLock);
-            ma_device_uninit(&_Device);
             ma_context_uninit(&_Context);
 
             ConsoleMessage("Audio device closed successfully.", "NOTICE", "AudioDevice");
@@ -283,14 +429,14 @@ namespace NerdThings::Ngine::Audio {
         buffer->Usage = usage_;
         buffer->FrameCursorPos = 0;
         buffer->BufferSizeInFrames = bufferSizeInFrames_;
+        buffer->VoiceIndex = -1;
+        buffer->NextReleased = nullptr;
 
         // Buffers should be marked as processed bu default so they call UpdateAudioStream
         buffer->IsSubBufferProcessed[0] = true;
         buffer->IsSubBufferProcessed[1] = true;
 
-        // Track buffer
-        __TrackAudioBuffer(buffer);
-
+        // The buffer reaches the mixer when it is first played
         return buffer;
     }
 
@@ -362,19 +508,11 @@ namespace NerdThings::Ngine::Audio {
             return;
         }
 
-        // Thread mixer
-        result = ma_mutex_init(&_Context, &_AudioLock);
-        if (result != MA_SUCCESS) {
-            ConsoleMessage("Failed to create mutex for audio mixing.", "ERR", "AudioDevice");
-            ma_device_uninit(&_Device);
-            ma_context_uninit(&_Context);
-            return;
-        }
-
         ConsoleMessage("Audio device initialized successfully!", "NOTICE", "AudioDevice");
         ConsoleMessage("Audio backend: miniaudio/" + std::string(ma_get_backend_name(_Context.backend)), "NOTICE", "AudioDevice");
         ConsoleMessage("Audio format: " + std::string(ma_get_format_name(_Device.playback.format)) + " -> " + std::string(ma_get_format_name(_Device.playback.internalFormat)), "NOTICE", "AudioDevice");
 
+        _GameThread = std::this_thread::get_id();
         _Initialized = true;
     }
 
@@ -383,13 +521,40 @@ namespace NerdThings::Ngine::Audio {
     }
 
     void AudioDevice::SetMasterVolume(float vol_) {
+        if (vol_ < 0.0f) vol_ = 0.0f;
+        if (vol_ > 1.0f) vol_ = 1.0f;
         _MasterVolume = vol_;
-        if (_MasterVolume < 0.0f) _MasterVolume = 0.0f;
-        if (_MasterVolume > 1.0f) _MasterVolume = 1.0f;
     }
 
     void AudioDevice::Update() {
         // We update here so we can add any future stuff
         Music::Update();
+
+        // Send commands from other threads and any that did not fit last time
+        {
+            std::lock_guard<std::mutex> lock(_DeferredLock);
+            if (!_Deferred.empty()) __SendDeferredCommands();
+        }
+
+        __FreeReleasedBuffers();
+
+        // Log anything the audio thread reported
+        AudioDiagnostic diagnostic;
+        while (_Diagnostics.Pop(diagnostic)) {
+            switch (diagnostic) {
+                case DIAGNOSTIC_CURSOR_OVERRUN:
+                    ConsoleMessage("Frame cursor position moved too far forward in audio stream.", "WARN", "AudioDevice");
+                    break;
+                case DIAGNOSTIC_MIX_OVERRUN:
+                    ConsoleMessage("Mixed too many frames from audio buffer.", "WARN", "AudioDevice");
+                    break;
+                case DIAGNOSTIC_VOICE_LIMIT:
+                    ConsoleMessage("Too many sounds playing, a sound was not played.", "WARN", "AudioDevice");
+                    break;
+            }
+        }
+
+        auto dropped = _DroppedDiagnostics.exchange(0, std::memory_order_relaxed);
+        if (dropped > 0) ConsoleMessage(std::to_string(dropped) + " audio warnings were dropped.", "WARN", "AudioDevice");
     }
 }
@@ -18,19 +18,74 @@
 #include "../EventHandler.h"
 #include "AudioBuffer.h"
 #include "Music.h"
+#include "RingBuffer.h"
 #include "Sound.h"
 
+#include <atomic>
+#include <mutex>
+#include <thread>
+
 #define DEVICE_FORMAT ma_format_f32
 #define DEVICE_CHANNELS 2
 #define DEVICE_SAMPLE_RATE 44100
 
 #define AUDIO_BUFFER_SIZE 4096
 
+#define AUDIO_COMMAND_QUEUE_SIZE 1024
+#define AUDIO_COMMAND_TIMEOUT 100
+#define AUDIO_DIAGNOSTIC_QUEUE_SIZE 64
+#define AUDIO_MAX_VOICES 256
+
 namespace NerdThings::Ngine::Audio {
     /*
-     * Audio Manager
+     * Audio Manager.
+     * The audio thread never takes a lock: the game thread sends it commands through a lock-free queue and the mixer owns the list of playing buffers.
+     * Buffer methods and CloseAudioBuffer can be called from any thread, commands from other threads are sent by Update on the game thread.
+     * The game thread is the thread that called Initialize.
      */
     class NEAPI AudioDevice {
+        friend struct AudioBuffer;
+
+        // Private Structs
+
+        /*
+         * A change to a buffer, sent from the game thread to the audio thread
+         */
+        struct AudioCommand {
+            enum CommandType {
+                COMMAND_PLAY,
+                COMMAND_RELEASE,
+                COMMAND_REWIND,
+                COMMAND_SET_PITCH,
+                COMMAND_SET_VOLUME,
+                COMMAND_STOP
+            };
+
+            /*
+             * The command
+             */
+            CommandType Type;
+
+            /*
+             * The buffer to change
+             */
+            AudioBuffer *Buffer;
+
+            /*
+             * Pitch or volume, or whether or not to rewind for play
+             */
+            float Value;
+        };
+
+        /*
+         * Problems found by the audio thread, logged later on the game thread
+         */
+        enum AudioDiagnostic {
+            DIAGNOSTIC_CURSOR_OVERRUN,
+            DIAGNOSTIC_MIX_OVERRUN,
+            DIAGNOSTIC_VOICE_LIMIT
+        };
+
         // Private Fields
 
         /*
@@ -39,39 +94,77 @@ namespace NerdThings::Ngine::Audio {
         static std::vector<Music *> _ActiveMusic;
 
         /*
-         * The audio mutex
+         * Commands waiting for the audio thread
          */
-        static ma_mutex _AudioLock;
+        static RingBuffer<AudioCommand, AUDIO_COMMAND_QUEUE_SIZE> _Commands;
 
         /*
-         * The first tracked buffer
+         * Miniaudio context
          */
-        static AudioBuffer *_BufferFirst;
+        static ma_context _Context;
 
         /*
-         * The last tracked buffer
+         * Commands from other threads, or that did not fit in the queue, waiting to be sent by the game thread in order
          */
-        static AudioBuffer *_BufferLast;
+        static std::vector<AudioCommand> _Deferred;
 
         /*
-         * Miniaudio context
+         * Lock for deferred commands, never taken by the audio thread
          */
-        static ma_context _Context;
+        static std::mutex _DeferredLock;
 
         /*
          * Miniaudio device
          */
         static ma_device _Device;
 
+        /*
+         * Diagnostics waiting to be logged
+         */
+        static RingBuffer<AudioDiagnostic, AUDIO_DIAGNOSTIC_QUEUE_SIZE> _Diagnostics;
+
+        /*
+         * Number of diagnostics lost to a full queue
+         */
+        static std::atomic<unsigned int> _DroppedDiagnostics;
+
+        /*
+         * The thread that called Initialize, the only one that sends commands to the audio thread
+         */
+        static std::thread::id _GameThread;
+
         /*
          * Whether or not the device is initialized
          */
-        static bool _Initialized;
+        static std::atomic<bool> _Initialized;
 
         /*
          * Device master volume
          */
-        static float _MasterVolume;
+        static std::atomic<float> _MasterVolume;
+
+        /*
+         * Buffers released while the release queue was full, linked through NextReleased.
+         * Owned by the audio thread.
+         */
+        static AudioBuffer *_ReleaseBacklog;
+
+        /*
+         * Buffers the audio thread has let go of, waiting to be freed by the game thread
+         */
+        static RingBuffer<AudioBuffer *, AUDIO_COMMAND_QUEUE_SIZE> _Released;
+
+        /*
+         * Number of playing buffers.
+         * Owned by the audio thread.
+         */
+        static unsigned int _VoiceCount;
+
+        /*
+         * Playing buffers.
+         * Owned by the audio thread.
+         */
+        static AudioBuffer *_Voices[AUDIO_MAX_VOICES];
 
         // Private Methods
 
@@ -80,6 +173,11 @@ namespace NerdThings::Ngine::Audio {
          */
         static ma_uint32 __AudioBufferDSPRead(ma_pcm_converter *pDSP, void *pFramesOut, ma_uint32 frameCount, void *pUserData);
 
+        /*
+         * Free buffers released by the audio thread
+         */
+        static void __FreeReleasedBuffers();
+
         /*
          * Log miniaudio errors
          */
@@ -88,7 +186,23 @@ namespace NerdThings::Ngine::Audio {
         /*
          * Audio mixer
          */
-        static void __MixAudioFrames(float *framesOut_, const float *framesIn_, ma_uint32 frameCount_, float localVolume_);
+        static void __MixAudioFrames(float *framesOut_, const float *framesIn_, ma_uint32 frameCount_, float volume_);
+
+        /*
+         * Apply queued commands, on the audio thread
+         */
+        static void __ProcessCommands();
+
+        /*
+         * Queue a command for the audio thread.
+         * Commands from other threads are deferred to Update.
+         */
+        static void __PushCommand(const AudioCommand &command_);
+
+        /*
+         * Report a problem from the audio thread
+         */
+        static void __PushDiagnostic(AudioDiagnostic diagnostic_);
 
         /*
          * Send audio data to the audio device
@@ -96,14 +210,16 @@ namespace NerdThings::Ngine::Audio {
         static void __SendAudioDataToDevice(ma_device *pDevice, void *pFramesOut, const void *pFramesInput, ma_uint32 frameCount);
 
         /*
-         * Track an audio device
+         * Send deferred commands in order, on the game thread with the deferred lock held.
+         * Waits up to AUDIO_COMMAND_TIMEOUT milliseconds for space, anything left is sent on the next try.
+         * Commands are applied here if the device has stopped.
          */
-        static void __TrackAudioBuffer(AudioBuffer *buffer_);
+        static void __SendDeferredCommands();
 
         /*
-         * Untrack an audio device
+         * Stop a buffer and take it out of the voice list, on the audio thread
          */
-        static void __UntrackAudioBuffer(AudioBuffer *buffer_);
+        static void __StopVoice(AudioBuffer *buffer_);
     public:
         // Public Methods
 
@@ -146,7 +262,7 @@ namespace NerdThings::Ngine::Audio {
 
         /*
          * Update.
-         * Handles music updating.
+         * Handles music updating, sending deferred commands, freeing closed buffers and logging audio thread diagnostics.
          */
         static void Update();
     };
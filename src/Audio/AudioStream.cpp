@@ -18,8 +18,9 @@ namespace NerdThings::Ngine::Audio {
                 ma_uint32 subBufferToUpdate = 0;
 
                 if (Buffer->IsSubBufferProcessed[0] && Buffer->IsSubBufferProcessed[1]) {
+                    // The mixer has run dry, restart it from the first sub buffer
                     subBufferToUpdate = 0;
-                    Buffer->FrameCursorPos = 0;
+                    Buffer->Rewind();
                 } else {
                     subBufferToUpdate = (Buffer->IsSubBufferProcessed[0]) ? 0 : 1;
                 }
@@ -15,9 +15,22 @@
 #include <dr_flac.h>
 #include <stb_vorbis.h>
 
+#include "../Filesystem/Archive.h"
 #include "AudioDevice.h"
 
 namespace NerdThings::Ngine::Audio {
+    // Public Constructor(s)
+
+    Music::Music(Music &&music_) noexcept
+            : CTXData(music_.CTXData), CTXType(music_.CTXType), LoopCount(music_.LoopCount), SampleCount(music_.SampleCount),
+              SourceFile(std::move(music_.SourceFile)), Stream(music_.Stream), _LoopsCompleted(music_._LoopsCompleted) {
+        music_.CTXData = nullptr;
+        music_.Stream.Buffer = nullptr;
+
+        // Keep streaming if the music is playing
+        std::replace(_ActiveMusic.begin(), _ActiveMusic.end(), &music_, this);
+    }
+
     // Destructor
 
     Music::~Music() {
@@ -26,6 +39,13 @@ namespace NerdThings::Ngine::Audio {
 
     // Public Methods
 
+    int Music::GetDataSize() const {
+        auto dataSize = 0;
+        if (SourceFile != nullptr) dataSize += SourceFile->GetSize();
+        if (Stream.Buffer != nullptr) dataSize += Stream.Buffer->BufferSizeInFrames*Stream.Channels*Stream.SampleSize/8;
+        return dataSize;
+    }
+
     float Music::GetLength() {
         return (float)SampleCount/(float)(Stream.SampleRate*Stream.Channels);
     }
@@ -40,7 +60,7 @@ namespace NerdThings::Ngine::Audio {
     }
 
     bool Music::IsPlaying() const {
-        return Stream.Buffer->IsPlaying();
+        return Stream.Buffer != nullptr && Stream.Buffer->IsPlaying();
     }
 
     bool Music::IsValid() const {
@@ -51,11 +71,31 @@ namespace NerdThings::Ngine::Audio {
         auto music = new Music();
         bool loaded = false;
 
+        // Archived files stream from a mapping of the archive, pages are read as the decoder reaches them.
+        // Loose files stream through file reads, as a mapping faults if the file is rewritten in place while playing.
+        const unsigned char *data = nullptr;
+        auto size = 0;
+
+        if (Filesystem::Archive::Resolve(path_, nullptr) != nullptr) {
+            try {
+                music->SourceFile = std::make_unique<Filesystem::FileMapping>(path_);
+            } catch (std::runtime_error &e) {
+                ConsoleMessage("Could not open music file: " + std::string(e.what()), "WARN", "Music");
+                delete music;
+                return nullptr;
+            }
+
+            data = music->SourceFile->GetData();
+            size = music->SourceFile->GetSize();
+        }
+
+        auto file = path_.GetString();
+
         if (path_.GetFileExtension() == "mp3") {
             auto ctxMp3 = (drmp3 *) malloc(sizeof(drmp3));
             music->CTXData = ctxMp3;
 
-            int result = drmp3_init_file(ctxMp3, path_.GetString().c_str(), nullptr);
+            int result = data != nullptr ? drmp3_init_memory(ctxMp3, data, size, nullptr) : drmp3_init_file(ctxMp3, file.c_str(), nullptr);
 
             if (result > 0) {
                 music->CTXType = AUDIO_MP3;
@@ -67,7 +107,7 @@ namespace NerdThings::Ngine::Audio {
             }
         } else if (path_.GetFileExtension() == "ogg") {
             // Open ogg audio stream
-            music->CTXData = stb_vorbis_open_filename(path_.GetString().c_str(), nullptr, nullptr);
+            music->CTXData = data != nullptr ? stb_vorbis_open_memory(data, size, nullptr, nullptr) : stb_vorbis_open_filename(file.c_str(), nullptr, nullptr);
 
             if (music->CTXData != nullptr) {
                 music->CTXType = AUDIO_OGG;
@@ -81,7 +121,7 @@ namespace NerdThings::Ngine::Audio {
                 loaded = true;
             }
         } else if (path_.GetFileExtension() == "flac") {
-            music->CTXData = drflac_open_file(path_.GetString().c_str());
+            music->CTXData = data != nullptr ? drflac_open_memory(data, size) : drflac_open_file(file.c_str());
 
             if (music->CTXData != nullptr) {
                 music->CTXType = AUDIO_FLAC;
@@ -127,9 +167,8 @@ namespace NerdThings::Ngine::Audio {
     }
 
     void Music::Play() {
-        ma_uint32 curCursorPos = Stream.Buffer->FrameCursorPos;
-        Stream.Buffer->Play();
-        Stream.Buffer->FrameCursorPos = curCursorPos;
+        // Continue from the current position
+        Stream.Buffer->Play(false);
 
         // Add to active music
         auto it = std::find(_ActiveMusic.begin(), _ActiveMusic.end(), this);
@@ -171,7 +210,14 @@ namespace NerdThings::Ngine::Audio {
     }
 
     void Music::Unload() {
-        AudioDevice::CloseAudioBuffer(Stream.Buffer);
+        // Music::Update must not stream into a closed buffer or freed decoder
+        _ActiveMusic.erase(std::remove(_ActiveMusic.begin(), _ActiveMusic.end(), this), _ActiveMusic.end());
+
+        if (Stream.Buffer != nullptr) {
+            Stream.Buffer->Stop();
+            AudioDevice::CloseAudioBuffer(Stream.Buffer);
+            Stream.Buffer = nullptr;
+        }
 
         switch(CTXType) {
             case AUDIO_MP3: {
@@ -189,11 +235,14 @@ namespace NerdThings::Ngine::Audio {
         }
 
         CTXData = nullptr;
+        SourceFile = nullptr;
         ConsoleMessage("Unloaded music stream.", "NOTICE", "Music");
     }
 
     void Music::Update() {
-        for (auto mus : _ActiveMusic) {
+        // Updates stop and restart music, which changes the active list
+        auto active = _ActiveMusic;
+        for (auto mus : active) {
             mus->__Update();
         }
     }
@@ -268,4 +317,25 @@ namespace NerdThings::Ngine::Audio {
             if (Stream.Buffer->IsPlaying()) Play();
         }
     }
+
+    // Operators
+
+    Music &Music::operator=(Music &&music_) noexcept {
+        if (this == &music_) return *this;
+
+        Unload();
+        CTXData = music_.CTXData;
+        CTXType = music_.CTXType;
+        LoopCount = music_.LoopCount;
+        SampleCount = music_.SampleCount;
+        SourceFile = std::move(music_.SourceFile);
+        Stream = music_.Stream;
+        _LoopsCompleted = music_._LoopsCompleted;
+        music_.CTXData = nullptr;
+        music_.Stream.Buffer = nullptr;
+
+        // Keep streaming if the music is playing
+        std::replace(_ActiveMusic.begin(), _ActiveMusic.end(), &music_, this);
+        return *this;
+    }
 }
@@ -53,17 +53,41 @@ namespace NerdThings::Ngine::Audio {
          */
         unsigned int SampleCount;
 
+        /*
+         * The mapped archive entry the decoder streams from, null for loose files which stream through file reads
+         */
+        std::unique_ptr<Filesystem::FileMapping> SourceFile;
+
         /*
          * The audio stream
          */
         AudioStream Stream;
 
+        // Public Constructor(s)
+
+        /*
+         * Create a null music stream
+         */
+        Music() = default;
+
+        Music(const Music &) = delete;
+
+        /*
+         * Take the decoder and stream of other music
+         */
+        Music(Music &&music_) noexcept;
+
         // Destructor
 
         ~Music();
 
         // Public Methods
 
+        /*
+         * Get the size of the mapped source file and the stream buffer
+         */
+        int GetDataSize() const;
+
         /*
          * Get length in seconds
          */
@@ -129,6 +153,14 @@ namespace NerdThings::Ngine::Audio {
          */
         static void Update();
 
+        // Operators
+
+        Music &operator=(const Music &) = delete;
+
+        /*
+         * Unload this music and take the decoder and stream of other music
+         */
+        Music &operator=(Music &&music_) noexcept;
     private:
         // Private Fields
 
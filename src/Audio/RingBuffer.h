@@ -0,0 +1,86 @@
+/**********************************************************************************************
+*
+*   Ngine - The 2D game engine.
+*
+*   Copyright (C) 2019 NerdThings
+*
+*   LICENSE: Apache License 2.0
+*   View: https://github.com/NerdThings/Ngine/blob/master/LICENSE
+*
+**********************************************************************************************/
+
+
+#ifndef RINGBUFFER_H
+#define RINGBUFFER_H
+
+#include "../Ngine.h"
+
+#include <atomic>
+
+namespace NerdThings::Ngine::Audio {
+    /*
+     * Fixed size lock-free queue with one producer thread and one consumer thread.
+     * Neither side ever blocks or allocates, so it is safe to use from the audio callback.
+     * Capacity must be a power of two, one slot is kept free.
+     */
+    template<typename ItemType, unsigned int Capacity>
+    class RingBuffer {
+        static_assert((Capacity & (Capacity - 1)) == 0, "Ring buffer capacity must be a power of two.");
+
+        // Private Fields
+
+        /*
+         * Next slot to read, only written by the consumer
+         */
+        std::atomic<unsigned int> _Head{0};
+
+        /*
+         * The slots
+         */
+        ItemType _Items[Capacity];
+
+        /*
+         * Next slot to write, only written by the producer
+         */
+        std::atomic<unsigned int> _Tail{0};
+    public:
+        // Public Methods
+
+        /*
+         * Whether or not the queue is empty.
+         * Only exact on the consumer thread.
+         */
+        bool IsEmpty() const {
+            return _Head.load(std::memory_order_acquire) == _Tail.load(std::memory_order_acquire);
+        }
+
+        /*
+         * Take the oldest item, on the consumer thread.
+         * Returns false if the queue is empty.
+         */
+        bool Pop(ItemType &item_) {
+            auto head = _Head.load(std::memory_order_relaxed);
+            if (head == _Tail.load(std::memory_order_acquire)) return false;
+
+            item_ = _Items[head];
+            _Head.store((head + 1) & (Capacity - 1), std::memory_order_release);
+            return true;
+        }
+
+        /*
+         * Add an item, on the producer thread.
+         * Returns false if the queue is full.
+         */
+        bool Push(const ItemType &item_) {
+            auto tail = _Tail.load(std::memory_order_relaxed);
+            auto next = (tail + 1) & (Capacity - 1);
+            if (next == _Head.load(std::memory_order_acquire)) return false;
+
+            _Items[tail] = item_;
+            _Tail.store(next, std::memory_order_release);
+            return true;
+        }
+    };
+}
+
+#endif //RINGBUFFER_H
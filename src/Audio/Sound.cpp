@@ -16,6 +16,13 @@
 #include "AudioDevice.h"
 
 namespace NerdThings::Ngine::Audio {
+    // Public Constructor(s)
+
+    Sound::Sound(Sound &&sound_) noexcept
+            : SampleCount(sound_.SampleCount), Stream(sound_.Stream) {
+        sound_.Stream.Buffer = nullptr;
+    }
+
     // Destructor
 
     Sound::~Sound() {
@@ -24,8 +31,13 @@ namespace NerdThings::Ngine::Audio {
 
     // Public Methods
 
+    int Sound::GetDataSize() const {
+        if (Stream.Buffer == nullptr) return 0;
+        return Stream.Buffer->BufferSizeInFrames*Stream.Channels*Stream.SampleSize/8;
+    }
+
     bool Sound::IsPlaying() const {
-        return Stream.Buffer->IsPlaying();
+        return Stream.Buffer != nullptr && Stream.Buffer->IsPlaying();
     }
 
     bool Sound::IsValid() const {
@@ -50,14 +62,20 @@ namespace NerdThings::Ngine::Audio {
             ma_format formatIn = ((wave_->SampleSize == 8) ? ma_format_u8 : ((wave_->SampleSize == 16) ? ma_format_s16 : ma_format_f32));
             ma_uint32 frameCountIn = wave_->SampleCount/wave_->Channels;
 
-            ma_uint32 frameCount = (ma_uint32)ma_convert_frames(nullptr, DEVICE_FORMAT, DEVICE_CHANNELS, DEVICE_SAMPLE_RATE, nullptr, formatIn, wave_->Channels, wave_->SampleRate, frameCountIn);
+            // Cooked waves are already in the device format and are copied straight in
+            auto deviceFormat = formatIn == DEVICE_FORMAT && wave_->Channels == DEVICE_CHANNELS && wave_->SampleRate == DEVICE_SAMPLE_RATE;
+
+            ma_uint32 frameCount = deviceFormat ? frameCountIn : (ma_uint32)ma_convert_frames(nullptr, DEVICE_FORMAT, DEVICE_CHANNELS, DEVICE_SAMPLE_RATE, nullptr, formatIn, wave_->Channels, wave_->SampleRate, frameCountIn);
             if (frameCount == 0) ConsoleMessage("Failed to get frame count for format conversion!", "WARN", "Sound");
 
             auto audioBuffer = AudioDevice::InitAudioBuffer(DEVICE_FORMAT, DEVICE_CHANNELS, DEVICE_SAMPLE_RATE, frameCount, BUFFER_USAGE_STATIC);
             if (audioBuffer == nullptr) ConsoleMessage("Failed to create audio buffer!", "WARN", "Sound");
 
-            frameCount = (ma_uint32)ma_convert_frames(audioBuffer->Buffer, audioBuffer->DSP.formatConverterIn.config.formatIn, audioBuffer->DSP.formatConverterIn.config.channels, audioBuffer->DSP.src.config.sampleRateIn, wave_->Data, formatIn, wave_->Channels, wave_->SampleRate, frameCountIn);
-            if (frameCount == 0) ConsoleMessage("Format conversion failed!", "WARN", "Sound");
+            if (deviceFormat) memcpy(audioBuffer->Buffer, wave_->Data, frameCount*DEVICE_CHANNELS*sizeof(float));
+            else {
+                frameCount = (ma_uint32)ma_convert_frames(audioBuffer->Buffer, audioBuffer->DSP.formatConverterIn.config.formatIn, audioBuffer->DSP.formatConverterIn.config.channels, audioBuffer->DSP.src.config.sampleRateIn, wave_->Data, formatIn, wave_->Channels, wave_->SampleRate, frameCountIn);
+                if (frameCount == 0) ConsoleMessage("Format conversion failed!", "WARN", "Sound");
+            }
 
             snd->SampleCount = frameCount*DEVICE_CHANNELS;
             snd->Stream.SampleRate = DEVICE_SAMPLE_RATE;
@@ -100,4 +118,16 @@ namespace NerdThings::Ngine::Audio {
         AudioDevice::CloseAudioBuffer(Stream.Buffer);
         Stream.Buffer = nullptr;
     }
+
+    // Operators
+
+    Sound &Sound::operator=(Sound &&sound_) noexcept {
+        if (this == &sound_) return *this;
+
+        Unload();
+        SampleCount = sound_.SampleCount;
+        Stream = sound_.Stream;
+        sound_.Stream.Buffer = nullptr;
+        return *this;
+    }
 }
@@ -43,12 +43,24 @@ namespace NerdThings::Ngine::Audio {
          */
         Sound() {}
 
+        Sound(const Sound &) = delete;
+
+        /*
+         * Take the audio buffer of another sound
+         */
+        Sound(Sound &&sound_) noexcept;
+
         // Destructor
 
         ~Sound();
 
         // Public Methods
 
+        /*
+         * Get the size of the PCM data held for the sound
+         */
+        int GetDataSize() const;
+
         /*
          * Whether or not the sound is playing.
          */
@@ -103,6 +115,15 @@ namespace NerdThings::Ngine::Audio {
          * Unload sound
          */
         void Unload() override;
+
+        // Operators
+
+        Sound &operator=(const Sound &) = delete;
+
+        /*
+         * Unload this sound and take the audio buffer of another
+         */
+        Sound &operator=(Sound &&sound_) noexcept;
     };
 }
 
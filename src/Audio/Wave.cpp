@@ -15,12 +15,69 @@
 #include <dr_mp3.h>
 #include <dr_wav.h>
 #include <stb_vorbis.h>
+#include <miniaudio.h>
+
+// Native wave format
+#define NATIVE_WAVE_HEADER_SIZE 32
+#define NATIVE_WAVE_VERSION 1
 
 namespace NerdThings::Ngine::Audio {
     Wave::~Wave() {
         Unload();
     }
 
+    void Wave::ConvertFormat(unsigned int sampleRate_, unsigned int sampleSize_, unsigned int channels_) {
+        if (!IsValid()) return;
+        if (SampleRate == sampleRate_ && SampleSize == sampleSize_ && Channels == channels_) return;
+
+        ma_format formatIn = ((SampleSize == 8) ? ma_format_u8 : ((SampleSize == 16) ? ma_format_s16 : ma_format_f32));
+        ma_format formatOut = ((sampleSize_ == 8) ? ma_format_u8 : ((sampleSize_ == 16) ? ma_format_s16 : ma_format_f32));
+        ma_uint32 frameCountIn = SampleCount/Channels;
+
+        ma_uint32 frameCount = (ma_uint32)ma_convert_frames(nullptr, formatOut, channels_, sampleRate_, nullptr, formatIn, Channels, SampleRate, frameCountIn);
+        if (frameCount == 0) {
+            ConsoleMessage("Failed to get frame count for format conversion!", "WARN", "Wave");
+            return;
+        }
+
+        auto data = malloc(frameCount*channels_*sampleSize_/8);
+        frameCount = (ma_uint32)ma_convert_frames(data, formatOut, channels_, sampleRate_, Data, formatIn, Channels, SampleRate, frameCountIn);
+
+        free(Data);
+        Data = data;
+        SampleCount = frameCount*channels_;
+        SampleRate = sampleRate_;
+        SampleSize = sampleSize_;
+        Channels = channels_;
+    }
+
+    bool Wave::Export(const Filesystem::Path &path_) const {
+        if (!IsValid()) return false;
+
+        if (path_.GetFileExtension() != "nwav") {
+            ConsoleMessage("Waves can only be exported as nwav.", "ERR", "Wave");
+            return false;
+        }
+
+        auto file = Filesystem::File(path_);
+        if (!file.Open(Filesystem::MODE_WRITE, true)) return false;
+
+        // Write header
+        unsigned int header[NATIVE_WAVE_HEADER_SIZE / sizeof(unsigned int)] = {};
+        memcpy(header, "NWAV", 4);
+        header[1] = NATIVE_WAVE_VERSION;
+        header[2] = SampleRate;
+        header[3] = SampleSize;
+        header[4] = Channels;
+        header[5] = SampleCount;
+
+        auto success = file.WriteBytes((unsigned char *)header, NATIVE_WAVE_HEADER_SIZE)
+                       && file.WriteBytes((unsigned char *)Data, SampleCount*SampleSize/8);
+
+        file.Close();
+        return success;
+    }
+
     bool Wave::IsValid() const {
         return Data != nullptr; // TODO: Any more checks??
     }
@@ -28,14 +85,25 @@ namespace NerdThings::Ngine::Audio {
     Wave *Wave::LoadWave(const Filesystem::Path &path_) {
         auto wav = new Wave();
 
+        // Decode from memory so archived files work too
+        std::unique_ptr<Filesystem::FileMapping> file;
+        try {
+            file = std::make_unique<Filesystem::FileMapping>(path_);
+        } catch (std::runtime_error &e) {
+            ConsoleMessage("Unable to open wave file: " + std::string(e.what()), "ERR", "Wave");
+            return wav;
+        }
+
         if (path_.GetFileExtension() == "mp3") {
-            wav->__LoadMP3(path_);
+            wav->__LoadMP3(*file);
         } else if (path_.GetFileExtension() == "wav") {
-            wav->__LoadWAV(path_);
+            wav->__LoadWAV(*file);
         } else if (path_.GetFileExtension() == "ogg") {
-            wav->__LoadOGG(path_);
+            wav->__LoadOGG(*file);
         } else if (path_.GetFileExtension() == "flac") {
-            wav->__LoadFLAC(path_);
+            wav->__LoadFLAC(*file);
+        } else if (path_.GetFileExtension() == "nwav") {
+            wav->__LoadNative(*file);
         } else ConsoleMessage("File format not supported.", "ERR", "Wave");
 
         return wav;
@@ -47,10 +115,10 @@ namespace NerdThings::Ngine::Audio {
         ConsoleMessage("Unloaded wav data from RAM.", "NOTICE", "Wave");
     }
 
-    void Wave::__LoadFLAC(const Filesystem::Path &path_) {
+    void Wave::__LoadFLAC(const Filesystem::FileMapping &file_) {
         // Decode entire FLAC file in one go
         uint64_t totalSampleCount;
-        Data = drflac_open_file_and_read_pcm_frames_s16(path_.GetString().c_str(), &Channels, &SampleRate, &totalSampleCount);
+        Data = drflac_open_memory_and_read_pcm_frames_s16(file_.GetData(), file_.GetSize(), &Channels, &SampleRate, &totalSampleCount);
 
         SampleCount = (unsigned int) totalSampleCount;
         SampleSize = 16;
@@ -61,11 +129,11 @@ namespace NerdThings::Ngine::Audio {
         else ConsoleMessage("Loaded FLAC file successfully!", "NOTICE", "Wave");
     }
 
-    void Wave::__LoadMP3(const Filesystem::Path &path_) {
+    void Wave::__LoadMP3(const Filesystem::FileMapping &file_) {
         // Decode whole MP3 file in one go
         uint64_t totalFrameCount = 0;
         drmp3_config config = {0};
-        Data = drmp3_open_file_and_read_f32(path_.GetString().c_str(), &config, &totalFrameCount);
+        Data = drmp3_open_memory_and_read_f32(file_.GetData(), file_.GetSize(), &config, &totalFrameCount);
 
         Channels = config.outputChannels;
         SampleRate = config.outputSampleRate;
@@ -79,9 +147,42 @@ namespace NerdThings::Ngine::Audio {
         else ConsoleMessage("Loaded MP3 file successfully!", "NOTICE", "Wave");
     }
 
-    void Wave::__LoadOGG(const Filesystem::Path &path_) {
+    void Wave::__LoadNative(const Filesystem::FileMapping &file_) {
+        // Read header
+        unsigned int header[NATIVE_WAVE_HEADER_SIZE / sizeof(unsigned int)];
+        if (file_.GetSize() < NATIVE_WAVE_HEADER_SIZE || memcmp(file_.GetData(), "NWAV", 4) != 0) {
+            ConsoleMessage("File is not a valid native wave.", "ERR", "Wave");
+            return;
+        }
+
+        memcpy(header, file_.GetData(), NATIVE_WAVE_HEADER_SIZE);
+        if (header[1] != NATIVE_WAVE_VERSION) {
+            ConsoleMessage("Native wave version " + std::to_string(header[1]) + " is not supported.", "ERR", "Wave");
+            return;
+        }
+
+        auto sampleSize = header[3];
+        auto channels = header[4];
+        auto dataSize = (unsigned long long)header[5]*sampleSize/8;
+        if ((sampleSize != 8 && sampleSize != 16 && sampleSize != 32) || channels == 0 || channels > 2
+            || dataSize == 0 || NATIVE_WAVE_HEADER_SIZE + dataSize > (unsigned long long)file_.GetSize()) {
+            ConsoleMessage("Native wave header is invalid.", "ERR", "Wave");
+            return;
+        }
+
+        // The samples are stored ready to use
+        Data = malloc(dataSize);
+        memcpy(Data, file_.GetData() + NATIVE_WAVE_HEADER_SIZE, dataSize);
+
+        SampleRate = header[2];
+        SampleSize = sampleSize;
+        Channels = channels;
+        SampleCount = header[5];
+    }
+
+    void Wave::__LoadOGG(const Filesystem::FileMapping &file_) {
         // Load ogg file
-        stb_vorbis *oggFile = stb_vorbis_open_filename(path_.GetString().c_str(), nullptr, nullptr);
+        stb_vorbis *oggFile = stb_vorbis_open_memory(file_.GetData(), file_.GetSize(), nullptr, nullptr);
 
         if (oggFile == nullptr) ConsoleMessage("OGG file could not be opened.", "WARN", "Wave");
         else {
@@ -102,10 +203,10 @@ namespace NerdThings::Ngine::Audio {
         }
     }
 
-    void Wave::__LoadWAV(const Filesystem::Path &path_) {
+    void Wave::__LoadWAV(const Filesystem::FileMapping &file_) {
         // Load wav file
         uint64_t totalFrameCount = 0;
-        Data = drwav_open_file_and_read_pcm_frames_f32(path_.GetString().c_str(), &Channels, &SampleRate, &totalFrameCount);
+        Data = drwav_open_memory_and_read_pcm_frames_f32(file_.GetData(), file_.GetSize(), &Channels, &SampleRate, &totalFrameCount);
 
         SampleCount = (int)totalFrameCount*Channels;
         SampleSize = 32;
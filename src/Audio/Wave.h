@@ -55,6 +55,18 @@ namespace NerdThings::Ngine::Audio {
 
         // Public Methods
 
+        /*
+         * Convert the samples to another sample rate, sample size and channel count.
+         * Sample sizes of 8, 16 and 32 (float) bits are supported.
+         */
+        void ConvertFormat(unsigned int sampleRate_, unsigned int sampleSize_, unsigned int channels_);
+
+        /*
+         * Export the wave as a native (nwav) file.
+         * The samples are stored as they are, so convert to the device format first for a wave that loads without conversion.
+         */
+        bool Export(const Filesystem::Path &path_) const;
+
         /*
          * Is wave sound valid?
          */
@@ -73,10 +85,11 @@ namespace NerdThings::Ngine::Audio {
     private:
         // Private Methods
 
-        void __LoadFLAC(const Filesystem::Path &path_);
-        void __LoadMP3(const Filesystem::Path &path_);
-        void __LoadOGG(const Filesystem::Path &path_);
-        void __LoadWAV(const Filesystem::Path &path_);
+        void __LoadFLAC(const Filesystem::FileMapping &file_);
+        void __LoadMP3(const Filesystem::FileMapping &file_);
+        void __LoadNative(const Filesystem::FileMapping &file_);
+        void __LoadOGG(const Filesystem::FileMapping &file_);
+        void __LoadWAV(const Filesystem::FileMapping &file_);
     };
 }
 
@@ -0,0 +1,275 @@
+/**********************************************************************************************
+*
+*   Ngine - The 2D game engine.
+*
+*   Copyright (C) 2019 NerdThings
+*
+*   LICENSE: Apache License 2.0
+*   View: https://github.com/NerdThings/Ngine/blob/master/LICENSE
+*
+**********************************************************************************************/
+
+#include "Archive.h"
+
+#include "DirectoryIterator.h"
+#include "LZ4.h"
+
+#include <algorithm>
+#include <cstring>
+
+// Archive format.
+// Header: "NPAK", version, entry count, name table size (all 32-bit, little endian).
+// Followed by the index (sorted by hash), the name table, then entry data aligned to ARCHIVE_DATA_ALIGNMENT.
+#define ARCHIVE_HEADER_SIZE 16
+#define ARCHIVE_VERSION 1
+#define ARCHIVE_DATA_ALIGNMENT 16
+
+namespace NerdThings::Ngine::Filesystem {
+    // Private Fields
+
+    std::mutex Archive::_MountLock;
+    std::vector<Archive::MountPoint> Archive::_Mounts;
+
+    // Private Methods
+
+    const Archive::Entry *Archive::__FindEntry(const std::string &name_) const {
+        auto hash = HashName(name_);
+        auto entry = std::lower_bound(_Entries, _Entries + _EntryCount, hash, [](const Entry &entry_, unsigned long long hash_) {
+            return entry_.Hash < hash_;
+        });
+
+        // Walk any collisions
+        for (; entry != _Entries + _EntryCount && entry->Hash == hash; entry++) {
+            if (entry->NameLength == name_.size() && memcmp(_Names + entry->NameOffset, name_.data(), name_.size()) == 0)
+                return entry;
+        }
+
+        return nullptr;
+    }
+
+    std::string Archive::__NormalizePath(const std::string &path_) {
+        auto path = path_;
+        std::replace(path.begin(), path.end(), '\\', '/');
+        return path;
+    }
+
+    // Public Constructor(s)
+
+    Archive::Archive(const Path &path_) {
+        _Mapping = std::make_unique<FileMapping>(path_);
+        auto data = _Mapping->GetData();
+        auto size = (unsigned long long)_Mapping->GetSize();
+
+        // Read header
+        unsigned int header[ARCHIVE_HEADER_SIZE / sizeof(unsigned int)];
+        if (size < ARCHIVE_HEADER_SIZE) throw std::runtime_error("File is not a valid archive.");
+        memcpy(header, data, ARCHIVE_HEADER_SIZE);
+
+        if (memcmp(header, "NPAK", 4) != 0) throw std::runtime_error("File is not a valid archive.");
+        if (header[1] != ARCHIVE_VERSION)
+            throw std::runtime_error("Archive version " + std::to_string(header[1]) + " is not supported.");
+
+        _EntryCount = header[2];
+        auto namesSize = header[3];
+
+        if (ARCHIVE_HEADER_SIZE + (unsigned long long)_EntryCount * sizeof(Entry) + namesSize > size)
+            throw std::runtime_error("Archive index is truncated.");
+
+        _Entries = (const Entry *)(data + ARCHIVE_HEADER_SIZE);
+        _Names = (const char *)(_Entries + _EntryCount);
+
+        // Check the index once so reads do not have to
+        for (unsigned int i = 0; i < _EntryCount; i++) {
+            auto &entry = _Entries[i];
+            if ((unsigned long long)entry.NameOffset + entry.NameLength > namesSize
+                || entry.Offset > size || entry.StoredSize > size - entry.Offset
+                || (entry.Compression == COMPRESSION_NONE && entry.StoredSize != entry.Size)
+                || entry.Compression > COMPRESSION_LZ4
+                || (i > 0 && _Entries[i - 1].Hash > entry.Hash))
+                throw std::runtime_error("Archive index is invalid.");
+        }
+    }
+
+    // Public Methods
+
+    bool Archive::Contains(const std::string &name_) const {
+        return __FindEntry(name_) != nullptr;
+    }
+
+    const unsigned char *Archive::GetEntryData(const std::string &name_, int *size_) const {
+        auto entry = __FindEntry(name_);
+        if (entry == nullptr || entry->Compression != COMPRESSION_NONE) return nullptr;
+
+        if (size_ != nullptr) *size_ = (int)entry->Size;
+        return _Mapping->GetData() + entry->Offset;
+    }
+
+    std::vector<std::string> Archive::GetEntryNames() const {
+        std::vector<std::string> names;
+        names.reserve(_EntryCount);
+        for (unsigned int i = 0; i < _EntryCount; i++)
+            names.emplace_back(_Names + _Entries[i].NameOffset, _Entries[i].NameLength);
+        return names;
+    }
+
+    int Archive::GetEntrySize(const std::string &name_) const {
+        auto entry = __FindEntry(name_);
+        return entry != nullptr ? (int)entry->Size : -1;
+    }
+
+    unsigned long long Archive::HashName(const std::string &name_) {
+        // FNV-1a
+        auto hash = 14695981039346656037ull;
+        for (auto c : name_) {
+            hash ^= (unsigned char)c;
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+
+    void Archive::Mount(std::shared_ptr<Archive> archive_, const Path &mountPoint_) {
+        if (archive_ == nullptr) throw std::runtime_error("Cannot mount a null archive.");
+
+        auto prefix = __NormalizePath(mountPoint_.GetString());
+        if (!prefix.empty() && prefix.back() != '/') prefix += '/';
+
+        std::unique_lock<std::mutex> lock(_MountLock);
+        _Mounts.insert(_Mounts.begin(), {std::move(archive_), prefix});
+    }
+
+    bool Archive::Pack(const Directory &directory_, const Path &outPath_, bool compress_) {
+        struct PackEntry {
+            Entry Index;
+            std::string Name;
+            Path Source;
+        };
+
+        // Gather entries
+        std::vector<PackEntry> entries;
+        DirectoryIterator it(directory_.GetObjectPath());
+        while (it.Next()) {
+            PackEntry entry = {};
+            entry.Name = it.GetRelativePath();
+            entry.Index.Hash = HashName(entry.Name);
+            entry.Source = Path(it.GetPath());
+            entries.push_back(entry);
+        }
+
+        std::sort(entries.begin(), entries.end(), [](const PackEntry &a_, const PackEntry &b_) {
+            return a_.Index.Hash != b_.Index.Hash ? a_.Index.Hash < b_.Index.Hash : a_.Name < b_.Name;
+        });
+
+        // Build the name table
+        std::string names;
+        for (auto &entry : entries) {
+            entry.Index.NameOffset = (unsigned int)names.size();
+            entry.Index.NameLength = (unsigned int)entry.Name.size();
+            names += entry.Name;
+        }
+
+        auto out = File(outPath_);
+        if (!out.Open(MODE_WRITE, true)) {
+            ConsoleMessage("Unable to create archive.", "ERR", "Archive");
+            return false;
+        }
+
+        // Reserve space for the header and index, they are written once the data offsets are known
+        auto indexSize = ARCHIVE_HEADER_SIZE + entries.size() * sizeof(Entry) + names.size();
+        std::vector<unsigned char> padding(indexSize + ARCHIVE_DATA_ALIGNMENT, 0);
+        auto offset = (unsigned long long)indexSize;
+        if (!out.WriteBytes(padding.data(), (int)indexSize)) return false;
+
+        std::vector<unsigned char> compressed;
+        for (auto &entry : entries) {
+            // Align the data
+            auto aligned = (offset + ARCHIVE_DATA_ALIGNMENT - 1) & ~(unsigned long long)(ARCHIVE_DATA_ALIGNMENT - 1);
+            if (aligned > offset && !out.WriteBytes(padding.data(), (int)(aligned - offset))) return false;
+            offset = aligned;
+
+            // Read the source file
+            auto source = File(entry.Source);
+            if (!source.Open(MODE_READ, true)) {
+                ConsoleMessage("Unable to read \"" + entry.Name + "\".", "ERR", "Archive");
+                return false;
+            }
+
+            auto size = source.GetSize();
+            auto data = std::unique_ptr<unsigned char[]>(size > 0 ? source.ReadBytes() : nullptr);
+            source.Close();
+
+            entry.Index.Offset = offset;
+            entry.Index.Size = (unsigned int)size;
+            entry.Index.Compression = COMPRESSION_NONE;
+            entry.Index.StoredSize = (unsigned int)size;
+
+            auto stored = data.get();
+            if (compress_ && size > 0 && LZ4::Compress(data.get(), size, compressed)) {
+                entry.Index.Compression = COMPRESSION_LZ4;
+                entry.Index.StoredSize = (unsigned int)compressed.size();
+                stored = compressed.data();
+            }
+
+            if (entry.Index.StoredSize > 0 && !out.WriteBytes(stored, (int)entry.Index.StoredSize)) return false;
+            offset += entry.Index.StoredSize;
+        }
+
+        // Write the header and index
+        unsigned int header[ARCHIVE_HEADER_SIZE / sizeof(unsigned int)] = {0, ARCHIVE_VERSION, (unsigned int)entries.size(), (unsigned int)names.size()};
+        memcpy(header, "NPAK", 4);
+
+        fseek(out.GetFileHandle(), 0, SEEK_SET);
+        if (!out.WriteBytes((unsigned char *)header, ARCHIVE_HEADER_SIZE)) return false;
+        for (auto &entry : entries) {
+            if (!out.WriteBytes((unsigned char *)&entry.Index, sizeof(Entry))) return false;
+        }
+        if (!names.empty() && !out.WriteBytes((unsigned char *)names.data(), (int)names.size())) return false;
+
+        out.Close();
+        ConsoleMessage("Packed " + std::to_string(entries.size()) + " files.", "NOTICE", "Archive");
+        return true;
+    }
+
+    std::unique_ptr<unsigned char[]> Archive::ReadEntry(const std::string &name_, int *size_) const {
+        auto entry = __FindEntry(name_);
+        if (entry == nullptr) return nullptr;
+
+        auto data = std::make_unique<unsigned char[]>(std::max(entry->Size, 1u));
+        auto stored = _Mapping->GetData() + entry->Offset;
+
+        if (entry->Compression == COMPRESSION_LZ4) {
+            if (!LZ4::Decompress(stored, (int)entry->StoredSize, data.get(), (int)entry->Size))
+                throw std::runtime_error("Archive entry \"" + name_ + "\" is corrupt.");
+        } else memcpy(data.get(), stored, entry->Size);
+
+        if (size_ != nullptr) *size_ = (int)entry->Size;
+        return data;
+    }
+
+    std::shared_ptr<Archive> Archive::Resolve(const Path &path_, std::string *entryName_) {
+        std::unique_lock<std::mutex> lock(_MountLock);
+        if (_Mounts.empty()) return nullptr;
+
+        auto path = __NormalizePath(path_.GetString());
+        for (auto &mount : _Mounts) {
+            if (path.size() <= mount.Prefix.size() || path.compare(0, mount.Prefix.size(), mount.Prefix) != 0) continue;
+
+            auto name = path.substr(mount.Prefix.size());
+            if (mount.MountedArchive->Contains(name)) {
+                if (entryName_ != nullptr) *entryName_ = name;
+                return mount.MountedArchive;
+            }
+        }
+
+        return nullptr;
+    }
+
+    void Archive::Unmount(const Path &mountPoint_) {
+        auto prefix = __NormalizePath(mountPoint_.GetString());
+        if (!prefix.empty() && prefix.back() != '/') prefix += '/';
+
+        std::unique_lock<std::mutex> lock(_MountLock);
+        _Mounts.erase(std::remove_if(_Mounts.begin(), _Mounts.end(), [&prefix](const MountPoint &mount_) {
+            return mount_.Prefix == prefix;
+        }), _Mounts.end());
+    }
+}
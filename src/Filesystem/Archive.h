@@ -0,0 +1,223 @@
+/**********************************************************************************************
+*
+*   Ngine - The 2D game engine.
+*
+*   Copyright (C) 2019 NerdThings
+*
+*   LICENSE: Apache License 2.0
+*   View: https://github.com/NerdThings/Ngine/blob/master/LICENSE
+*
+**********************************************************************************************/
+
+#ifndef ARCHIVE_H
+#define ARCHIVE_H
+
+#include "../Ngine.h"
+
+#include "Filesystem.h"
+
+#include <mutex>
+
+namespace NerdThings::Ngine::Filesystem {
+    /*
+     * Entry compression mode
+     */
+    enum ArchiveCompression {
+        /*
+         * Stored as is
+         */
+        COMPRESSION_NONE = 0,
+
+        /*
+         * LZ4 block compressed
+         */
+        COMPRESSION_LZ4 = 1
+    };
+
+    /*
+     * A packed asset archive (.npak).
+     * The archive is memory mapped and holds an index sorted by path hash, so lookups never touch the disk.
+     * Once mounted, File and FileMapping read archived files as if they were on disk.
+     */
+    class NEAPI Archive {
+        // Private Structs
+
+        /*
+         * Index entry, as stored in the archive
+         */
+        struct Entry {
+            /*
+             * Hash of the entry name
+             */
+            unsigned long long Hash;
+
+            /*
+             * Offset of the data from the start of the archive
+             */
+            unsigned long long Offset;
+
+            /*
+             * Size of the stored data
+             */
+            unsigned int StoredSize;
+
+            /*
+             * Size of the original data
+             */
+            unsigned int Size;
+
+            /*
+             * Compression mode
+             */
+            unsigned int Compression;
+
+            /*
+             * Offset of the name in the name table
+             */
+            unsigned int NameOffset;
+
+            /*
+             * Length of the name
+             */
+            unsigned int NameLength;
+
+            /*
+             * Unused
+             */
+            unsigned int Reserved;
+        };
+
+        /*
+         * A mounted archive
+         */
+        struct MountPoint {
+            /*
+             * The archive
+             */
+            std::shared_ptr<Archive> MountedArchive;
+
+            /*
+             * The mount point, with forward slashes and a trailing slash
+             */
+            std::string Prefix;
+        };
+
+        // Private Fields
+
+        /*
+         * The index, sorted by hash
+         */
+        const Entry *_Entries = nullptr;
+
+        /*
+         * Number of entries
+         */
+        unsigned int _EntryCount = 0;
+
+        /*
+         * The mapped archive
+         */
+        std::unique_ptr<FileMapping> _Mapping;
+
+        /*
+         * Lock for the mount table
+         */
+        static std::mutex _MountLock;
+
+        /*
+         * Mounted archives, newest first
+         */
+        static std::vector<MountPoint> _Mounts;
+
+        /*
+         * The name table
+         */
+        const char *_Names = nullptr;
+
+        // Private Methods
+
+        /*
+         * Find the entry for a name
+         */
+        const Entry *__FindEntry(const std::string &name_) const;
+
+        /*
+         * Normalize a path string for mount point comparison
+         */
+        static std::string __NormalizePath(const std::string &path_);
+    public:
+        // Public Constructor(s)
+
+        /*
+         * Open an archive.
+         * Throws if the file is not a valid archive.
+         */
+        Archive(const Path &path_);
+
+        Archive(const Archive &) = delete;
+
+        // Public Methods
+
+        /*
+         * Whether or not the archive contains an entry
+         */
+        bool Contains(const std::string &name_) const;
+
+        /*
+         * Get the data of an entry stored without compression.
+         * Returns null if the entry does not exist or is compressed, see ReadEntry instead.
+         * The data is valid for the lifetime of the archive.
+         */
+        const unsigned char *GetEntryData(const std::string &name_, int *size_) const;
+
+        /*
+         * Get the names of all entries
+         */
+        std::vector<std::string> GetEntryNames() const;
+
+        /*
+         * Get the original size of an entry, or -1 if it does not exist
+         */
+        int GetEntrySize(const std::string &name_) const;
+
+        /*
+         * Hash an entry name
+         */
+        static unsigned long long HashName(const std::string &name_);
+
+        /*
+         * Mount an archive so files below the mount point are read from it.
+         * The most recently mounted archive is searched first.
+         */
+        static void Mount(std::shared_ptr<Archive> archive_, const Path &mountPoint_);
+
+        /*
+         * Pack every file in a directory into an archive.
+         * Entries that do not compress well are stored as is.
+         */
+        static bool Pack(const Directory &directory_, const Path &outPath_, bool compress_ = true);
+
+        /*
+         * Read an entry, decompressing it if required.
+         * Returns null if the entry does not exist.
+         */
+        std::unique_ptr<unsigned char[]> ReadEntry(const std::string &name_, int *size_) const;
+
+        /*
+         * Find the mounted archive holding a path.
+         * Returns null if the path is not archived.
+         */
+        static std::shared_ptr<Archive> Resolve(const Path &path_, std::string *entryName_);
+
+        /*
+         * Unmount every archive at a mount point
+         */
+        static void Unmount(const Path &mountPoint_);
+
+        // Operators
+
+        Archive &operator=(const Archive &) = delete;
+    };
+}
+
+#endif //ARCHIVE_H
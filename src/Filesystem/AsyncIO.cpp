@@ -0,0 +1,241 @@
+/**********************************************************************************************
+*
+*   Ngine - The 2D game engine.
+*
+*   Copyright (C) 2019 NerdThings
+*
+*   LICENSE: Apache License 2.0
+*   View: https://github.com/NerdThings/Ngine/blob/master/LICENSE
+*
+**********************************************************************************************/
+
+
+#include "AsyncIO.h"
+
+#include "Archive.h"
+
+#if defined(_WIN32) && defined(PLATFORM_DESKTOP)
+#include <Windows.h>
+#elif defined(__linux__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include <cstdio>
+#include <cstring>
+
+namespace NerdThings::Ngine::Filesystem {
+    // Private Fields
+
+    std::deque<AsyncIO::Completion> AsyncIO::_Completions;
+    std::mutex AsyncIO::_CompletionLock;
+    std::condition_variable AsyncIO::_Condition;
+    int AsyncIO::_InFlight = 0;
+    std::mutex AsyncIO::_Lock;
+    std::deque<AsyncIO::ReadRequest> AsyncIO::_Requests;
+    bool AsyncIO::_Running = false;
+    std::vector<std::thread> AsyncIO::_Workers;
+
+    // Private Methods
+
+    int AsyncIO::__Read(const Path &path_, void *data_, int size_, unsigned long long offset_) {
+        if (size_ < 0) return -1;
+
+        // Archived files are copied out of the mapped archive
+        std::string entryName;
+        auto archive = Archive::Resolve(path_, &entryName);
+        if (archive != nullptr) {
+            auto entrySize = 0;
+            auto data = archive->GetEntryData(entryName, &entrySize);
+
+            // Compressed entries have to be unpacked whole
+            std::unique_ptr<unsigned char[]> unpacked;
+            if (data == nullptr) {
+                unpacked = archive->ReadEntry(entryName, &entrySize);
+                data = unpacked.get();
+            }
+
+            if (data == nullptr) return -1;
+            if (offset_ >= (unsigned long long)entrySize) return 0;
+
+            auto count = (int)std::min((unsigned long long)size_, entrySize - offset_);
+            memcpy(data_, data + offset_, count);
+            return count;
+        }
+
+        auto read = 0;
+        auto out = (unsigned char *)data_;
+#if defined(_WIN32) && defined(PLATFORM_DESKTOP)
+        auto file = CreateFileA(path_.GetString().c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (file == INVALID_HANDLE_VALUE) return -1;
+
+        // Each read carries its own position, so the handle has no shared file pointer to race on
+        while (read < size_) {
+            auto position = offset_ + read;
+            OVERLAPPED overlapped = {};
+            overlapped.Offset = (DWORD)(position & 0xFFFFFFFF);
+            overlapped.OffsetHigh = (DWORD)(position >> 32);
+
+            DWORD count = 0;
+            if (!ReadFile(file, out + read, (DWORD)(size_ - read), &count, &overlapped)) {
+                if (GetLastError() == ERROR_HANDLE_EOF) break;
+                CloseHandle(file);
+                return -1;
+            }
+
+            if (count == 0) break;
+            read += (int)count;
+        }
+
+        CloseHandle(file);
+#elif defined(__linux__) || defined(__APPLE__)
+        auto file = open(path_.GetString().c_str(), O_RDONLY | O_CLOEXEC);
+        if (file < 0) return -1;
+
+        // pread leaves the file offset alone, reads may return short so loop until done or at the end
+        while (read < size_) {
+            auto count = pread(file, out + read, (size_t)(size_ - read), (off_t)(offset_ + read));
+            if (count < 0) {
+                close(file);
+                return -1;
+            }
+
+            if (count == 0) break;
+            read += (int)count;
+        }
+
+        close(file);
+#else
+        auto file = fopen(path_.GetString().c_str(), "rb");
+        if (file == nullptr) return -1;
+
+        if (fseek(file, (long)offset_, SEEK_SET) != 0) {
+            fclose(file);
+            return -1;
+        }
+
+        read = (int)fread(out, 1, (size_t)size_, file);
+        fclose(file);
+#endif
+        return read;
+    }
+
+    void AsyncIO::__WorkerLoop() {
+        while (true) {
+            ReadRequest request;
+
+            {
+                std::unique_lock<std::mutex> lock(_Lock);
+                _Condition.wait(lock, []() { return !_Running || !_Requests.empty(); });
+
+                if (!_Running && _Requests.empty()) return;
+
+                request = std::move(_Requests.front());
+                _Requests.pop_front();
+            }
+
+            auto result = -1;
+            try {
+                result = __Read(request.Source, request.Data, request.Size, request.Offset);
+            } catch (std::exception &e) {
+                ConsoleMessage("Read of \"" + request.Source.GetString() + "\" threw an exception: " + std::string(e.what()), "ERR", "AsyncIO");
+            }
+
+            request.Result->set_value(result);
+
+            // Reads without a callback are finished now
+            if (request.Callback != nullptr) {
+                std::unique_lock<std::mutex> lock(_CompletionLock);
+                _Completions.push_back({std::move(request.Callback), result});
+            } else {
+                std::unique_lock<std::mutex> lock(_Lock);
+                _InFlight--;
+            }
+        }
+    }
+
+    // Public Fields
+
+    int AsyncIO::ThreadCount = 2;
+
+    // Public Methods
+
+    int AsyncIO::GetPendingCount() {
+        std::unique_lock<std::mutex> lock(_Lock);
+        return _InFlight;
+    }
+
+    void AsyncIO::Initialize() {
+        std::unique_lock<std::mutex> lock(_Lock);
+        if (_Running) return;
+
+        auto threadCount = ThreadCount < 1 ? 1 : ThreadCount;
+
+        _Running = true;
+        for (auto i = 0; i < threadCount; i++)
+            _Workers.emplace_back(__WorkerLoop);
+    }
+
+    std::shared_future<int> AsyncIO::Read(const Path &path_, void *data_, int size_, unsigned long long offset_, std::function<void(int)> callback_) {
+        Initialize();
+
+        ReadRequest request;
+        request.Callback = std::move(callback_);
+        request.Data = data_;
+        request.Offset = offset_;
+        request.Result = std::make_shared<std::promise<int>>();
+        request.Size = size_;
+        request.Source = path_;
+
+        auto result = request.Result->get_future().share();
+
+        {
+            std::unique_lock<std::mutex> lock(_Lock);
+            _Requests.push_back(std::move(request));
+            _InFlight++;
+        }
+
+        _Condition.notify_one();
+        return result;
+    }
+
+    void AsyncIO::Shutdown() {
+        {
+            std::unique_lock<std::mutex> lock(_Lock);
+            if (!_Running) return;
+            _Running = false;
+        }
+
+        _Condition.notify_all();
+
+        for (auto &worker : _Workers)
+            worker.join();
+        _Workers.clear();
+
+        // Nothing is left to call back into
+        std::unique_lock<std::mutex> lock(_CompletionLock);
+        _Completions.clear();
+
+        std::unique_lock<std::mutex> inFlightLock(_Lock);
+        _InFlight = 0;
+    }
+
+    void AsyncIO::Update() {
+        std::deque<Completion> completions;
+
+        {
+            std::unique_lock<std::mutex> lock(_CompletionLock);
+            if (_Completions.empty()) return;
+            completions.swap(_Completions);
+        }
+
+        {
+            std::unique_lock<std::mutex> lock(_Lock);
+            _InFlight -= (int)completions.size();
+        }
+
+        // Callbacks may queue more reads
+        for (auto &completion : completions)
+            completion.Callback(completion.Result);
+    }
+}
@@ -0,0 +1,184 @@
+/**********************************************************************************************
+*
+*   Ngine - The 2D game engine.
+*
+*   Copyright (C) 2019 NerdThings
+*
+*   LICENSE: Apache License 2.0
+*   View: https://github.com/NerdThings/Ngine/blob/master/LICENSE
+*
+**********************************************************************************************/
+
+
+#ifndef ASYNCIO_H
+#define ASYNCIO_H
+
+#include "../Ngine.h"
+
+#include "Filesystem.h"
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+
+namespace NerdThings::Ngine::Filesystem {
+    /*
+     * Background file reads.
+     * Reads run on dedicated I/O threads, separate from the thread pool so decoding never waits behind the disk.
+     * Data is read straight into memory given by the caller, which must stay valid until the read completes.
+     * Engine resources decode from mapped files on the thread pool and do not use this, it is for game data such as levels.
+     */
+    class NEAPI AsyncIO {
+        // Private Structs
+
+        /*
+         * A finished read waiting for its callback
+         */
+        struct Completion {
+            /*
+             * The callback to run on the main thread
+             */
+            std::function<void(int)> Callback;
+
+            /*
+             * Number of bytes read, or -1 if the read failed
+             */
+            int Result;
+        };
+
+        /*
+         * A queued read
+         */
+        struct ReadRequest {
+            /*
+             * Called on the main thread once the read completes
+             */
+            std::function<void(int)> Callback;
+
+            /*
+             * Where to read to
+             */
+            void *Data;
+
+            /*
+             * Position in the file to read from
+             */
+            unsigned long long Offset;
+
+            /*
+             * The file to read
+             */
+            Path Source;
+
+            /*
+             * The result given to the caller
+             */
+            std::shared_ptr<std::promise<int>> Result;
+
+            /*
+             * Number of bytes to read
+             */
+            int Size;
+        };
+
+        // Private Fields
+
+        /*
+         * Reads waiting for their callbacks, only popped by the main thread
+         */
+        static std::deque<Completion> _Completions;
+
+        /*
+         * Lock for completions
+         */
+        static std::mutex _CompletionLock;
+
+        /*
+         * Signalled when a read is queued or the I/O threads stop
+         */
+        static std::condition_variable _Condition;
+
+        /*
+         * Number of reads queued or running
+         */
+        static int _InFlight;
+
+        /*
+         * Lock for the request queue
+         */
+        static std::mutex _Lock;
+
+        /*
+         * Queued reads
+         */
+        static std::deque<ReadRequest> _Requests;
+
+        /*
+         * Whether or not the I/O threads are running
+         */
+        static bool _Running;
+
+        /*
+         * The I/O threads
+         */
+        static std::vector<std::thread> _Workers;
+
+        // Private Methods
+
+        /*
+         * Read a byte range from a file on the calling thread.
+         * Returns the number of bytes read, or -1 if the file cannot be read.
+         */
+        static int __Read(const Path &path_, void *data_, int size_, unsigned long long offset_);
+
+        /*
+         * I/O thread loop
+         */
+        static void __WorkerLoop();
+    public:
+        // Public Fields
+
+        /*
+         * Number of I/O threads started on first use.
+         * Default: 2
+         */
+        static int ThreadCount;
+
+        // Public Methods
+
+        /*
+         * Get the number of reads that are queued, running or waiting for their callback
+         */
+        static int GetPendingCount();
+
+        /*
+         * Start the I/O threads.
+         * This is called by the first read.
+         */
+        static void Initialize();
+
+        /*
+         * Read up to size_ bytes from a position in a file into data_.
+         * The result is the number of bytes read, which is less than size_ at the end of the file, or -1 if the file cannot be read.
+         * The future is set on the I/O thread so it can be polled from any thread, the callback runs on the main thread in Update.
+         * Files in a mounted archive are read from the archive.
+         */
+        static std::shared_future<int> Read(const Path &path_, void *data_, int size_, unsigned long long offset_ = 0, std::function<void(int)> callback_ = nullptr);
+
+        /*
+         * Stop the I/O threads.
+         * Queued reads are completed first, callbacks that have not run are dropped.
+         */
+        static void Shutdown();
+
+        /*
+         * Run the callbacks of completed reads.
+         * Must be called on the main thread, this is called by the game loop every frame.
+         */
+        static void Update();
+    };
+}
+
+#endif //ASYNCIO_H
@@ -0,0 +1,213 @@
+/**********************************************************************************************
+*
+*   Ngine - The 2D game engine.
+*
+*   Copyright (C) 2019 NerdThings
+*
+*   LICENSE: Apache License 2.0
+*   View: https://github.com/NerdThings/Ngine/blob/master/LICENSE
+*
+**********************************************************************************************/
+
+
+#include "DirectoryIterator.h"
+
+#if defined(_WIN32)
+#include <Windows.h>
+#elif defined(__linux__) || defined(__APPLE__)
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <cstring>
+
+namespace NerdThings::Ngine::Filesystem {
+    // Private Methods
+
+    bool DirectoryIterator::__Push(void *parent_, const char *name_) {
+        Level level = {};
+        level.PathLength = (unsigned int)_Path.size();
+        level.RelativePathLength = (unsigned int)_RelativePath.size();
+#if defined(_WIN32)
+        // The search pattern is appended to the path, then cut off again
+        _Path += "\\*";
+        auto handle = FindFirstFileA(_Path.c_str(), (WIN32_FIND_DATAA *)_FindData);
+        _Path.resize(level.PathLength);
+
+        if (handle == INVALID_HANDLE_VALUE) return false;
+        level.Handle = handle;
+        level.Pending = true;
+#elif defined(__linux__) || defined(__APPLE__)
+        // Open relative to the parent so the kernel does not resolve the whole path again
+        auto fd = parent_ != nullptr
+                  ? openat(dirfd((DIR *)parent_), name_, O_RDONLY | O_DIRECTORY | O_CLOEXEC)
+                  : open(_Path.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        if (fd < 0) return false;
+
+        auto dir = fdopendir(fd);
+        if (dir == nullptr) {
+            close(fd);
+            return false;
+        }
+
+        level.Handle = dir;
+#else
+        return false;
+#endif
+        _Levels.push_back(level);
+        return true;
+    }
+
+    // Public Constructor(s)
+
+    DirectoryIterator::DirectoryIterator(const Path &root_, std::vector<std::string> extensions_)
+            : _Extensions(std::move(extensions_)) {
+        _Path = root_.GetString();
+        while (_Path.size() > 1 && (_Path.back() == '/' || _Path.back() == '\\')) _Path.pop_back();
+
+        // Most content trees are not this deep
+        _Path.reserve(_Path.size() + 256);
+        _RelativePath.reserve(256);
+        _Levels.reserve(16);
+
+#if defined(_WIN32)
+        _FindData = new WIN32_FIND_DATAA;
+#endif
+
+        if (!__Push(nullptr, nullptr)) {
+#if defined(_WIN32)
+            delete (WIN32_FIND_DATAA *)_FindData;
+#endif
+            throw std::runtime_error("Cannot open directory.");
+        }
+    }
+
+    // Destructor
+
+    DirectoryIterator::~DirectoryIterator() {
+        for (auto &level : _Levels) {
+#if defined(_WIN32)
+            FindClose(level.Handle);
+#elif defined(__linux__) || defined(__APPLE__)
+            closedir((DIR *)level.Handle);
+#endif
+        }
+
+#if defined(_WIN32)
+        delete (WIN32_FIND_DATAA *)_FindData;
+#endif
+    }
+
+    // Public Methods
+
+    const char *DirectoryIterator::GetExtension() const {
+        return _ExtensionOffset < _RelativePath.size() ? _RelativePath.c_str() + _ExtensionOffset + 1 : "";
+    }
+
+    const std::string &DirectoryIterator::GetPath() const {
+        return _Path;
+    }
+
+    const std::string &DirectoryIterator::GetRelativePath() const {
+        return _RelativePath;
+    }
+
+    std::string DirectoryIterator::GetRelativePathNoExtension() const {
+        return _RelativePath.substr(0, _ExtensionOffset);
+    }
+
+    unsigned long long DirectoryIterator::GetSize() const {
+        if (_Levels.empty()) return 0;
+#if defined(_WIN32)
+        auto findData = (WIN32_FIND_DATAA *)_FindData;
+        return ((unsigned long long)findData->nFileSizeHigh << 32) | findData->nFileSizeLow;
+#elif defined(__linux__) || defined(__APPLE__)
+        // The file name is the end of the path, stat it relative to its directory
+        auto name = _Path.c_str() + _Levels.back().PathLength + 1;
+
+        struct stat info;
+        if (fstatat(dirfd((DIR *)_Levels.back().Handle), name, &info, 0) != 0) return 0;
+        return (unsigned long long)info.st_size;
+#else
+        return 0;
+#endif
+    }
+
+    bool DirectoryIterator::Next() {
+        while (!_Levels.empty()) {
+            auto &level = _Levels.back();
+            const char *name;
+            bool isDirectory;
+
+#if defined(_WIN32)
+            auto findData = (WIN32_FIND_DATAA *)_FindData;
+            if (level.Pending) level.Pending = false;
+            else if (FindNextFileA(level.Handle, findData) == 0) {
+                FindClose(level.Handle);
+                _Levels.pop_back();
+                continue;
+            }
+
+            name = findData->cFileName;
+            isDirectory = (findData->dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0;
+#elif defined(__linux__) || defined(__APPLE__)
+            auto entry = readdir((DIR *)level.Handle);
+            if (entry == nullptr) {
+                closedir((DIR *)level.Handle);
+                _Levels.pop_back();
+                continue;
+            }
+
+            name = entry->d_name;
+
+            // Some filesystems do not report types
+            if (entry->d_type == DT_UNKNOWN) {
+                struct stat info;
+                if (fstatat(dirfd((DIR *)level.Handle), name, &info, AT_SYMLINK_NOFOLLOW) != 0) continue;
+                isDirectory = S_ISDIR(info.st_mode);
+            } else isDirectory = entry->d_type == DT_DIR;
+#else
+            _Levels.pop_back();
+            continue;
+#endif
+
+            // Skip . and ..
+            if (name[0] == '.' && (name[1] == '\0' || (name[1] == '.' && name[2] == '\0'))) continue;
+
+            // Build the entry paths over the parent paths
+            _Path.resize(level.PathLength);
+#if defined(_WIN32)
+            _Path += '\\';
+#else
+            _Path += '/';
+#endif
+            _Path += name;
+
+            _RelativePath.resize(level.RelativePathLength);
+            if (level.RelativePathLength > 0) _RelativePath += '/';
+            _RelativePath += name;
+
+            if (isDirectory) {
+                if (!__Push(level.Handle, name))
+                    ConsoleMessage("Cannot open directory \"" + _Path + "\".", "WARN", "DirectoryIterator");
+                continue;
+            }
+
+            // Find the extension in the file name
+            auto dot = strrchr(name, '.');
+            _ExtensionOffset = dot != nullptr
+                               ? (unsigned int)(_RelativePath.size() - strlen(dot))
+                               : (unsigned int)_RelativePath.size();
+
+            if (_Extensions.empty()) return true;
+
+            auto ext = GetExtension();
+            for (auto &extension : _Extensions)
+                if (extension == ext) return true;
+        }
+
+        return false;
+    }
+}
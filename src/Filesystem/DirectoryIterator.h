@@ -0,0 +1,148 @@
+/**********************************************************************************************
+*
+*   Ngine - The 2D game engine.
+*
+*   Copyright (C) 2019 NerdThings
+*
+*   LICENSE: Apache License 2.0
+*   View: https://github.com/NerdThings/Ngine/blob/master/LICENSE
+*
+**********************************************************************************************/
+
+
+#ifndef DIRECTORYITERATOR_H
+#define DIRECTORYITERATOR_H
+
+#include "../Ngine.h"
+
+#include "Filesystem.h"
+
+namespace NerdThings::Ngine::Filesystem {
+    /*
+     * Walks every file below a directory without building Path or File objects.
+     * Directories are read one level at a time and the entry paths are built in place, so a walk allocates next to nothing.
+     * Entry strings are only valid until the next call to Next.
+     */
+    class NEAPI DirectoryIterator {
+        // Private Structs
+
+        /*
+         * An open directory on the walk stack
+         */
+        struct Level {
+            /*
+             * The native directory handle
+             */
+            void *Handle;
+
+            /*
+             * Length of the full path of the directory
+             */
+            unsigned int PathLength;
+
+            /*
+             * Whether or not the find data holds an entry not yet visited (Windows only)
+             */
+            bool Pending;
+
+            /*
+             * Length of the relative path of the directory
+             */
+            unsigned int RelativePathLength;
+        };
+
+        // Private Fields
+
+        /*
+         * Position of the extension in the relative path, or its length if there is none
+         */
+        unsigned int _ExtensionOffset = 0;
+
+        /*
+         * Extensions to yield, every file if empty
+         */
+        std::vector<std::string> _Extensions;
+
+        /*
+         * Find data shared by every level (Windows only)
+         */
+        void *_FindData = nullptr;
+
+        /*
+         * Open directories, innermost last
+         */
+        std::vector<Level> _Levels;
+
+        /*
+         * Full path of the current entry
+         */
+        std::string _Path;
+
+        /*
+         * Path of the current entry relative to the root, with forward slashes
+         */
+        std::string _RelativePath;
+
+        // Private Methods
+
+        /*
+         * Open the directory at the current path and push it onto the stack
+         */
+        bool __Push(void *parent_, const char *name_);
+    public:
+        // Public Constructor(s)
+
+        /*
+         * Start walking a directory.
+         * Only files with one of the given extensions (without the dot) are yielded, unless the list is empty.
+         * Throws if the directory cannot be opened.
+         */
+        DirectoryIterator(const Path &root_, std::vector<std::string> extensions_ = {});
+
+        DirectoryIterator(const DirectoryIterator &) = delete;
+
+        // Destructor
+
+        ~DirectoryIterator();
+
+        // Public Methods
+
+        /*
+         * Get the extension of the current file, without the dot
+         */
+        const char *GetExtension() const;
+
+        /*
+         * Get the full path of the current file
+         */
+        const std::string &GetPath() const;
+
+        /*
+         * Get the path of the current file relative to the root, with forward slashes
+         */
+        const std::string &GetRelativePath() const;
+
+        /*
+         * Get the relative path of the current file without its extension
+         */
+        std::string GetRelativePathNoExtension() const;
+
+        /*
+         * Get the size of the current file in bytes.
+         * Takes a stat call on platforms where the directory listing has no sizes.
+         */
+        unsigned long long GetSize() const;
+
+        /*
+         * Move to the next file.
+         * Returns false once every file has been visited.
+         */
+        bool Next();
+
+        // Operators
+
+        DirectoryIterator &operator=(const DirectoryIterator &) = delete;
+    };
+}
+
+#endif //DIRECTORYITERATOR_H
@@ -0,0 +1,153 @@
+/**********************************************************************************************
+*
+*   Ngine - The 2D game engine.
+*
+*   Copyright (C) 2019 NerdThings
+*
+*   LICENSE: Apache License 2.0
+*   View: https://github.com/NerdThings/Ngine/blob/master/LICENSE
+*
+**********************************************************************************************/
+
+#include "FileWatcher.h"
+
+#include "DirectoryIterator.h"
+
+#if defined(__linux__)
+#include <sys/inotify.h>
+#include <unistd.h>
+#else
+#include <sys/types.h>
+#include <sys/stat.h>
+#endif
+
+#include <unordered_set>
+
+#if defined(__linux__)
+#define WATCH_MASK (IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE)
+#endif
+
+namespace NerdThings::Ngine::Filesystem {
+    // Private Methods
+
+    void FileWatcher::__Scan(const Directory &directory_, std::vector<Path> *changed_) {
+#if defined(__linux__)
+        auto path = directory_.GetObjectPath();
+        auto watch = inotify_add_watch(_Handle, path.GetString().c_str(), WATCH_MASK);
+        if (watch < 0) {
+            ConsoleMessage("Unable to watch directory \"" + path.GetString() + "\".", "WARN", "FileWatcher");
+            return;
+        }
+
+        _Watches[watch] = path;
+
+        // Files in a new directory may have been written before it was watched
+        if (changed_ != nullptr) {
+            for (auto &file : directory_.GetFiles())
+                changed_->push_back(file.GetObjectPath());
+        }
+
+        for (auto &directory : directory_.GetDirectories())
+            __Scan(directory, changed_);
+#else
+        DirectoryIterator it(directory_.GetObjectPath());
+        while (it.Next()) {
+            auto &path = it.GetPath();
+
+            struct stat info;
+            if (stat(path.c_str(), &info) != 0) continue;
+
+            auto modified = (long long)info.st_mtime;
+            auto time = _ModifiedTimes.find(path);
+            if (time != _ModifiedTimes.end() && time->second == modified) continue;
+
+            _ModifiedTimes[path] = modified;
+            if (changed_ != nullptr) changed_->push_back(Path(path));
+        }
+#endif
+    }
+
+    // Public Constructor(s)
+
+    FileWatcher::FileWatcher(const Directory &directory_)
+            : _Directory(directory_) {
+#if defined(__linux__)
+        _Handle = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (_Handle < 0) throw std::runtime_error("Unable to create an inotify instance.");
+#else
+        _LastScan = std::chrono::steady_clock::now();
+#endif
+
+        // Start watching, nothing has changed yet
+        __Scan(_Directory, nullptr);
+    }
+
+    // Destructor
+
+    FileWatcher::~FileWatcher() {
+#if defined(__linux__)
+        if (_Handle >= 0) close(_Handle);
+#endif
+    }
+
+    // Public Methods
+
+    Directory FileWatcher::GetDirectory() const {
+        return _Directory;
+    }
+
+    std::vector<Path> FileWatcher::Poll() {
+        std::vector<Path> changed;
+
+#if defined(__linux__)
+        alignas(inotify_event) char buffer[4096];
+
+        // Drain the queue, read fails with EAGAIN once it is empty
+        while (true) {
+            auto length = read(_Handle, buffer, sizeof(buffer));
+            if (length <= 0) break;
+
+            for (auto ptr = buffer; ptr < buffer + length;) {
+                auto event = (const inotify_event *) ptr;
+                ptr += sizeof(inotify_event) + event->len;
+
+                if (event->mask & IN_Q_OVERFLOW) {
+                    ConsoleMessage("Change queue overflowed, some changes were missed.", "WARN", "FileWatcher");
+                    continue;
+                }
+
+                auto watch = _Watches.find(event->wd);
+                if (watch == _Watches.end()) continue;
+
+                // The directory was deleted
+                if (event->mask & IN_IGNORED) {
+                    _Watches.erase(watch);
+                    continue;
+                }
+
+                if (event->len == 0) continue;
+                auto path = watch->second / std::string(event->name);
+
+                if (event->mask & IN_ISDIR) {
+                    if (event->mask & (IN_CREATE | IN_MOVED_TO)) __Scan(Directory(path), &changed);
+                } else if (event->mask & (IN_CLOSE_WRITE | IN_MOVED_TO)) changed.push_back(path);
+            }
+        }
+#else
+        auto now = std::chrono::steady_clock::now();
+        if (std::chrono::duration<double, std::milli>(now - _LastScan).count() < PollInterval) return changed;
+
+        _LastScan = now;
+        __Scan(_Directory, &changed);
+#endif
+
+        // Report each file once
+        std::unordered_set<std::string> seen;
+        std::vector<Path> files;
+        for (auto &path : changed) {
+            if (seen.insert(path.GetString()).second) files.push_back(path);
+        }
+
+        return files;
+    }
+}
@@ -0,0 +1,101 @@
+/**********************************************************************************************
+*
+*   Ngine - The 2D game engine.
+*
+*   Copyright (C) 2019 NerdThings
+*
+*   LICENSE: Apache License 2.0
+*   View: https://github.com/NerdThings/Ngine/blob/master/LICENSE
+*
+**********************************************************************************************/
+
+
+#ifndef FILEWATCHER_H
+#define FILEWATCHER_H
+
+#include "../Ngine.h"
+
+#include "Filesystem.h"
+
+namespace NerdThings::Ngine::Filesystem {
+    /*
+     * Watches a directory tree for changed files.
+     * On Linux this uses inotify, elsewhere modification times are polled.
+     */
+    class NEAPI FileWatcher {
+        // Private Fields
+
+        /*
+         * The watched directory
+         */
+        Directory _Directory;
+
+#if defined(__linux__)
+        /*
+         * The inotify instance
+         */
+        int _Handle = -1;
+
+        /*
+         * Watched directory for each watch descriptor
+         */
+        std::unordered_map<int, Path> _Watches;
+#else
+        /*
+         * When the directory was last scanned
+         */
+        std::chrono::steady_clock::time_point _LastScan;
+
+        /*
+         * Last seen modification time of each file
+         */
+        std::unordered_map<std::string, long long> _ModifiedTimes;
+#endif
+
+        // Private Methods
+
+        /*
+         * Get the modification time of every file, or start watching every directory with inotify
+         */
+        void __Scan(const Directory &directory_, std::vector<Path> *changed_);
+    public:
+        // Public Fields
+
+        /*
+         * Time between scans when modification times are polled, in milliseconds
+         */
+        int PollInterval = 1000;
+
+        // Public Constructor(s)
+
+        /*
+         * Start watching a directory and everything below it
+         */
+        FileWatcher(const Directory &directory_);
+
+        FileWatcher(const FileWatcher &) = delete;
+
+        // Destructor
+
+        ~FileWatcher();
+
+        // Public Methods
+
+        /*
+         * Get the directory being watched
+         */
+        Directory GetDirectory() const;
+
+        /*
+         * Get every file written since the last poll.
+         * Each file is listed once, however many times it was written. This never blocks.
+         */
+        std::vector<Path> Poll();
+
+        // Operators
+
+        FileWatcher &operator=(const FileWatcher &) = delete;
+    };
+}
+
+#endif //FILEWATCHER_H
@@ -11,6 +11,9 @@
 
 #include "Filesystem.h"
 
+#include "Archive.h"
+#include "DirectoryIterator.h"
+
 #if defined(_WIN32)
 #include <Windows.h>
 #include <shlobj.h>
@@ -35,8 +38,13 @@
 #include <dirent.h>
 #include <sys/types.h>
 #include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
 #endif
 
+#include <algorithm>
+#include <climits>
+#include <cstring>
 #include <sstream>
 
 namespace NerdThings::Ngine::Filesystem {
@@ -109,10 +117,10 @@ namespace NerdThings::Ngine::Filesystem {
         return std::string(getenv("APPDATA"));
 #elif defined(__linux__)
         // Home local share
-        return __GetHome() + ".local/share";
+        return __GetHome() + "/.local/share";
 #elif defined(__APPLE__)
         // Application Support
-        return __GetHome() + "/Library/Application Support"
+        return __GetHome() + "/Library/Application Support";
 #endif
 #elif defined(PLATFORM_UWP)
         // Windows specific path
@@ -596,6 +604,38 @@ namespace NerdThings::Ngine::Filesystem {
         InternalHandle = nullptr;
     }
 
+    // Private Methods
+
+    void File::__OpenArchived(std::shared_ptr<Archive> archive_, const std::string &entryName_) {
+        // Use the archive data directly if it is not compressed
+        auto size = 0;
+        auto data = archive_->GetEntryData(entryName_, &size);
+        if (data == nullptr) {
+            _InternalHandle->SourceData = archive_->ReadEntry(entryName_, &size);
+            data = _InternalHandle->SourceData.get();
+        }
+
+#if defined(__linux__) || defined(__APPLE__)
+        // Wrap the data in a stream, it must outlive the handle
+        if (size > 0) {
+            _InternalHandle->InternalHandle = fmemopen((void *)data, size, "rb");
+            _InternalHandle->SourceArchive = archive_;
+        }
+#endif
+
+        // Otherwise go through a temporary file
+        if (_InternalHandle->InternalHandle == nullptr) {
+            _InternalHandle->InternalHandle = tmpfile();
+            if (_InternalHandle->InternalHandle != nullptr) {
+                fwrite(data, 1, size, _InternalHandle->InternalHandle);
+                rewind(_InternalHandle->InternalHandle);
+            }
+
+            _InternalHandle->SourceArchive = nullptr;
+            _InternalHandle->SourceData = nullptr;
+        }
+    }
+
     // Public Constructor(s)
 
     File::File() : FilesystemObject(Path()) {
@@ -627,6 +667,10 @@ namespace NerdThings::Ngine::Filesystem {
             _InternalHandle->InternalHandle = nullptr;
         }
 
+        // Release archived data
+        _InternalHandle->SourceArchive = nullptr;
+        _InternalHandle->SourceData = nullptr;
+
         // Set mode
         _InternalOpenMode = MODE_NONE;
     }
@@ -651,6 +695,9 @@ namespace NerdThings::Ngine::Filesystem {
         // If we are open, we know we exist
         if (IsOpen()) return true;
 
+        // Check mounted archives
+        if (Archive::Resolve(ObjectPath, nullptr) != nullptr) return true;
+
         // Using C apis so that it is cross platform
         FILE *file = fopen(ObjectPath.GetString().c_str(), "r");
         if (file != nullptr) {
@@ -687,9 +734,11 @@ namespace NerdThings::Ngine::Filesystem {
             return 0;
         }
 
+        // Keep the read position
+        auto pos = ftell(_InternalHandle->InternalHandle);
         fseek(_InternalHandle->InternalHandle, 0, SEEK_END);
         auto s = ftell(_InternalHandle->InternalHandle);
-        fseek(_InternalHandle->InternalHandle, 0, SEEK_SET);
+        fseek(_InternalHandle->InternalHandle, pos, SEEK_SET);
 
         return s;
     }
@@ -700,22 +749,35 @@ namespace NerdThings::Ngine::Filesystem {
         return _InternalHandle->InternalHandle != nullptr;
     }
 
+    std::unique_ptr<FileMapping> File::Map() const {
+        return std::make_unique<FileMapping>(ObjectPath);
+    }
+
     bool File::Open(FileOpenMode mode_, bool binary_) {
         // Check validity of path
         if (!ObjectPath.Valid()) throw std::runtime_error("This file's path is invalid");
 
         // Open with selected mode
         switch(mode_) {
-            case MODE_READ:
-                // Check this is actually a file
-                if (ObjectPath.GetResourceType() != TYPE_FILE) throw std::runtime_error("This path does not point to a file.");
-
-                // Open binary file for read
-                _InternalHandle->InternalHandle = fopen(ObjectPath.GetString().c_str(), binary_ ? "rb" : "r");
+            case MODE_READ: {
+                // Read from a mounted archive if the file is archived
+                std::string entryName;
+                auto archive = Archive::Resolve(ObjectPath, &entryName);
+
+                if (archive != nullptr) {
+                    __OpenArchived(archive, entryName);
+                } else {
+                    // Check this is actually a file
+                    if (ObjectPath.GetResourceType() != TYPE_FILE) throw std::runtime_error("This path does not point to a file.");
+
+                    // Open binary file for read
+                    _InternalHandle->InternalHandle = fopen(ObjectPath.GetString().c_str(), binary_ ? "rb" : "r");
+                }
 
                 // Set mode
                 _InternalOpenMode = mode_;
                 break;
+            }
             case MODE_WRITE:
                 // Open binary file for write
                 _InternalHandle->InternalHandle = fopen(ObjectPath.GetString().c_str(), binary_ ? "wb" : "w");
@@ -855,7 +917,7 @@ namespace NerdThings::Ngine::Filesystem {
             throw std::runtime_error("File not opened for writing.");
 
         // Write
-        return fwrite(data_, 1, size_, _InternalHandle->InternalHandle) == 1;
+        return fwrite(data_, 1, size_, _InternalHandle->InternalHandle) == (size_t)size_;
     }
 
     bool File::WriteString(const std::string &string_) {
@@ -873,6 +935,188 @@ namespace NerdThings::Ngine::Filesystem {
         return fputs(string_.c_str(), _InternalHandle->InternalHandle) != EOF;
     }
 
+    ////////
+    // FileMapping
+    ////////
+
+    // Public Constructor(s)
+
+    FileMapping::FileMapping(const Path &path_) {
+        // Check path is valid
+        if (!path_.Valid()) throw std::runtime_error("File must be given a valid path.");
+
+        // Archived files are served from the archive, decompressing if required
+        std::string entryName;
+        _Archive = Archive::Resolve(path_, &entryName);
+
+        if (_Archive != nullptr) {
+            _Data = _Archive->GetEntryData(entryName, &_Size);
+            if (_Data == nullptr) {
+                _FallbackData = _Archive->ReadEntry(entryName, &_Size);
+                _Data = _FallbackData.get();
+            }
+
+            if (_Size <= 0) throw std::runtime_error("Unable to map an empty or oversized file.");
+            return;
+        }
+
+#if defined(_WIN32) && defined(PLATFORM_DESKTOP)
+        auto file = CreateFileA(path_.GetString().c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE) throw std::runtime_error("Unable to open file for mapping.");
+
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(file, &size) || size.QuadPart <= 0 || size.QuadPart > INT_MAX) {
+            CloseHandle(file);
+            throw std::runtime_error("Unable to map an empty or oversized file.");
+        }
+
+        // The mapping keeps the file open
+        _MappingHandle = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        CloseHandle(file);
+        if (_MappingHandle == nullptr) throw std::runtime_error("Unable to map file.");
+
+        _Data = (const unsigned char *)MapViewOfFile(_MappingHandle, FILE_MAP_READ, 0, 0, 0);
+        if (_Data == nullptr) {
+            CloseHandle(_MappingHandle);
+            throw std::runtime_error("Unable to map file.");
+        }
+
+        _Size = (int)size.QuadPart;
+#elif defined(__linux__) || defined(__APPLE__)
+        auto file = open(path_.GetString().c_str(), O_RDONLY);
+        if (file < 0) throw std::runtime_error("Unable to open file for mapping.");
+
+        struct stat info;
+        if (fstat(file, &info) != 0 || info.st_size <= 0 || info.st_size > INT_MAX) {
+            close(file);
+            throw std::runtime_error("Unable to map an empty or oversized file.");
+        }
+
+        // The mapping stays valid once the descriptor is closed
+        auto data = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+        close(file);
+        if (data == MAP_FAILED) throw std::runtime_error("Unable to map file.");
+
+        _Data = (const unsigned char *)data;
+        _Size = (int)info.st_size;
+#else
+        // Read the whole file instead
+        File file(path_);
+        if (!file.Open(MODE_READ, true)) throw std::runtime_error("Unable to open file for mapping.");
+
+        _Size = file.GetSize();
+        if (_Size <= 0) throw std::runtime_error("Unable to map an empty or oversized file.");
+
+        _FallbackData.reset(file.ReadBytes());
+        _Data = _FallbackData.get();
+#endif
+    }
+
+    // Destructor
+
+    FileMapping::~FileMapping() {
+        if (_Archive != nullptr || _FallbackData != nullptr || _Data == nullptr) return;
+
+#if defined(_WIN32) && defined(PLATFORM_DESKTOP)
+        UnmapViewOfFile(_Data);
+        CloseHandle(_MappingHandle);
+#elif defined(__linux__) || defined(__APPLE__)
+        munmap((void *)_Data, _Size);
+#endif
+    }
+
+    // Public Methods
+
+    const unsigned char *FileMapping::GetData() const {
+        return _Data;
+    }
+
+    int FileMapping::GetSize() const {
+        return _Size;
+    }
+
+    ////////
+    // FileReader
+    ////////
+
+    // Public Constructor(s)
+
+    FileReader::FileReader(const Path &path_, int bufferSize_) : _File(path_) {
+        if (!_File.Open(MODE_READ, true)) throw std::runtime_error("Unable to open file for reading.");
+
+        // We buffer ourselves, stdio buffering would copy everything twice
+        setvbuf(_File.GetFileHandle(), nullptr, _IONBF, 0);
+
+        _BufferSize = bufferSize_ > 0 ? bufferSize_ : 1;
+        _Buffer = std::make_unique<unsigned char[]>(_BufferSize);
+        _Size = _File.GetSize();
+    }
+
+    // Public Methods
+
+    int FileReader::GetPosition() const {
+        return _Position;
+    }
+
+    int FileReader::GetSize() const {
+        return _Size;
+    }
+
+    bool FileReader::IsEOF() const {
+        return _Position >= _Size;
+    }
+
+    int FileReader::Read(void *data_, int size_) {
+        if (size_ <= 0) return 0;
+
+        auto out = (unsigned char *)data_;
+
+        // Drain the buffer first
+        auto read = std::min(size_, _BufferEnd - _BufferPosition);
+        memcpy(out, _Buffer.get() + _BufferPosition, read);
+        _BufferPosition += read;
+
+        if (read < size_) {
+            auto handle = _File.GetFileHandle();
+
+            if (size_ - read >= _BufferSize) {
+                // Large reads skip the buffer, which no longer matches the file position
+                read += (int)fread(out + read, 1, size_ - read, handle);
+                _BufferEnd = _BufferPosition = 0;
+            } else {
+                // Refill, then copy what we need
+                _BufferEnd = (int)fread(_Buffer.get(), 1, _BufferSize, handle);
+                _BufferPosition = std::min(size_ - read, _BufferEnd);
+                memcpy(out + read, _Buffer.get(), _BufferPosition);
+                read += _BufferPosition;
+            }
+        }
+
+        _Position += read;
+        return read;
+    }
+
+    bool FileReader::Seek(int position_) {
+        if (position_ < 0 || position_ > _Size) return false;
+
+        // Stay in the buffer if we can
+        auto bufferStart = _Position - _BufferPosition;
+        if (position_ >= bufferStart && position_ <= bufferStart + _BufferEnd) {
+            _BufferPosition = position_ - bufferStart;
+            _Position = position_;
+            return true;
+        }
+
+        if (fseek(_File.GetFileHandle(), position_, SEEK_SET) != 0) return false;
+        _BufferEnd = _BufferPosition = 0;
+        _Position = position_;
+        return true;
+    }
+
+    bool FileReader::Skip(int count_) {
+        return Seek(_Position + count_);
+    }
+
     ////////
     // Directory
     ////////
@@ -1092,17 +1336,10 @@ namespace NerdThings::Ngine::Filesystem {
         // Keep track of all files
         auto files = std::vector<File>();
 
-        // Grab my files
-        auto myFiles = GetFiles();
-        files.insert(files.end(), myFiles.begin(), myFiles.end());
-
-        // Get all descendant directories
-        auto dirs = GetDirectories();
-
-        for (auto dir : dirs) {
-            auto dirFiles = dir.GetFilesRecursive();
-            files.insert(files.end(), dirFiles.begin(), dirFiles.end());
-        }
+        // Walk every descendant directory
+        DirectoryIterator it(ObjectPath);
+        while (it.Next())
+            files.emplace_back(Path(it.GetPath()));
 
         return files;
     }
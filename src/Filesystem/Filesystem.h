@@ -17,6 +17,9 @@
 #include <cstdio>
 
 namespace NerdThings::Ngine::Filesystem {
+    class Archive;
+    class FileMapping;
+
     enum ResourceType {
         TYPE_INVALID = 0,
         TYPE_FILE = 1,
@@ -327,6 +330,16 @@ namespace NerdThings::Ngine::Filesystem {
              */
             FILE *InternalHandle = nullptr;
 
+            /*
+             * The archive an archived file is read from
+             */
+            std::shared_ptr<Archive> SourceArchive;
+
+            /*
+             * Decompressed contents of an archived file
+             */
+            std::unique_ptr<unsigned char[]> SourceData;
+
             // Destructor
 
             ~InternalFileHandler();
@@ -343,6 +356,13 @@ namespace NerdThings::Ngine::Filesystem {
          * Get the current open mode
          */
         FileOpenMode  _InternalOpenMode = MODE_NONE;
+
+        // Private Methods
+
+        /*
+         * Open a file from a mounted archive for reading
+         */
+        void __OpenArchived(std::shared_ptr<Archive> archive_, const std::string &entryName_);
     public:
         // Public Constructors
 
@@ -413,6 +433,12 @@ namespace NerdThings::Ngine::Filesystem {
          */
         bool IsOpen() const;
 
+        /*
+         * Map the whole file into memory for reading, without copying it.
+         * The file is unmapped when the mapping is destroyed. Throws if the file cannot be mapped.
+         */
+        std::unique_ptr<FileMapping> Map() const;
+
         /*
          * Open the file in read or write mode.
          * Binary mode is for non-text files.
@@ -442,6 +468,163 @@ namespace NerdThings::Ngine::Filesystem {
         bool WriteString(const std::string &string_);
     };
 
+    /*
+     * A read-only view of a whole file mapped into memory.
+     * Pages are loaded by the OS as they are touched, so nothing is copied up front.
+     * Platforms without mapping support read the file into memory instead.
+     * Files in a mounted archive are served from the archive.
+     */
+    class NEAPI FileMapping {
+        // Private Fields
+
+        /*
+         * The archive the data belongs to, if the file is archived
+         */
+        std::shared_ptr<Archive> _Archive;
+
+        /*
+         * The mapped data
+         */
+        const unsigned char *_Data = nullptr;
+
+        /*
+         * File contents when the file could not be mapped
+         */
+        std::unique_ptr<unsigned char[]> _FallbackData;
+
+#if defined(_WIN32) && defined(PLATFORM_DESKTOP)
+        /*
+         * The file mapping object
+         */
+        void *_MappingHandle = nullptr;
+#endif
+
+        /*
+         * The size of the mapping
+         */
+        int _Size = 0;
+    public:
+        // Public Constructor(s)
+
+        /*
+         * Map a file for reading.
+         * Throws if the file cannot be opened or is empty.
+         */
+        FileMapping(const Path &path_);
+
+        FileMapping(const FileMapping &) = delete;
+
+        // Destructor
+
+        ~FileMapping();
+
+        // Public Methods
+
+        /*
+         * Get the file contents
+         */
+        const unsigned char *GetData() const;
+
+        /*
+         * Get the size of the file contents
+         */
+        int GetSize() const;
+
+        // Operators
+
+        FileMapping &operator=(const FileMapping &) = delete;
+    };
+
+    /*
+     * Buffered reader for large sequential reads.
+     * Small reads are served from an internal buffer and large reads go straight to the destination, so data is copied once.
+     */
+    class NEAPI FileReader {
+        // Private Fields
+
+        /*
+         * The read buffer
+         */
+        std::unique_ptr<unsigned char[]> _Buffer;
+
+        /*
+         * Number of valid bytes in the buffer
+         */
+        int _BufferEnd = 0;
+
+        /*
+         * Read position in the buffer
+         */
+        int _BufferPosition = 0;
+
+        /*
+         * Size of the buffer
+         */
+        int _BufferSize = 0;
+
+        /*
+         * The file being read
+         */
+        File _File;
+
+        /*
+         * Read position in the file
+         */
+        int _Position = 0;
+
+        /*
+         * Size of the file
+         */
+        int _Size = 0;
+    public:
+        // Public Constructor(s)
+
+        /*
+         * Open a file for reading.
+         * Throws if the file cannot be opened.
+         */
+        FileReader(const Path &path_, int bufferSize_ = 64 * 1024);
+
+        FileReader(const FileReader &) = delete;
+
+        // Public Methods
+
+        /*
+         * Get the read position
+         */
+        int GetPosition() const;
+
+        /*
+         * Get the size of the file
+         */
+        int GetSize() const;
+
+        /*
+         * Whether or not the whole file has been read
+         */
+        bool IsEOF() const;
+
+        /*
+         * Read up to a number of bytes.
+         * Returns the number of bytes read.
+         */
+        int Read(void *data_, int size_);
+
+        /*
+         * Move the read position
+         */
+        bool Seek(int position_);
+
+        /*
+         * Skip a number of bytes
+         */
+        bool Skip(int count_);
+
+        // Operators
+
+        FileReader &operator=(const FileReader &) = delete;
+    };
+
     /*
      * A reference to a directory in the filesystem
      */
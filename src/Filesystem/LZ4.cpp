@@ -0,0 +1,144 @@
+/**********************************************************************************************
+*
+*   Ngine - The 2D game engine.
+*
+*   Copyright (C) 2019 NerdThings
+*
+*   LICENSE: Apache License 2.0
+*   View: https://github.com/NerdThings/Ngine/blob/master/LICENSE
+*
+**********************************************************************************************/
+
+#include "LZ4.h"
+
+#include <algorithm>
+#include <climits>
+#include <cstring>
+
+// LZ4 block format
+#define LZ4_HASH_LOG 16
+#define LZ4_MIN_MATCH 4
+#define LZ4_LAST_LITERALS 5
+#define LZ4_MATCH_FIND_LIMIT 12
+#define LZ4_MAX_OFFSET 65535
+
+namespace NerdThings::Ngine::Filesystem {
+    // Public Methods
+
+    bool LZ4::Compress(const unsigned char *data_, int size_, std::vector<unsigned char> &out_) {
+        out_.clear();
+        out_.reserve(size_ + size_ / 255 + 16);
+
+        auto read32 = [data_](int pos_) {
+            unsigned int value;
+            memcpy(&value, data_ + pos_, 4);
+            return value;
+        };
+
+        auto writeLength = [&out_](int length_) {
+            for (; length_ >= 255; length_ -= 255) out_.push_back(255);
+            out_.push_back((unsigned char)length_);
+        };
+
+        auto writeSequence = [&](int anchor_, int literals_, int offset_, int matchLength_) {
+            // Token holds the literal and match lengths, each overflowing into extra bytes
+            auto matchCode = matchLength_ - LZ4_MIN_MATCH;
+            out_.push_back((unsigned char)((std::min(literals_, 15) << 4) | (offset_ > 0 ? std::min(matchCode, 15) : 0)));
+            if (literals_ >= 15) writeLength(literals_ - 15);
+            out_.insert(out_.end(), data_ + anchor_, data_ + anchor_ + literals_);
+
+            // The last sequence is literals only
+            if (offset_ == 0) return;
+            out_.push_back((unsigned char)(offset_ & 0xFF));
+            out_.push_back((unsigned char)(offset_ >> 8));
+            if (matchCode >= 15) writeLength(matchCode - 15);
+        };
+
+        std::vector<int> table(1 << LZ4_HASH_LOG, -1);
+        auto anchor = 0;
+        auto pos = 0;
+
+        // Matches must start at least 12 bytes and end at least 5 bytes before the end of the block
+        auto matchLimit = size_ - LZ4_LAST_LITERALS;
+        auto searchLimit = size_ - LZ4_MATCH_FIND_LIMIT;
+
+        while (pos <= searchLimit) {
+            auto sequence = read32(pos);
+            auto hash = (sequence * 2654435761u) >> (32 - LZ4_HASH_LOG);
+            auto ref = table[hash];
+            table[hash] = pos;
+
+            if (ref < 0 || pos - ref > LZ4_MAX_OFFSET || read32(ref) != sequence) {
+                // Step further the longer nothing matches, so incompressible data is skipped quickly
+                pos += 1 + ((pos - anchor) >> 6);
+                continue;
+            }
+
+            auto length = LZ4_MIN_MATCH;
+            while (pos + length < matchLimit && data_[ref + length] == data_[pos + length]) length++;
+
+            writeSequence(anchor, pos - anchor, pos - ref, length);
+            pos += length;
+            anchor = pos;
+        }
+
+        writeSequence(anchor, size_ - anchor, 0, 0);
+
+        // Only worth it if it saves at least an eighth
+        return (int)out_.size() < size_ - size_ / 8;
+    }
+
+    bool LZ4::Decompress(const unsigned char *data_, int size_, unsigned char *out_, int outSize_) {
+        auto readLength = [data_, size_](int &pos_, int &length_) {
+            unsigned char byte;
+            do {
+                if (pos_ >= size_) return false;
+                byte = data_[pos_++];
+                length_ += byte;
+            } while (byte == 255 && length_ < INT_MAX - 255);
+            return true;
+        };
+
+        auto pos = 0;
+        auto outPos = 0;
+
+        while (pos < size_) {
+            auto token = data_[pos++];
+
+            // Literals
+            int literals = token >> 4;
+            if (literals == 15 && !readLength(pos, literals)) return false;
+            if (literals > size_ - pos || literals > outSize_ - outPos) return false;
+
+            memcpy(out_ + outPos, data_ + pos, literals);
+            pos += literals;
+            outPos += literals;
+
+            // The last sequence has no match
+            if (pos == size_) break;
+
+            // Match
+            if (size_ - pos < 2) return false;
+            auto offset = data_[pos] | (data_[pos + 1] << 8);
+            pos += 2;
+            if (offset == 0 || offset > outPos) return false;
+
+            int length = token & 15;
+            if (length == 15 && !readLength(pos, length)) return false;
+            length += LZ4_MIN_MATCH;
+            if (length > outSize_ - outPos) return false;
+
+            // Matches may overlap the output they are copying
+            auto match = outPos - offset;
+            if (offset >= length) {
+                memcpy(out_ + outPos, out_ + match, length);
+                outPos += length;
+            } else {
+                for (auto i = 0; i < length; i++)
+                    out_[outPos++] = out_[match++];
+            }
+        }
+
+        return outPos == outSize_;
+    }
+}
@@ -0,0 +1,42 @@
+/**********************************************************************************************
+*
+*   Ngine - The 2D game engine.
+*
+*   Copyright (C) 2019 NerdThings
+*
+*   LICENSE: Apache License 2.0
+*   View: https://github.com/NerdThings/Ngine/blob/master/LICENSE
+*
+**********************************************************************************************/
+
+#ifndef LZ4_H
+#define LZ4_H
+
+#include "../Ngine.h"
+
+// Largest ratio of decompressed to compressed size the block format can reach
+#define LZ4_MAX_RATIO 255
+
+namespace NerdThings::Ngine::Filesystem {
+    /*
+     * LZ4 block codec, used for archive entries and save data.
+     * Intended for internal use.
+     */
+    class LZ4 {
+    public:
+        // Public Methods
+
+        /*
+         * Compress data with the LZ4 block format.
+         * Returns false if the data does not compress.
+         */
+        static bool Compress(const unsigned char *data_, int size_, std::vector<unsigned char> &out_);
+
+        /*
+         * Decompress an LZ4 block into a buffer of exactly the original size
+         */
+        static bool Decompress(const unsigned char *data_, int size_, unsigned char *out_, int outSize_);
+    };
+}
+
+#endif //LZ4_H
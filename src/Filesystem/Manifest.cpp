@@ -0,0 +1,103 @@
+/**********************************************************************************************
+*
+*   Ngine - The 2D game engine.
+*
+*   Copyright (C) 2019 NerdThings
+*
+*   LICENSE: Apache License 2.0
+*   View: https://github.com/NerdThings/Ngine/blob/master/LICENSE
+*
+**********************************************************************************************/
+
+#include "Manifest.h"
+
+#include <sstream>
+
+// Manifest format
+#define MANIFEST_HEADER "NMAN"
+#define MANIFEST_VERSION 2
+
+namespace NerdThings::Ngine::Filesystem {
+    // Type names, indexed by ManifestEntryType
+    static const char *ManifestTypeNames[] = {"font", "music", "sound", "texture"};
+
+    // Public Fields
+
+    const std::string Manifest::FileName = "manifest.nman";
+
+    // Public Constructor(s)
+
+    Manifest::Manifest() {}
+
+    Manifest::Manifest(const Path &path_) {
+        auto file = File(path_);
+        if (!file.Open(MODE_READ)) throw std::runtime_error("Unable to open manifest.");
+
+        auto contents = file.ReadString();
+        file.Close();
+
+        std::istringstream stream(contents);
+        std::string line;
+
+        // Check header, version 1 manifests have no sizes
+        std::getline(stream, line);
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+
+        auto version = 0;
+        for (auto i = 1; i <= MANIFEST_VERSION; i++) {
+            if (line == std::string(MANIFEST_HEADER) + " " + std::to_string(i)) version = i;
+        }
+
+        if (version == 0) throw std::runtime_error("File is not a valid manifest.");
+
+        // Each line is type, name, size and file separated by tabs
+        while (std::getline(stream, line)) {
+            if (!line.empty() && line.back() == '\r') line.pop_back();
+            if (line.empty()) continue;
+
+            std::vector<std::string> fields;
+            std::istringstream lineStream(line);
+            std::string field;
+            while (std::getline(lineStream, field, '\t'))
+                fields.push_back(field);
+
+            if (fields.size() != (version == 1 ? 3 : 4)) throw std::runtime_error("Invalid manifest entry: " + line);
+
+            auto type = -1;
+            for (auto i = 0; i < 4; i++) {
+                if (fields[0] == ManifestTypeNames[i]) type = i;
+            }
+
+            if (type < 0) throw std::runtime_error("Unknown manifest entry type: " + fields[0]);
+            Add((ManifestEntryType)type, fields[1], fields.back(), version == 1 ? 0 : std::stoull(fields[2]));
+        }
+    }
+
+    // Public Methods
+
+    void Manifest::Add(ManifestEntryType type_, const std::string &name_, const std::string &file_, unsigned long long size_) {
+        ManifestEntry entry;
+        entry.File = file_;
+        entry.Name = name_;
+        entry.Size = size_;
+        entry.Type = type_;
+        _Entries.push_back(entry);
+    }
+
+    const std::vector<ManifestEntry> &Manifest::GetEntries() const {
+        return _Entries;
+    }
+
+    bool Manifest::Save(const Path &path_) const {
+        std::ostringstream stream;
+        stream << MANIFEST_HEADER << " " << MANIFEST_VERSION << "\n";
+        for (auto &entry : _Entries)
+            stream << ManifestTypeNames[entry.Type] << "\t" << entry.Name << "\t" << entry.Size << "\t" << entry.File << "\n";
+
+        auto file = File(path_);
+        if (!file.Open(MODE_WRITE, true)) return false;
+        auto success = file.WriteString(stream.str());
+        file.Close();
+        return success;
+    }
+}
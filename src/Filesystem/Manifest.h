@@ -0,0 +1,109 @@
+/**********************************************************************************************
+*
+*   Ngine - The 2D game engine.
+*
+*   Copyright (C) 2019 NerdThings
+*
+*   LICENSE: Apache License 2.0
+*   View: https://github.com/NerdThings/Ngine/blob/master/LICENSE
+*
+**********************************************************************************************/
+
+
+#ifndef MANIFEST_H
+#define MANIFEST_H
+
+#include "../Ngine.h"
+
+#include "Filesystem.h"
+
+namespace NerdThings::Ngine::Filesystem {
+    /*
+     * The type of resource a manifest entry loads as
+     */
+    enum ManifestEntryType {
+        MANIFEST_FONT = 0,
+        MANIFEST_MUSIC,
+        MANIFEST_SOUND,
+        MANIFEST_TEXTURE
+    };
+
+    /*
+     * A resource listed in a manifest
+     */
+    struct ManifestEntry {
+        // Public Fields
+
+        /*
+         * The file, relative to the manifest
+         */
+        std::string File;
+
+        /*
+         * The resource name
+         */
+        std::string Name;
+
+        /*
+         * Size of the file in bytes, 0 if unknown
+         */
+        unsigned long long Size;
+
+        /*
+         * The resource type
+         */
+        ManifestEntryType Type;
+    };
+
+    /*
+     * A list of the resources in a content directory, written when content is cooked.
+     * With a manifest, resources are loaded without walking the directory or guessing types from extensions.
+     */
+    class NEAPI Manifest {
+        // Private Fields
+
+        /*
+         * The entries, in the order they were added
+         */
+        std::vector<ManifestEntry> _Entries;
+    public:
+        // Public Fields
+
+        /*
+         * The name of the manifest file in a content directory
+         */
+        static const std::string FileName;
+
+        // Public Constructor(s)
+
+        /*
+         * Create an empty manifest
+         */
+        Manifest();
+
+        /*
+         * Read a manifest file.
+         * Throws if the file is not a valid manifest.
+         */
+        Manifest(const Path &path_);
+
+        // Public Methods
+
+        /*
+         * Add an entry
+         */
+        void Add(ManifestEntryType type_, const std::string &name_, const std::string &file_, unsigned long long size_ = 0);
+
+        /*
+         * Get all entries
+         */
+        const std::vector<ManifestEntry> &GetEntries() const;
+
+        /*
+         * Write the manifest to a file
+         */
+        bool Save(const Path &path_) const;
+    };
+}
+
+#endif //MANIFEST_H
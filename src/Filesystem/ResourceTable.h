@@ -0,0 +1,461 @@
+/**********************************************************************************************
+*
+*   Ngine - The 2D game engine.
+*
+*   Copyright (C) 2019 NerdThings
+*
+*   LICENSE: Apache License 2.0
+*   View: https://github.com/NerdThings/Ngine/blob/master/LICENSE
+*
+**********************************************************************************************/
+
+#ifndef RESOURCETABLE_H
+#define RESOURCETABLE_H
+
+#include "../Ngine.h"
+
+#include <functional>
+
+namespace NerdThings::Ngine::Filesystem {
+    /*
+     * Typed handle to a named resource.
+     * Resolving a handle is an index, so prefer handles over names in update and draw code.
+     * A handle stays bound to its name for the lifetime of the process.
+     * It resolves to null while nothing is loaded under that name.
+     */
+    template<typename ResourceClass>
+    struct ResourceHandle {
+        // Public Fields
+
+        /*
+         * Slot in the resource table, 0 is the null handle
+         */
+        unsigned int ID = 0;
+
+        // Public Methods
+
+        /*
+         * Whether or not this is the null handle
+         */
+        bool IsNull() const {
+            return ID == 0;
+        }
+
+        // Operators
+
+        bool operator==(const ResourceHandle &b_) const {
+            return ID == b_.ID;
+        }
+
+        bool operator!=(const ResourceHandle &b_) const {
+            return ID != b_.ID;
+        }
+    };
+
+    /*
+     * Owns named resources of one type and gives out handles to them.
+     * Names are looked up once, handles then resolve with an index.
+     * Resources loaded with a loader can be evicted when the table is over its memory budget, they are loaded again on their next access.
+     * Eviction only unloads the resource data, the object is kept and the data is swapped back into it, so pointers to it stay valid.
+     * The resource class must be swappable. Eviction takes unreferenced resources, least recently used first, so take a reference with Acquire to keep one loaded.
+     * Resources that are still in use by the engine, such as playing audio, can be pinned so they are never evicted.
+     * Resources can also be registered with only a loader, they are then loaded on their first access.
+     */
+    template<typename ResourceClass>
+    class ResourceTable {
+        // Private Structs
+
+        /*
+         * A named resource and its bookkeeping
+         */
+        struct Slot {
+            /*
+             * Whether or not the resource was evicted, the object is kept but its data is unloaded
+             */
+            bool Evicted = false;
+
+            /*
+             * Value of the use clock when the resource was last accessed
+             */
+            unsigned long long LastUsed = 0;
+
+            /*
+             * Loads the resource again after eviction, null if it cannot be reloaded
+             */
+            std::function<ResourceClass *()> Loader;
+
+            /*
+             * Whether or not the resource is being loaded outside of the table
+             */
+            bool Loading = false;
+
+            /*
+             * The resource name
+             */
+            std::string Name;
+
+            /*
+             * Number of references taken with Acquire
+             */
+            int References = 0;
+
+            /*
+             * The resource, null if never loaded
+             */
+            std::unique_ptr<ResourceClass> Resource;
+
+            /*
+             * Memory used by the resource in bytes
+             */
+            unsigned long long Size = 0;
+        };
+
+        // Private Fields
+
+        /*
+         * Use clock, ticks on every access
+         */
+        unsigned long long _Clock = 0;
+
+        /*
+         * Slot for each name
+         */
+        std::unordered_map<std::string, unsigned int> _IDs;
+
+        /*
+         * Measures the memory used by a resource
+         */
+        std::function<int(const ResourceClass &)> _Measure;
+
+        /*
+         * Whether or not a resource is in use and must not be evicted
+         */
+        std::function<bool(const ResourceClass &)> _Pinned;
+
+        /*
+         * Resource slots, indexed by handle ID - 1
+         */
+        std::vector<Slot> _Slots;
+
+        /*
+         * Memory used by every loaded resource in bytes
+         */
+        unsigned long long _Usage = 0;
+
+        // Private Methods
+
+        /*
+         * Unload the data of the resource in a slot, keeping the object
+         */
+        void __Evict(Slot &slot_) {
+            slot_.Resource->Unload();
+            slot_.Evicted = true;
+
+            _Usage -= slot_.Size;
+            slot_.Size = 0;
+        }
+
+        /*
+         * Get the slot for a handle, or null
+         */
+        Slot *__GetSlot(ResourceHandle<ResourceClass> handle_) {
+            if (handle_.ID == 0 || handle_.ID > _Slots.size()) return nullptr;
+            return &_Slots[handle_.ID - 1];
+        }
+
+        /*
+         * Load a resource with the slot loader.
+         * Returns null if it fails or the result is invalid.
+         */
+        ResourceClass *__Load(Slot &slot_) {
+            ResourceClass *resource = nullptr;
+            try {
+                resource = slot_.Loader();
+            } catch (std::exception &e) {
+                ConsoleMessage("Failed to load \"" + slot_.Name + "\": " + std::string(e.what()), "WARN", "Resources");
+            }
+
+            if (resource != nullptr && !resource->IsValid()) {
+                delete resource;
+                resource = nullptr;
+            }
+
+            return resource;
+        }
+
+        /*
+         * Store a resource in an empty slot and account for it
+         */
+        void __Store(Slot &slot_, ResourceClass *resource_) {
+            slot_.Resource.reset(resource_);
+            slot_.Size = _Measure != nullptr ? (unsigned long long)_Measure(*resource_) : 0;
+            slot_.LastUsed = ++_Clock;
+            _Usage += slot_.Size;
+        }
+
+        /*
+         * Swap newly loaded data into the existing object in a slot, then delete the old data
+         */
+        void __Swap(Slot &slot_, ResourceClass *resource_) {
+            std::swap(*slot_.Resource, *resource_);
+            resource_->Unload();
+            delete resource_;
+
+            // Account for the new size
+            _Usage -= slot_.Size;
+            slot_.Size = _Measure != nullptr ? (unsigned long long)_Measure(*slot_.Resource) : 0;
+            _Usage += slot_.Size;
+
+            slot_.Evicted = false;
+            slot_.LastUsed = ++_Clock;
+        }
+
+        /*
+         * Unload and delete the resource in a slot
+         */
+        void __Unload(Slot &slot_) {
+            if (slot_.Resource == nullptr) return;
+
+            if (!slot_.Evicted) slot_.Resource->Unload();
+            slot_.Resource = nullptr;
+            slot_.Evicted = false;
+
+            _Usage -= slot_.Size;
+            slot_.Size = 0;
+        }
+    public:
+        // Public Constructor(s)
+
+        /*
+         * Create a table that does not account for memory
+         */
+        ResourceTable() = default;
+
+        /*
+         * Create a table using a function to measure the memory used by each resource
+         */
+        explicit ResourceTable(std::function<int(const ResourceClass &)> measure_)
+                : _Measure(std::move(measure_)) {}
+
+        /*
+         * Create a table that measures the memory used by each resource and never evicts pinned resources
+         */
+        ResourceTable(std::function<int(const ResourceClass &)> measure_, std::function<bool(const ResourceClass &)> pinned_)
+                : _Measure(std::move(measure_)), _Pinned(std::move(pinned_)) {}
+
+        // Public Methods
+
+        /*
+         * Take a reference to a resource, which keeps it loaded
+         */
+        void Acquire(ResourceHandle<ResourceClass> handle_) {
+            auto slot = __GetSlot(handle_);
+            if (slot != nullptr) slot->References++;
+        }
+
+        /*
+         * Store a resource under a name, taking ownership.
+         * If something is already loaded under the name it is kept and the new resource is deleted.
+         * If the resource under the name was evicted, the new resource is swapped into it.
+         * With a loader, the resource may be evicted and is loaded again with it on its next access.
+         */
+        ResourceHandle<ResourceClass> Add(const std::string &name_, ResourceClass *resource_, std::function<ResourceClass *()> loader_ = nullptr) {
+            auto handle = GetHandle(name_);
+            auto &slot = _Slots[handle.ID - 1];
+
+            if (slot.Resource == nullptr) {
+                __Store(slot, resource_);
+                slot.Loader = std::move(loader_);
+            } else if (slot.Evicted) __Swap(slot, resource_);
+            else delete resource_;
+
+            slot.Loading = false;
+
+            return handle;
+        }
+
+        /*
+         * Delete every resource.
+         * Handles keep their names and references.
+         */
+        void Clear() {
+            for (auto &slot : _Slots) {
+                __Unload(slot);
+                slot.Loader = nullptr;
+                slot.Loading = false;
+            }
+        }
+
+        /*
+         * Find the handle for a name without creating one.
+         * Returns the null handle if the name has never been used.
+         */
+        ResourceHandle<ResourceClass> Find(const std::string &name_) const {
+            auto it = _IDs.find(name_);
+            if (it == _IDs.end()) return {};
+            return {it->second};
+        }
+
+        /*
+         * Get the resource for a handle, or null.
+         * An evicted resource is loaded again into the same object first, it is null if that fails.
+         */
+        ResourceClass *Get(ResourceHandle<ResourceClass> handle_) {
+            auto slot = __GetSlot(handle_);
+            if (slot == nullptr) return nullptr;
+
+            // Keep the loader on failure so the next access tries again
+            if ((slot->Resource == nullptr || slot->Evicted) && slot->Loader != nullptr) {
+                auto resource = __Load(*slot);
+                if (resource != nullptr) {
+                    if (slot->Resource == nullptr) __Store(*slot, resource);
+                    else __Swap(*slot, resource);
+                }
+            }
+
+            if (slot->Resource == nullptr || slot->Evicted) return nullptr;
+            slot->LastUsed = ++_Clock;
+            return slot->Resource.get();
+        }
+
+        /*
+         * Get the handle for a name, binding a new one if required.
+         * The handle resolves once something is loaded under the name.
+         */
+        ResourceHandle<ResourceClass> GetHandle(const std::string &name_) {
+            auto it = _IDs.find(name_);
+            if (it != _IDs.end()) return {it->second};
+
+            _Slots.emplace_back();
+            _Slots.back().Name = name_;
+
+            auto id = (unsigned int)_Slots.size();
+            _IDs.insert({name_, id});
+            return {id};
+        }
+
+        /*
+         * Get the memory used by every loaded resource in bytes
+         */
+        unsigned long long GetMemoryUsage() const {
+            return _Usage;
+        }
+
+        /*
+         * Get the name bound to a handle
+         */
+        std::string GetName(ResourceHandle<ResourceClass> handle_) const {
+            if (handle_.ID == 0 || handle_.ID > _Slots.size()) return "";
+            return _Slots[handle_.ID - 1].Name;
+        }
+
+        /*
+         * Whether or not a resource is loaded for a handle
+         */
+        bool IsLoaded(ResourceHandle<ResourceClass> handle_) const {
+            if (handle_.ID == 0 || handle_.ID > _Slots.size()) return false;
+            auto &slot = _Slots[handle_.ID - 1];
+            return slot.Resource != nullptr && !slot.Evicted;
+        }
+
+        /*
+         * Whether or not the resource for a handle was marked as loading with SetLoading
+         */
+        bool IsLoading(ResourceHandle<ResourceClass> handle_) const {
+            if (handle_.ID == 0 || handle_.ID > _Slots.size()) return false;
+            return _Slots[handle_.ID - 1].Loading;
+        }
+
+        /*
+         * Whether or not the resource for a handle was loaded with a loader, so can be reloaded
+         */
+        bool IsReloadable(ResourceHandle<ResourceClass> handle_) const {
+            if (handle_.ID == 0 || handle_.ID > _Slots.size()) return false;
+            return _Slots[handle_.ID - 1].Loader != nullptr;
+        }
+
+        /*
+         * Register a resource under a name without loading it.
+         * It is loaded with the loader on its first access. Nothing changes if the name already has a loader.
+         */
+        ResourceHandle<ResourceClass> Register(const std::string &name_, std::function<ResourceClass *()> loader_) {
+            auto handle = GetHandle(name_);
+            auto &slot = _Slots[handle.ID - 1];
+            if (slot.Loader == nullptr) slot.Loader = std::move(loader_);
+            return handle;
+        }
+
+        /*
+         * Drop a reference taken with Acquire
+         */
+        void Release(ResourceHandle<ResourceClass> handle_) {
+            auto slot = __GetSlot(handle_);
+            if (slot != nullptr && slot->References > 0) slot->References--;
+        }
+
+        /*
+         * Load the resource for a handle again, swapping the new data into the existing object so pointers to it stay valid.
+         * The resource class must be swappable. If the load fails the old resource is kept.
+         */
+        bool Reload(ResourceHandle<ResourceClass> handle_) {
+            auto slot = __GetSlot(handle_);
+            if (slot == nullptr || slot->Loader == nullptr) return false;
+
+            // Evicted resources pick up the new file on their next access
+            if (slot->Resource == nullptr || slot->Evicted) return true;
+
+            auto resource = __Load(*slot);
+            if (resource == nullptr) return false;
+
+            __Swap(*slot, resource);
+            return true;
+        }
+
+        /*
+         * Delete the resource for a handle.
+         * It will not be loaded again.
+         */
+        void Remove(ResourceHandle<ResourceClass> handle_) {
+            auto slot = __GetSlot(handle_);
+            if (slot == nullptr) return;
+
+            __Unload(*slot);
+            slot->Loader = nullptr;
+            slot->Loading = false;
+        }
+
+        /*
+         * Mark the resource for a handle as being loaded outside of the table, such as in the background.
+         * The mark is cleared when a resource is added under the name.
+         */
+        void SetLoading(ResourceHandle<ResourceClass> handle_, bool loading_) {
+            auto slot = __GetSlot(handle_);
+            if (slot != nullptr) slot->Loading = loading_;
+        }
+
+        /*
+         * Evict unreferenced resources, least recently used first, until memory use is within the budget.
+         * Evicted objects are kept so pointers to them stay valid, only their data is unloaded.
+         * A budget of 0 is unlimited. The resource for keep_ and pinned resources are never evicted.
+         */
+        void Trim(unsigned long long budget_, ResourceHandle<ResourceClass> keep_ = {}) {
+            if (budget_ == 0) return;
+
+            while (_Usage > budget_) {
+                Slot *oldest = nullptr;
+                for (unsigned int i = 0; i < _Slots.size(); i++) {
+                    auto &slot = _Slots[i];
+                    if (i + 1 == keep_.ID || slot.Resource == nullptr || slot.Evicted || slot.Loader == nullptr || slot.References > 0) continue;
+                    if (_Pinned != nullptr && _Pinned(*slot.Resource)) continue;
+                    if (oldest == nullptr || slot.LastUsed < oldest->LastUsed) oldest = &slot;
+                }
+
+                // Everything left is in use
+                if (oldest == nullptr) break;
+                __Evict(*oldest);
+            }
+        }
+    };
+}
+
+#endif //RESOURCETABLE_H
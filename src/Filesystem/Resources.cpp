@@ -11,172 +11,713 @@
 
 #include "Resources.h"
 
-#include <regex>
+#include "DirectoryIterator.h"
+
+#include <chrono>
 #include <sstream>
 
+#include "../ThreadPool.h"
+
 namespace NerdThings::Ngine::Filesystem {
     // Private Fields
 
-    std::unordered_map<std::string, std::unique_ptr<Graphics::Font>> Resources::_Fonts;
-    std::unordered_map<std::string, std::unique_ptr<Audio::Music>> Resources::_Music;
-    std::unordered_map<std::string, std::unique_ptr<Audio::Sound>> Resources::_Sounds;
-    std::unordered_map<std::string, std::unique_ptr<Graphics::Texture2D>> Resources::_Textures;
+    std::shared_ptr<Archive> Resources::_Archive;
+    int Resources::_CompletedLoads = 0;
+    const std::vector<std::string> Resources::_FontExtensions = {"ttf", "otf", "nfnt"};
+    ResourceTable<Graphics::Font> Resources::_Fonts([](const Graphics::Font &font_) { return font_.GetDataSize(); });
+    std::vector<ManifestEntry> Resources::_Index;
+    // Audio is pinned while its voice is active, paused or not, as the device and music updates still point at it
+    ResourceTable<Audio::Music> Resources::_Music([](const Audio::Music &music_) { return music_.GetDataSize(); },
+                                                  [](const Audio::Music &music_) { return music_.Stream.Buffer != nullptr && music_.Stream.Buffer->Playing; });
+    const std::vector<std::string> Resources::_MusicExtensions = {"ogg", "flac", "mp3"};//, "xm", "mod"};
+    std::vector<Resources::PendingLoad> Resources::_PendingLoads;
+    int Resources::_QueuedLoads = 0;
+    const std::vector<std::string> Resources::_SoundExtensions = {"wav", "ogg", "flac", "mp3", "nwav"};
+    ResourceTable<Audio::Sound> Resources::_Sounds([](const Audio::Sound &sound_) { return sound_.GetDataSize(); },
+                                                   [](const Audio::Sound &sound_) { return sound_.Stream.Buffer != nullptr && sound_.Stream.Buffer->Playing; });
+    const std::vector<std::string> Resources::_TextureExtensions = {"png", "bmp", "tga", "gif", "pic", "psd", "dds", "ktx", "qoi", "nimg"};
+    ResourceTable<Graphics::Texture2D> Resources::_Textures([](const Graphics::Texture2D &texture_) { return texture_.GetDataSize(); });
+    std::unique_ptr<FileWatcher> Resources::_Watcher;
+
+    // Private Methods
+
+    bool Resources::__AddFont(const std::string &name_, Graphics::Font *font_, const Path &inPath_, int baseSize_) {
+        // The default font is returned when nothing could be loaded, it is not ours to keep
+        if (font_ == nullptr || font_ == Graphics::Font::GetDefaultFont()) return false;
+
+        if (font_->IsValid()) {
+            auto handle = _Fonts.Add(name_, font_, __GetFontLoader(inPath_, baseSize_));
+            _Fonts.Trim(FontMemoryBudget, handle);
+            return true;
+        }
+
+        delete font_;
+        return false;
+    }
+
+    bool Resources::__AddMusic(const std::string &name_, Audio::Music *music_, const Path &inPath_) {
+        if (music_ == nullptr) return false;
+
+        if (music_->IsValid()) {
+            auto handle = _Music.Add(name_, music_, __GetMusicLoader(inPath_));
+            _Music.Trim(MusicMemoryBudget, handle);
+            return true;
+        }
+
+        delete music_;
+        return false;
+    }
+
+    bool Resources::__AddSound(const std::string &name_, Audio::Sound *sound_, const Path &inPath_) {
+        if (sound_ == nullptr) return false;
+
+        if (sound_->IsValid()) {
+            auto handle = _Sounds.Add(name_, sound_, __GetSoundLoader(inPath_));
+            _Sounds.Trim(SoundMemoryBudget, handle);
+            return true;
+        }
+
+        delete sound_;
+        return false;
+    }
+
+    bool Resources::__AddTexture(const std::string &name_, Graphics::Texture2D *texture_, const Path &inPath_, bool generateMipmaps_) {
+        if (texture_ == nullptr) return false;
+
+        if (texture_->IsValid()) {
+            auto handle = _Textures.Add(name_, texture_, __GetTextureLoader(inPath_, generateMipmaps_));
+            _Textures.Trim(TextureMemoryBudget, handle);
+            return true;
+        }
+
+        delete texture_;
+        return false;
+    }
+
+    std::future<std::function<bool()>> Resources::__DecodeFont(const Path &inPath_, const std::string &name_, int baseSize_) {
+        return ThreadPool::Enqueue([inPath_, name_, baseSize_]() -> std::function<bool()> {
+            // Owned until the completion hands it to the table, so nothing leaks if it never runs or throws.
+            // The default font is returned when nothing could be loaded, it is not ours to keep
+            auto fnt = std::make_shared<std::unique_ptr<Graphics::Font>>();
+            auto font = __ReadFont(inPath_, baseSize_);
+            if (font != Graphics::Font::GetDefaultFont()) fnt->reset(font);
+
+            return [fnt, name_, inPath_, baseSize_]() {
+                if (*fnt != nullptr) (*fnt)->UploadAtlas();
+                return __AddFont(name_, fnt->release(), inPath_, baseSize_);
+            };
+        });
+    }
+
+    std::future<std::function<bool()>> Resources::__DecodeMusic(const Path &inPath_, const std::string &name_) {
+        // Buffers only reach the mixer when played, and commands from workers are sent by the game thread, so audio loads entirely on the workers
+        return ThreadPool::Enqueue([inPath_, name_]() -> std::function<bool()> {
+            auto mus = std::make_shared<std::unique_ptr<Audio::Music>>(Audio::Music::LoadMusic(inPath_));
+            return [mus, name_, inPath_]() { return __AddMusic(name_, mus->release(), inPath_); };
+        });
+    }
+
+    std::vector<std::pair<std::string, std::future<std::function<bool()>>>> Resources::__DecodeResources() {
+        std::vector<std::pair<std::string, std::future<std::function<bool()>>>> decodes;
+
+        for (auto &entry : __FindResources()) {
+            auto path = Path(entry.File);
+
+            switch (entry.Type) {
+                case MANIFEST_FONT: decodes.emplace_back(entry.Name, __DecodeFont(path, entry.Name, DefaultFontBaseSize)); break;
+                case MANIFEST_MUSIC: decodes.emplace_back(entry.Name, __DecodeMusic(path, entry.Name)); break;
+                case MANIFEST_SOUND: decodes.emplace_back(entry.Name, __DecodeSound(path, entry.Name)); break;
+                case MANIFEST_TEXTURE: decodes.emplace_back(entry.Name, __DecodeTexture(path, entry.Name)); break;
+            }
+        }
+
+        return decodes;
+    }
+
+    std::future<std::function<bool()>> Resources::__DecodeSound(const Path &inPath_, const std::string &name_) {
+        return ThreadPool::Enqueue([inPath_, name_]() -> std::function<bool()> {
+            auto snd = std::make_shared<std::unique_ptr<Audio::Sound>>(Audio::Sound::LoadSound(inPath_));
+            return [snd, name_, inPath_]() { return __AddSound(name_, snd->release(), inPath_); };
+        });
+    }
+
+    std::future<std::function<bool()>> Resources::__DecodeTexture(const Path &inPath_, const std::string &name_) {
+        // Settings are read here, workers must not touch them
+        auto generateMipmaps = GenerateMipmaps;
+
+        return ThreadPool::Enqueue([inPath_, name_, generateMipmaps]() -> std::function<bool()> {
+            auto img = std::make_shared<Graphics::Image>(inPath_);
+            if (generateMipmaps && !img->IsCompressed() && img->Mipmaps <= 1) img->GenerateMipmaps();
+            return [img, name_, inPath_, generateMipmaps]() {
+                auto tex = new Graphics::Texture2D(img);
+                img->Unload();
+                return __AddTexture(name_, tex, inPath_, generateMipmaps);
+            };
+        });
+    }
+
+    const ManifestEntry *Resources::__FindIndexEntry(ManifestEntryType type_, const std::string &name_) {
+        auto it = std::lower_bound(_Index.begin(), _Index.end(), std::make_pair(type_, name_), [](const ManifestEntry &a_, const std::pair<ManifestEntryType, std::string> &b_) {
+            return a_.Type != b_.first ? a_.Type < b_.first : a_.Name < b_.second;
+        });
+
+        if (it == _Index.end() || it->Type != type_ || it->Name != name_) return nullptr;
+        return &*it;
+    }
+
+    std::vector<ManifestEntry> Resources::__FindResources() {
+        // Get content dir
+        auto contentDir = Directory(Path::GetExecutableDirectory() / ResourcesDirectory);
+
+        std::vector<ManifestEntry> resources;
+        auto archive = __MountArchive();
+
+        // Cooked content lists its resources, so nothing is guessed from extensions
+        auto manifestPath = contentDir.GetObjectPath() / Manifest::FileName;
+        if (File(manifestPath).Exists()) {
+            Manifest manifest(manifestPath);
+
+            for (auto entry : manifest.GetEntries()) {
+                entry.File = (contentDir.GetObjectPath() / entry.File).GetString();
+                entry.Name = __NormalizeName(entry.Name);
+                resources.push_back(entry);
+            }
+
+            return resources;
+        }
+
+        // Add a file under each type its extension loads as
+        auto addFile = [&](const std::string &path_, const std::string &name_, const std::string &ext_, unsigned long long size_) {
+            ManifestEntry entry;
+            entry.File = path_;
+            entry.Name = name_;
+            entry.Size = size_;
+
+            if (std::find(_FontExtensions.begin(), _FontExtensions.end(), ext_) != _FontExtensions.end()) { // Font
+                entry.Type = MANIFEST_FONT;
+                resources.push_back(entry);
+            }
+
+            if (std::find(_MusicExtensions.begin(), _MusicExtensions.end(), ext_) != _MusicExtensions.end()) { // Music
+                entry.Type = MANIFEST_MUSIC;
+                resources.push_back(entry);
+            }
+
+            if (std::find(_SoundExtensions.begin(), _SoundExtensions.end(), ext_) != _SoundExtensions.end()) { // Sound
+                entry.Type = MANIFEST_SOUND;
+                resources.push_back(entry);
+            }
+
+            if (std::find(_TextureExtensions.begin(), _TextureExtensions.end(), ext_) != _TextureExtensions.end()) { // Texture
+                entry.Type = MANIFEST_TEXTURE;
+                resources.push_back(entry);
+            }
+        };
+
+        // Get all files, from the archive if there is one
+        if (archive != nullptr) {
+            for (auto &name : archive->GetEntryNames()) {
+                auto path = contentDir.GetObjectPath() / name;
+
+                // Get name (relative path to the content folder)
+                auto resourceName = __NormalizeName(path.GetRelativeTo(contentDir.GetObjectPath()).GetStringNoExtension());
+                addFile(path.GetString(), resourceName, path.GetFileExtension(), (unsigned long long)archive->GetEntrySize(name));
+            }
+        } else {
+            // Only files of a known type are visited, names are already relative with forward slashes
+            std::vector<std::string> extensions;
+            for (auto exts : {&_FontExtensions, &_MusicExtensions, &_SoundExtensions, &_TextureExtensions})
+                extensions.insert(extensions.end(), exts->begin(), exts->end());
+
+            DirectoryIterator it(contentDir.GetObjectPath(), extensions);
+            while (it.Next())
+                addFile(it.GetPath(), it.GetRelativePathNoExtension(), it.GetExtension(), it.GetSize());
+        }
+
+        return resources;
+    }
+
+    std::function<Graphics::Font *()> Resources::__GetFontLoader(const Path &inPath_, int baseSize_) {
+        return [inPath_, baseSize_]() -> Graphics::Font * {
+            auto fnt = __ReadFont(inPath_, baseSize_);
+            if (fnt == nullptr || fnt == Graphics::Font::GetDefaultFont()) return nullptr;
+            fnt->UploadAtlas();
+            return fnt;
+        };
+    }
+
+    std::function<Audio::Music *()> Resources::__GetMusicLoader(const Path &inPath_) {
+        return [inPath_]() { return Audio::Music::LoadMusic(inPath_); };
+    }
+
+    std::function<Audio::Sound *()> Resources::__GetSoundLoader(const Path &inPath_) {
+        return [inPath_]() { return Audio::Sound::LoadSound(inPath_); };
+    }
+
+    std::function<Graphics::Texture2D *()> Resources::__GetTextureLoader(const Path &inPath_, bool generateMipmaps_) {
+        return [inPath_, generateMipmaps_]() { return __ReadTexture(inPath_, generateMipmaps_); };
+    }
+
+    void Resources::__HotReload() {
+        if (!HotReload) {
+            _Watcher = nullptr;
+            return;
+        }
+
+        // Archived resources cannot change
+        if (_Watcher == nullptr) {
+            if (_Archive != nullptr) return;
+
+            auto contentDir = Directory(Path::GetExecutableDirectory() / ResourcesDirectory);
+            if (!contentDir.Exists()) return;
+
+            try {
+                _Watcher = std::make_unique<FileWatcher>(contentDir);
+            } catch (std::runtime_error &e) {
+                ConsoleMessage("Unable to watch resources: " + std::string(e.what()), "WARN", "Resources");
+                HotReload = false;
+                return;
+            }
+        }
+
+        auto contentPath = _Watcher->GetDirectory().GetObjectPath();
+        std::vector<ResourceLoadedEventArgs> reloaded;
+
+        for (auto &path : _Watcher->Poll()) {
+            auto name = __NormalizeName(path.GetRelativeTo(contentPath).GetStringNoExtension());
+            auto ext = path.GetFileExtension();
+
+            // Only resources that were loaded from a file are reloaded
+            if (std::find(_TextureExtensions.begin(), _TextureExtensions.end(), ext) != _TextureExtensions.end()) {
+                auto handle = _Textures.Find(name);
+                if (_Textures.IsReloadable(handle)) {
+                    reloaded.emplace_back(name, _Textures.Reload(handle));
+                    _Textures.Trim(TextureMemoryBudget, handle);
+                }
+            }
+
+            if (std::find(_SoundExtensions.begin(), _SoundExtensions.end(), ext) != _SoundExtensions.end()) {
+                auto handle = _Sounds.Find(name);
+                if (_Sounds.IsReloadable(handle)) {
+                    reloaded.emplace_back(name, _Sounds.Reload(handle));
+                    _Sounds.Trim(SoundMemoryBudget, handle);
+                }
+            }
+
+            // Code holds on to font glyph indices and playing music streams, so these are not swapped under it
+            if (std::find(_FontExtensions.begin(), _FontExtensions.end(), ext) != _FontExtensions.end() && _Fonts.IsReloadable(_Fonts.Find(name)))
+                ConsoleMessage("Font \"" + name + "\" changed, it is not reloaded while running.", "NOTICE", "Resources");
+
+            if (std::find(_MusicExtensions.begin(), _MusicExtensions.end(), ext) != _MusicExtensions.end() && _Music.IsReloadable(_Music.Find(name)))
+                ConsoleMessage("Music \"" + name + "\" changed, it is not reloaded while running.", "NOTICE", "Resources");
+        }
+
+        for (auto &args : reloaded) {
+            ConsoleMessage((args.Success ? "Reloaded \"" : "Failed to reload \"") + args.Name + "\".", args.Success ? "NOTICE" : "WARN", "Resources");
+            OnResourceReloaded(args);
+        }
+    }
+
+    void Resources::__IndexResources() {
+        for (auto &entry : __FindResources()) {
+            auto path = Path(entry.File);
+
+            // Nothing is read until the first access
+            switch (entry.Type) {
+                case MANIFEST_FONT: _Fonts.Register(entry.Name, __GetFontLoader(path, DefaultFontBaseSize)); break;
+                case MANIFEST_MUSIC: _Music.Register(entry.Name, __GetMusicLoader(path)); break;
+                case MANIFEST_SOUND: _Sounds.Register(entry.Name, __GetSoundLoader(path)); break;
+                case MANIFEST_TEXTURE: _Textures.Register(entry.Name, __GetTextureLoader(path, GenerateMipmaps)); break;
+            }
+
+            _Index.push_back(entry);
+        }
+
+        // Sorted for lookups when loading in the background, indexing again keeps the first entry
+        std::stable_sort(_Index.begin(), _Index.end(), [](const ManifestEntry &a_, const ManifestEntry &b_) {
+            return a_.Type != b_.Type ? a_.Type < b_.Type : a_.Name < b_.Name;
+        });
+
+        _Index.erase(std::unique(_Index.begin(), _Index.end(), [](const ManifestEntry &a_, const ManifestEntry &b_) {
+            return a_.Type == b_.Type && a_.Name == b_.Name;
+        }), _Index.end());
+    }
+
+    std::shared_ptr<Archive> Resources::__MountArchive() {
+        if (_Archive != nullptr) return _Archive;
+
+        // The archive sits next to the content directory
+        auto contentDir = Path::GetExecutableDirectory() / ResourcesDirectory;
+        auto archivePath = Path(contentDir.GetString() + ".npak");
+        if (archivePath.GetResourceType() != TYPE_FILE) return nullptr;
+
+        try {
+            _Archive = std::make_shared<Archive>(archivePath);
+        } catch (std::runtime_error &e) {
+            ConsoleMessage("Unable to open resource archive: " + std::string(e.what()), "WARN", "Resources");
+            return nullptr;
+        }
+
+        // Files in the content directory are now read from the archive
+        Archive::Mount(_Archive, contentDir);
+        ConsoleMessage("Mounted resource archive.", "NOTICE", "Resources");
+        return _Archive;
+    }
+
+    std::string Resources::__NormalizeName(const std::string &name_) {
+        auto name = name_;
+        std::replace(name.begin(), name.end(), '\\', '/');
+        return name;
+    }
+
+    Graphics::Font *Resources::__ReadFont(const Path &inPath_, int baseSize_) {
+        if (inPath_.GetFileExtension() == "nfnt") return Graphics::Font::ReadNativeFont(inPath_);
+        return Graphics::Font::RasterizeTTFFont(inPath_, baseSize_);
+    }
+
+    Graphics::Texture2D *Resources::__ReadTexture(const Path &inPath_, bool generateMipmaps_) {
+        if (!generateMipmaps_) return Graphics::Texture2D::LoadTexture(inPath_);
+
+        // Build the mip chain before upload
+        auto img = std::make_shared<Graphics::Image>(inPath_);
+        if (!img->IsCompressed() && img->Mipmaps <= 1) img->GenerateMipmaps();
+        auto tex = new Graphics::Texture2D(img);
+        img->Unload();
+        return tex;
+    }
+
+    std::shared_future<bool> Resources::__QueueLoad(const std::string &name_, std::future<std::function<bool()>> decode_, std::function<void()> failed_) {
+        PendingLoad load;
+        load.Decode = std::move(decode_);
+        load.Failed = std::move(failed_);
+        load.Name = name_;
+        load.Result = std::make_shared<std::promise<bool>>();
+
+        auto result = load.Result->get_future().share();
+        _PendingLoads.push_back(std::move(load));
+        _QueuedLoads++;
+        return result;
+    }
 
     // Public Fields
 
+    double Resources::AsyncTimeBudget = 4;
     int Resources::DefaultFontBaseSize = 36;
+    unsigned long long Resources::FontMemoryBudget = 0;
+    bool Resources::GenerateMipmaps = false;
+    bool Resources::HotReload = false;
+    bool Resources::LazyLoading = false;
+    unsigned long long Resources::MusicMemoryBudget = 0;
+    Event<> Resources::OnLoadComplete;
+    Event<ResourceLoadedEventArgs> Resources::OnResourceLoaded;
+    Event<ResourceLoadedEventArgs> Resources::OnResourceReloaded;
+    Graphics::Font *Resources::PlaceholderFont = nullptr;
+    Graphics::Texture2D *Resources::PlaceholderTexture = nullptr;
     Path Resources::ResourcesDirectory = Path("content");
+    unsigned long long Resources::SoundMemoryBudget = 0;
+    unsigned long long Resources::TextureMemoryBudget = 0;
 
     // Public Methods
 
+    void Resources::AcquireFont(FontHandle handle_) {
+        _Fonts.Acquire(handle_);
+    }
+
+    void Resources::AcquireMusic(MusicHandle handle_) {
+        _Music.Acquire(handle_);
+    }
+
+    void Resources::AcquireSound(SoundHandle handle_) {
+        _Sounds.Acquire(handle_);
+    }
+
+    void Resources::AcquireTexture(TextureHandle handle_) {
+        _Textures.Acquire(handle_);
+    }
+
     void Resources::DeleteAll() {
-        _Fonts.clear();
-        _Music.clear();
-        _Sounds.clear();
-        _Textures.clear();
+        _Fonts.Clear();
+        _Music.Clear();
+        _Sounds.Clear();
+        _Textures.Clear();
+        _Index.clear();
     }
 
     void Resources::DeleteFont(const std::string &name_) {
-        auto name = std::regex_replace(name_, std::regex("\\\\"), "/");
-        if (_Fonts.find(name) != _Fonts.end()) {
-            _Fonts.erase(name);
-        }
+        _Fonts.Remove(_Fonts.Find(__NormalizeName(name_)));
     }
 
     void Resources::DeleteMusic(const std::string &name_) {
-        auto name = std::regex_replace(name_, std::regex("\\\\"), "/");
-        if (_Music.find(name) != _Music.end()) {
-            _Music.erase(name);
-        }
+        _Music.Remove(_Music.Find(__NormalizeName(name_)));
     }
 
     void Resources::DeleteSound(const std::string &name_) {
-        auto name = std::regex_replace(name_, std::regex("\\\\"), "/");
-        if (_Sounds.find(name) != _Sounds.end()) {
-            _Sounds.erase(name);
-        }
+        _Sounds.Remove(_Sounds.Find(__NormalizeName(name_)));
     }
 
     void Resources::DeleteTexture(const std::string &name_) {
-        auto name = std::regex_replace(name_, std::regex("\\\\"), "/");
-        if (_Textures.find(name) != _Textures.end()) {
-            _Textures.erase(name);
+        _Textures.Remove(_Textures.Find(__NormalizeName(name_)));
+    }
+
+    Graphics::Font *Resources::GetFont(FontHandle handle_) {
+        // Lazily indexed fonts load in the background while the placeholder is returned
+        if (PlaceholderFont != nullptr && !_Fonts.IsLoaded(handle_) && _Fonts.IsReloadable(handle_)) {
+            if (_Fonts.IsLoading(handle_)) return PlaceholderFont;
+
+            auto name = _Fonts.GetName(handle_);
+            auto entry = __FindIndexEntry(MANIFEST_FONT, name);
+            if (entry != nullptr) {
+                // Only a successful add clears the mark, so clear it on failure to try again on the next access
+                _Fonts.SetLoading(handle_, true);
+                __QueueLoad(name, __DecodeFont(Path(entry->File), name, DefaultFontBaseSize), [handle_]() { _Fonts.SetLoading(handle_, false); });
+                return PlaceholderFont;
+            }
         }
+
+        // Accessing may load an evicted font again
+        auto font = _Fonts.Get(handle_);
+        _Fonts.Trim(FontMemoryBudget, handle_);
+        return font;
     }
 
     Graphics::Font *Resources::GetFont(const std::string &name_) {
-        auto name = std::regex_replace(name_, std::regex("\\\\"), "/");
-        if (_Fonts.find(name) != _Fonts.end())
-            return _Fonts[name].get();
-        return nullptr;
+        return GetFont(_Fonts.Find(__NormalizeName(name_)));
+    }
+
+    FontHandle Resources::GetFontHandle(const std::string &name_) {
+        return _Fonts.GetHandle(__NormalizeName(name_));
+    }
+
+    unsigned long long Resources::GetFontMemoryUsage() {
+        return _Fonts.GetMemoryUsage();
+    }
+
+    const std::vector<ManifestEntry> &Resources::GetIndexedResources() {
+        return _Index;
+    }
+
+    Audio::Music *Resources::GetMusic(MusicHandle handle_) {
+        // Accessing may load an evicted music again
+        auto mus = _Music.Get(handle_);
+        _Music.Trim(MusicMemoryBudget, handle_);
+        return mus;
     }
 
     Audio::Music *Resources::GetMusic(const std::string &name_) {
-        auto name = std::regex_replace(name_, std::regex("\\\\"), "/");
-        if (_Music.find(name) != _Music.end())
-            return _Music[name].get();
-        return nullptr;
+        return GetMusic(_Music.Find(__NormalizeName(name_)));
+    }
+
+    MusicHandle Resources::GetMusicHandle(const std::string &name_) {
+        return _Music.GetHandle(__NormalizeName(name_));
+    }
+
+    unsigned long long Resources::GetMusicMemoryUsage() {
+        return _Music.GetMemoryUsage();
+    }
+
+    Audio::Sound *Resources::GetSound(SoundHandle handle_) {
+        // Accessing may load an evicted sound again
+        auto snd = _Sounds.Get(handle_);
+        _Sounds.Trim(SoundMemoryBudget, handle_);
+        return snd;
     }
 
     Audio::Sound *Resources::GetSound(const std::string &name_) {
-        auto name = std::regex_replace(name_, std::regex("\\\\"), "/");
-        if (_Sounds.find(name) != _Sounds.end())
-            return _Sounds[name].get();
-        return nullptr;
+        return GetSound(_Sounds.Find(__NormalizeName(name_)));
     }
 
-    Graphics::Texture2D *Resources::GetTexture(const std::string &name_) {
-        auto name = std::regex_replace(name_, std::regex("\\\\"), "/");
-        if (_Textures.find(name) != _Textures.end())
-            return _Textures[name].get();
-        return nullptr;
+    SoundHandle Resources::GetSoundHandle(const std::string &name_) {
+        return _Sounds.GetHandle(__NormalizeName(name_));
     }
 
-    void Resources::LoadResources() {
-        // Get content dir
-        auto contentDir = Directory(Path::GetExecutableDirectory() / ResourcesDirectory);
+    unsigned long long Resources::GetSoundMemoryUsage() {
+        return _Sounds.GetMemoryUsage();
+    }
 
-        // Get all files
-        auto files = contentDir.GetFilesRecursive();
+    Graphics::Texture2D *Resources::GetTexture(TextureHandle handle_) {
+        // Lazily indexed textures load in the background while the placeholder is returned
+        if (PlaceholderTexture != nullptr && !_Textures.IsLoaded(handle_) && _Textures.IsReloadable(handle_)) {
+            if (_Textures.IsLoading(handle_)) return PlaceholderTexture;
+
+            auto name = _Textures.GetName(handle_);
+            auto entry = __FindIndexEntry(MANIFEST_TEXTURE, name);
+            if (entry != nullptr) {
+                _Textures.SetLoading(handle_, true);
+                __QueueLoad(name, __DecodeTexture(Path(entry->File), name), [handle_]() { _Textures.SetLoading(handle_, false); });
+                return PlaceholderTexture;
+            }
+        }
 
-        // File extension definitions
-        std::vector<std::string> fntExts = {"ttf", "otf"};
-        std::vector<std::string> musExts = {"ogg", "flac", "mp3"};//, "xm", "mod"};
-        std::vector<std::string> sndExts = {"wav", "ogg", "flac", "mp3"};
-        std::vector<std::string> texExts = {"png", "bmp", "tga", "gif", "pic", "psd"};
+        // Accessing may load an evicted texture again
+        auto tex = _Textures.Get(handle_);
+        _Textures.Trim(TextureMemoryBudget, handle_);
+        return tex;
+    }
 
-        // Load all files
-        for (auto file : files) {
-            // Get name (relative path to the content folder)
-            auto name = file.GetObjectPath().GetRelativeTo(contentDir.GetObjectPath()).GetStringNoExtension();
+    Graphics::Texture2D *Resources::GetTexture(const std::string &name_) {
+        return GetTexture(_Textures.Find(__NormalizeName(name_)));
+    }
 
-            // Replace windows slashes with forward slashes
-            name = std::regex_replace(name, std::regex("\\\\"), "/");
+    TextureHandle Resources::GetTextureHandle(const std::string &name_) {
+        return _Textures.GetHandle(__NormalizeName(name_));
+    }
 
-            // Get extension
-            auto ext = file.GetFileExtension();
+    unsigned long long Resources::GetTextureMemoryUsage() {
+        return _Textures.GetMemoryUsage();
+    }
 
-            // Get actual path
-            auto path = file.GetObjectPath();
+    float Resources::GetLoadProgress() {
+        if (_QueuedLoads == 0) return 1;
+        return (float)_CompletedLoads / (float)_QueuedLoads;
+    }
 
-            // Load resources
-            if (std::find(fntExts.begin(), fntExts.end(), ext) != fntExts.end()) { // Font
-                LoadFont(path, name);
-            }
+    bool Resources::IsLoading() {
+        return !_PendingLoads.empty();
+    }
 
-            if (std::find(musExts.begin(), musExts.end(), ext) != musExts.end()) { // Music
-                LoadMusic(path, name);
-            }
+    void Resources::LoadResources() {
+        if (LazyLoading) {
+            __IndexResources();
+            return;
+        }
 
-            if (std::find(sndExts.begin(), sndExts.end(), ext) != sndExts.end()) { // Sound
-                LoadSound(path, name);
+        // Decode everything on the thread pool, then finish each load on this thread in order as it becomes ready.
+        // Keep going after a failure so no decoded data is left behind.
+        std::exception_ptr error = nullptr;
+        for (auto &decode : __DecodeResources()) {
+            try {
+                decode.second.get()();
+            } catch (...) {
+                if (error == nullptr) error = std::current_exception();
             }
+        }
 
-            if (std::find(texExts.begin(), texExts.end(), ext) != texExts.end()) { // Texture
-                LoadTexture(path, name);
-            }
+        if (error != nullptr) std::rethrow_exception(error);
+    }
+
+    void Resources::LoadResourcesAsync() {
+        if (LazyLoading) {
+            __IndexResources();
+            OnLoadComplete();
+            return;
         }
+
+        for (auto &decode : __DecodeResources())
+            __QueueLoad(decode.first, std::move(decode.second));
     }
 
     bool Resources::LoadFont(const Path &inPath_, const std::string &name_, int baseSize_) {
         if (baseSize_ == -1) baseSize_ = DefaultFontBaseSize;
 
-        auto name = std::regex_replace(name_, std::regex("\\\\"), "/");
-        auto fnt = Graphics::Font::LoadTTFFont(inPath_, baseSize_);
-        if (fnt->IsValid()) {
-            _Fonts.insert({ name, std::unique_ptr<Graphics::Font>(fnt) });
-            return true;
-        }
-        return false;
+        auto name = __NormalizeName(name_);
+        auto fnt = __ReadFont(inPath_, baseSize_);
+        if (fnt != nullptr) fnt->UploadAtlas();
+        return __AddFont(name, fnt, inPath_, baseSize_);
+    }
+
+    std::shared_future<bool> Resources::LoadFontAsync(const Path &inPath_, const std::string &name_, int baseSize_) {
+        if (baseSize_ == -1) baseSize_ = DefaultFontBaseSize;
+
+        auto name = __NormalizeName(name_);
+        return __QueueLoad(name, __DecodeFont(inPath_, name, baseSize_));
     }
 
     bool Resources::LoadMusic(const Path &inPath_, const std::string &name_) {
-        auto name = std::regex_replace(name_, std::regex("\\\\"), "/");
-        auto mus = Audio::Music::LoadMusic(inPath_);
-        if (mus->IsValid()) {
-            _Music.insert({ name, std::unique_ptr<Audio::Music>(mus) });
-            return true;
-        }
-        return false;
+        auto name = __NormalizeName(name_);
+        return __AddMusic(name, Audio::Music::LoadMusic(inPath_), inPath_);
+    }
+
+    std::shared_future<bool> Resources::LoadMusicAsync(const Path &inPath_, const std::string &name_) {
+        auto name = __NormalizeName(name_);
+        return __QueueLoad(name, __DecodeMusic(inPath_, name));
     }
 
     bool Resources::LoadSound(const Path &inPath_, const std::string &name_) {
-        auto name = std::regex_replace(name_, std::regex("\\\\"), "/");
-        auto snd = Audio::Sound::LoadSound(inPath_);
-        if (snd->IsValid()) {
-            _Sounds.insert({ name, std::unique_ptr<Audio::Sound>(snd) });
-            return true;
-        }
-        return false;
+        auto name = __NormalizeName(name_);
+        return __AddSound(name, Audio::Sound::LoadSound(inPath_), inPath_);
+    }
+
+    std::shared_future<bool> Resources::LoadSoundAsync(const Path &inPath_, const std::string &name_) {
+        auto name = __NormalizeName(name_);
+        return __QueueLoad(name, __DecodeSound(inPath_, name));
     }
 
     bool Resources::LoadTexture(const Path &inPath_, const std::string &name_) {
-        auto name = std::regex_replace(name_, std::regex("\\\\"), "/");
-        auto tex = Graphics::Texture2D::LoadTexture(inPath_);
-        if (tex->IsValid()) {
-            _Textures.insert({ name, std::unique_ptr<Graphics::Texture2D>(tex) });
-            return true;
+        auto name = __NormalizeName(name_);
+        return __AddTexture(name, __ReadTexture(inPath_, GenerateMipmaps), inPath_, GenerateMipmaps);
+    }
+
+    std::shared_future<bool> Resources::LoadTextureAsync(const Path &inPath_, const std::string &name_) {
+        auto name = __NormalizeName(name_);
+        return __QueueLoad(name, __DecodeTexture(inPath_, name));
+    }
+
+    void Resources::ReleaseFont(FontHandle handle_) {
+        _Fonts.Release(handle_);
+        _Fonts.Trim(FontMemoryBudget);
+    }
+
+    void Resources::ReleaseMusic(MusicHandle handle_) {
+        _Music.Release(handle_);
+        _Music.Trim(MusicMemoryBudget);
+    }
+
+    void Resources::ReleaseSound(SoundHandle handle_) {
+        _Sounds.Release(handle_);
+        _Sounds.Trim(SoundMemoryBudget);
+    }
+
+    void Resources::ReleaseTexture(TextureHandle handle_) {
+        _Textures.Release(handle_);
+        _Textures.Trim(TextureMemoryBudget);
+    }
+
+    void Resources::Update() {
+        __HotReload();
+        if (_PendingLoads.empty()) return;
+
+        auto start = std::chrono::high_resolution_clock::now();
+        std::vector<ResourceLoadedEventArgs> loaded;
+
+        for (auto it = _PendingLoads.begin(); it != _PendingLoads.end();) {
+            // Stop once over budget, but always finish at least one load
+            auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+            if (!loaded.empty() && elapsed >= AsyncTimeBudget) break;
+
+            if (it->Decode.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+                it++;
+                continue;
+            }
+
+            // Upload and store
+            auto success = false;
+            try {
+                success = it->Decode.get()();
+                it->Result->set_value(success);
+            } catch (std::exception &e) {
+                ConsoleMessage("Failed to load resource \"" + it->Name + "\": " + std::string(e.what()), "ERR", "Resources");
+                it->Result->set_exception(std::current_exception());
+            } catch (...) {
+                ConsoleMessage("Failed to load resource \"" + it->Name + "\".", "ERR", "Resources");
+                it->Result->set_exception(std::current_exception());
+            }
+
+            if (!success && it->Failed != nullptr) it->Failed();
+
+            loaded.emplace_back(it->Name, success);
+            it = _PendingLoads.erase(it);
+            _CompletedLoads++;
+        }
+
+        // Handlers are run last so they can queue more loads
+        for (auto &args : loaded)
+            OnResourceLoaded(args);
+
+        // Start counting again for the next batch
+        if (!loaded.empty() && _PendingLoads.empty()) {
+            _QueuedLoads = 0;
+            _CompletedLoads = 0;
+            OnLoadComplete();
         }
-        return false;
     }
 }
@@ -18,35 +18,278 @@
 #include "../Audio/Sound.h"
 #include "../Graphics/Font.h"
 #include "../Graphics/Texture2D.h"
+#include "../EventHandler.h"
+#include "Archive.h"
 #include "Filesystem.h"
+#include "FileWatcher.h"
+#include "Manifest.h"
+#include "ResourceTable.h"
+
+#include <functional>
+#include <future>
 
 namespace NerdThings::Ngine::Filesystem {
+    // Handle Types
+
+    typedef ResourceHandle<Graphics::Font> FontHandle;
+    typedef ResourceHandle<Audio::Music> MusicHandle;
+    typedef ResourceHandle<Audio::Sound> SoundHandle;
+    typedef ResourceHandle<Graphics::Texture2D> TextureHandle;
+
+    /*
+     * Resource loaded event args
+     */
+    struct ResourceLoadedEventArgs : EventArgs {
+        // Public Fields
+
+        /*
+         * The name of the resource
+         */
+        std::string Name;
+
+        /*
+         * Whether or not the resource loaded successfully
+         */
+        bool Success;
+
+        // Public Constructor(s)
+
+        ResourceLoadedEventArgs(std::string name_, bool success_)
+                : Name(std::move(name_)), Success(success_) {}
+    };
+
     /*
-     * Resource management class
+     * Resource management class.
+     * Memory use is tracked per resource type, when a type goes over its budget the least recently used unreferenced resources are evicted.
+     * Evicted resources are loaded again from their file on their next access, into the same object so pointers to them stay valid.
      */
     class NEAPI Resources {
+        // Private Structs
+
+        /*
+         * A resource being loaded in the background
+         */
+        struct PendingLoad {
+            /*
+             * The decode task, which returns the work to finish on the main thread
+             */
+            std::future<std::function<bool()>> Decode;
+
+            /*
+             * Run on the main thread if the load fails, null if there is nothing to undo
+             */
+            std::function<void()> Failed;
+
+            /*
+             * The resource name
+             */
+            std::string Name;
+
+            /*
+             * The result given to the caller
+             */
+            std::shared_ptr<std::promise<bool>> Result;
+        };
+
         // Private Fields
 
-        static std::unordered_map<std::string, std::unique_ptr<Graphics::Font>> _Fonts;
+        /*
+         * The mounted resource archive, if there is one
+         */
+        static std::shared_ptr<Archive> _Archive;
+
+        /*
+         * Number of background loads finished since loading started
+         */
+        static int _CompletedLoads;
+
+        /*
+         * File extensions loaded as fonts
+         */
+        static const std::vector<std::string> _FontExtensions;
+
+        /*
+         * All named fonts
+         */
+        static ResourceTable<Graphics::Font> _Fonts;
+
+        /*
+         * Resources indexed in lazy mode, with full file paths, sorted by type then name
+         */
+        static std::vector<ManifestEntry> _Index;
 
         /*
          * All named music
          */
-        static std::unordered_map<std::string, std::unique_ptr<Audio::Music>> _Music;
+        static ResourceTable<Audio::Music> _Music;
+
+        /*
+         * File extensions loaded as music
+         */
+        static const std::vector<std::string> _MusicExtensions;
+
+        /*
+         * Background loads waiting to be finished, only touched by the main thread
+         */
+        static std::vector<PendingLoad> _PendingLoads;
+
+        /*
+         * Number of background loads queued since loading started
+         */
+        static int _QueuedLoads;
+
+        /*
+         * File extensions loaded as sounds
+         */
+        static const std::vector<std::string> _SoundExtensions;
 
         /*
          * All named sounds
          */
-        static std::unordered_map<std::string, std::unique_ptr<Audio::Sound>> _Sounds;
+        static ResourceTable<Audio::Sound> _Sounds;
+
+        /*
+         * File extensions loaded as textures
+         */
+        static const std::vector<std::string> _TextureExtensions;
 
         /*
          * All named textures
          */
-        static std::unordered_map<std::string, std::unique_ptr<Graphics::Texture2D>> _Textures;
+        static ResourceTable<Graphics::Texture2D> _Textures;
+
+        /*
+         * Watches the resources directory while hot reload is enabled
+         */
+        static std::unique_ptr<FileWatcher> _Watcher;
+
+        // Private Methods
+
+        /*
+         * Store a loaded font, deleting it if it is invalid.
+         * The file is loaded again if the font is evicted.
+         */
+        static bool __AddFont(const std::string &name_, Graphics::Font *font_, const Path &inPath_, int baseSize_);
+
+        /*
+         * Store loaded music, deleting it if it is invalid.
+         * The file is loaded again if the music is evicted.
+         */
+        static bool __AddMusic(const std::string &name_, Audio::Music *music_, const Path &inPath_);
+
+        /*
+         * Store a loaded sound, deleting it if it is invalid.
+         * The file is loaded again if the sound is evicted.
+         */
+        static bool __AddSound(const std::string &name_, Audio::Sound *sound_, const Path &inPath_);
+
+        /*
+         * Store a loaded texture, deleting it if it is invalid.
+         * The file is loaded again if the texture is evicted.
+         */
+        static bool __AddTexture(const std::string &name_, Graphics::Texture2D *texture_, const Path &inPath_, bool generateMipmaps_);
+
+        /*
+         * Start decoding a font on the thread pool
+         */
+        static std::future<std::function<bool()>> __DecodeFont(const Path &inPath_, const std::string &name_, int baseSize_);
+
+        /*
+         * Start decoding music on the thread pool
+         */
+        static std::future<std::function<bool()>> __DecodeMusic(const Path &inPath_, const std::string &name_);
+
+        /*
+         * Start decoding every resource in the resources directory.
+         * Returns each resource name with its decode task.
+         */
+        static std::vector<std::pair<std::string, std::future<std::function<bool()>>>> __DecodeResources();
+
+        /*
+         * Start decoding a sound on the thread pool
+         */
+        static std::future<std::function<bool()>> __DecodeSound(const Path &inPath_, const std::string &name_);
+
+        /*
+         * Start decoding a texture on the thread pool
+         */
+        static std::future<std::function<bool()>> __DecodeTexture(const Path &inPath_, const std::string &name_);
+
+        /*
+         * Find a resource in the lazy mode index, or null
+         */
+        static const ManifestEntry *__FindIndexEntry(ManifestEntryType type_, const std::string &name_);
+
+        /*
+         * List every resource in the resources directory, with full file paths.
+         * Uses the manifest if there is one, otherwise types are found from file extensions.
+         */
+        static std::vector<ManifestEntry> __FindResources();
+
+        /*
+         * Create the function that loads a font file on the main thread
+         */
+        static std::function<Graphics::Font *()> __GetFontLoader(const Path &inPath_, int baseSize_);
+
+        /*
+         * Create the function that loads a music file
+         */
+        static std::function<Audio::Music *()> __GetMusicLoader(const Path &inPath_);
+
+        /*
+         * Create the function that loads a sound file
+         */
+        static std::function<Audio::Sound *()> __GetSoundLoader(const Path &inPath_);
+
+        /*
+         * Create the function that loads a texture file on the main thread
+         */
+        static std::function<Graphics::Texture2D *()> __GetTextureLoader(const Path &inPath_, bool generateMipmaps_);
+
+        /*
+         * Reload resources whose files changed
+         */
+        static void __HotReload();
+
+        /*
+         * Register every resource in the resources directory without loading it
+         */
+        static void __IndexResources();
+
+        /*
+         * Mount the resource archive if there is one and it is not mounted yet
+         */
+        static std::shared_ptr<Archive> __MountArchive();
+
+        /*
+         * Normalize a resource name, using forward slashes
+         */
+        static std::string __NormalizeName(const std::string &name_);
+
+        /*
+         * Read a font file without uploading it, native fonts are read as they are
+         */
+        static Graphics::Font *__ReadFont(const Path &inPath_, int baseSize_);
+
+        /*
+         * Load a texture file on the calling thread, which must be the main thread
+         */
+        static Graphics::Texture2D *__ReadTexture(const Path &inPath_, bool generateMipmaps_);
+
+        /*
+         * Track a background load, running failed_ if it does not succeed
+         */
+        static std::shared_future<bool> __QueueLoad(const std::string &name_, std::future<std::function<bool()>> decode_, std::function<void()> failed_ = nullptr);
     public:
 
         // Public Fields
 
+        /*
+         * Maximum time spent finishing background loads per frame, in milliseconds.
+         * At least one load is finished per frame so that loading makes progress.
+         */
+        static double AsyncTimeBudget;
+
         /*
          * Default base size for loaded fonts.
          * Default: 36
@@ -54,14 +297,113 @@ namespace NerdThings::Ngine::Filesystem {
         static int DefaultFontBaseSize;
 
         /*
-         * The directory to load resources from
+         * Memory allowed for font atlases in bytes before unreferenced fonts are evicted.
+         * Default: 0 (unlimited)
+         */
+        static unsigned long long FontMemoryBudget;
+
+        /*
+         * Whether or not to generate mipmaps for loaded textures.
+         * Default: false
+         */
+        static bool GenerateMipmaps;
+
+        /*
+         * Whether or not to watch the resources directory and reload files that change.
+         * Textures and sounds are reloaded in place, so existing pointers stay valid.
+         * Intended for development, nothing is watched when resources come from an archive.
+         * Default: false
+         */
+        static bool HotReload;
+
+        /*
+         * Whether or not LoadResources only indexes resources instead of loading them.
+         * Each resource is then loaded on its first access, so startup only pays for what is used.
+         * Default: false
+         */
+        static bool LazyLoading;
+
+        /*
+         * Memory allowed for music streams in bytes before unreferenced music is evicted.
+         * Default: 0 (unlimited)
+         */
+        static unsigned long long MusicMemoryBudget;
+
+        /*
+         * Fired on the main thread when every queued background load has finished
+         */
+        static Event<> OnLoadComplete;
+
+        /*
+         * Fired on the main thread as each background load finishes
+         */
+        static Event<ResourceLoadedEventArgs> OnResourceLoaded;
+
+        /*
+         * Fired on the main thread when a resource is reloaded because its file changed
+         */
+        static Event<ResourceLoadedEventArgs> OnResourceReloaded;
+
+        /*
+         * Font returned while a lazily indexed font loads in the background.
+         * If null, lazily indexed fonts load on the calling thread on their first access.
+         * If the load fails the placeholder keeps being returned.
+         */
+        static Graphics::Font *PlaceholderFont;
+
+        /*
+         * Texture returned while a lazily indexed texture loads in the background.
+         * If null, lazily indexed textures load on the calling thread on their first access.
+         * If the load fails the placeholder keeps being returned.
+         */
+        static Graphics::Texture2D *PlaceholderTexture;
+
+        /*
+         * The directory to load resources from.
+         * If a packed archive with the same name and an .npak extension exists, it is used instead.
          */
         static Path ResourcesDirectory;
 
+        /*
+         * Memory allowed for sound PCM data in bytes before unreferenced sounds are evicted.
+         * Default: 0 (unlimited)
+         */
+        static unsigned long long SoundMemoryBudget;
+
+        /*
+         * Memory allowed for texture data in bytes before unreferenced textures are evicted.
+         * Default: 0 (unlimited)
+         */
+        static unsigned long long TextureMemoryBudget;
+
         // TODO: Directory config - provides information on what directories contain what filetypes
 
         // Public Methods
 
+        /*
+         * Take a reference to a font, so it stays loaded.
+         * Pointers stay valid without one, but an evicted font is loaded again on its next use.
+         */
+        static void AcquireFont(FontHandle handle_);
+
+        /*
+         * Take a reference to music, so it stays loaded.
+         * Hold one while the music is playing when a budget is set.
+         */
+        static void AcquireMusic(MusicHandle handle_);
+
+        /*
+         * Take a reference to a sound, so it stays loaded.
+         * Pointers stay valid without one, but an evicted sound is loaded again on its next use.
+         */
+        static void AcquireSound(SoundHandle handle_);
+
+        /*
+         * Take a reference to a texture, so it stays loaded.
+         * Pointers stay valid without one, but an evicted texture is loaded again on its next use.
+         */
+        static void AcquireTexture(TextureHandle handle_);
+
         /*
          * Delete all resources
          */
@@ -87,52 +429,197 @@ namespace NerdThings::Ngine::Filesystem {
          */
         static void DeleteTexture(const std::string &name_);
 
+        /*
+         * Get a font by handle.
+         * A lazily indexed font is loaded on first access, or the placeholder is returned while it loads.
+         */
+        static Graphics::Font *GetFont(FontHandle handle_);
+
         /*
          * Get a named font
          */
         static Graphics::Font *GetFont(const std::string &name_);
 
+        /*
+         * Get the handle for a font name.
+         * The handle can be taken before the font is loaded, it resolves once it is.
+         */
+        static FontHandle GetFontHandle(const std::string &name_);
+
+        /*
+         * Get the memory used by loaded fonts in bytes
+         */
+        static unsigned long long GetFontMemoryUsage();
+
+        /*
+         * Get every resource indexed in lazy mode, with its full file path, type and size
+         */
+        static const std::vector<ManifestEntry> &GetIndexedResources();
+
+        /*
+         * Get music by handle.
+         * Lazily indexed music is loaded on first access.
+         */
+        static Audio::Music *GetMusic(MusicHandle handle_);
+
         /*
          * Get a named music
          */
         static Audio::Music *GetMusic(const std::string &name_);
 
+        /*
+         * Get the handle for a music name.
+         * The handle can be taken before the music is loaded, it resolves once it is.
+         */
+        static MusicHandle GetMusicHandle(const std::string &name_);
+
+        /*
+         * Get the memory used by loaded music in bytes
+         */
+        static unsigned long long GetMusicMemoryUsage();
+
+        /*
+         * Get a sound by handle.
+         * A lazily indexed sound is loaded on first access.
+         */
+        static Audio::Sound *GetSound(SoundHandle handle_);
+
         /*
          * Get a named sound
          */
         static Audio::Sound *GetSound(const std::string &name_);
 
+        /*
+         * Get the handle for a sound name.
+         * The handle can be taken before the sound is loaded, it resolves once it is.
+         */
+        static SoundHandle GetSoundHandle(const std::string &name_);
+
+        /*
+         * Get the memory used by loaded sounds in bytes
+         */
+        static unsigned long long GetSoundMemoryUsage();
+
+        /*
+         * Get a texture by handle.
+         * A lazily indexed texture is loaded on first access, or the placeholder is returned while it loads.
+         */
+        static Graphics::Texture2D *GetTexture(TextureHandle handle_);
+
         /*
          * Get a named texture
          */
         static Graphics::Texture2D *GetTexture(const std::string &name_);
 
+        /*
+         * Get the handle for a texture name.
+         * The handle can be taken before the texture is loaded, it resolves once it is.
+         */
+        static TextureHandle GetTextureHandle(const std::string &name_);
+
+        /*
+         * Get the memory used by loaded textures in bytes
+         */
+        static unsigned long long GetTextureMemoryUsage();
+
+        /*
+         * Get the fraction of queued background loads that have finished.
+         * This is 1 when nothing is loading.
+         */
+        static float GetLoadProgress();
+
+        /*
+         * Whether or not any background loads are unfinished
+         */
+        static bool IsLoading();
+
         /*
          * Loads all files in the resources directory.
-         * All names will be set to their relative path without their extension
+         * All names will be set to their relative path without their extension.
+         * If the directory holds a manifest (see NgineCook), only the resources it lists are loaded.
+         * In lazy mode (see LazyLoading) resources are only indexed, and are loaded on their first access.
+         * Files are decoded on the thread pool, textures are uploaded on the calling thread, which must be the main thread.
+         * If any file fails to load, the first error is thrown once the rest have finished.
          */
         static void LoadResources();
 
+        /*
+         * Load all files in the resources directory in the background.
+         * Resources become available as they finish, see GetLoadProgress and OnLoadComplete.
+         * In lazy mode resources are only indexed, and OnLoadComplete is fired straight away.
+         */
+        static void LoadResourcesAsync();
+
         /*
          * Load font from file.
-         * If base size == -1, default will be used.
+         * If base size == -1, default will be used. Native (nfnt) fonts keep the size they were cooked at.
          */
         static bool LoadFont(const Path &inPath_, const std::string &name_, int baseSize_ = -1);
 
+        /*
+         * Load font from file in the background.
+         * The result is set on the main thread once the font is stored, so it must not be waited on from the main thread.
+         */
+        static std::shared_future<bool> LoadFontAsync(const Path &inPath_, const std::string &name_, int baseSize_ = -1);
+
         /*
          * Load music from file
          */
         static bool LoadMusic(const Path &inPath_, const std::string &name_);
 
+        /*
+         * Load music from file in the background.
+         * The result is set on the main thread once the music is stored, so it must not be waited on from the main thread.
+         */
+        static std::shared_future<bool> LoadMusicAsync(const Path &inPath_, const std::string &name_);
+
         /*
          * Load sound from file
          */
         static bool LoadSound(const Path &inPath_, const std::string &name_);
 
+        /*
+         * Load sound from file in the background.
+         * The result is set on the main thread once the sound is stored, so it must not be waited on from the main thread.
+         */
+        static std::shared_future<bool> LoadSoundAsync(const Path &inPath_, const std::string &name_);
+
         /*
          * Load texture from file
          */
         static bool LoadTexture(const Path &inPath_, const std::string &name_);
+
+        /*
+         * Load texture from file in the background.
+         * The result is set on the main thread once the texture is uploaded, so it must not be waited on from the main thread.
+         */
+        static std::shared_future<bool> LoadTextureAsync(const Path &inPath_, const std::string &name_);
+
+        /*
+         * Drop a reference to a font taken with AcquireFont
+         */
+        static void ReleaseFont(FontHandle handle_);
+
+        /*
+         * Drop a reference to music taken with AcquireMusic
+         */
+        static void ReleaseMusic(MusicHandle handle_);
+
+        /*
+         * Drop a reference to a sound taken with AcquireSound
+         */
+        static void ReleaseSound(SoundHandle handle_);
+
+        /*
+         * Drop a reference to a texture taken with AcquireTexture
+         */
+        static void ReleaseTexture(TextureHandle handle_);
+
+        /*
+         * Finish background loads within the frame budget and apply hot reloads.
+         * Must be called on the main thread, this is called by the game loop every frame.
+         */
+        static void Update();
     };
 }
 
@@ -0,0 +1,356 @@
+/**********************************************************************************************
+*
+*   Ngine - The 2D game engine.
+*
+*   Copyright (C) 2019 NerdThings
+*
+*   LICENSE: Apache License 2.0
+*   View: https://github.com/NerdThings/Ngine/blob/master/LICENSE
+*
+**********************************************************************************************/
+
+
+#include "SaveData.h"
+
+#include "DirectoryIterator.h"
+#include "LZ4.h"
+
+#if defined(_WIN32)
+#include <Windows.h>
+#include <io.h>
+#elif defined(__linux__) || defined(__APPLE__)
+#include <unistd.h>
+#endif
+
+#include <climits>
+#include <cstdio>
+#include <cstring>
+
+// Save format.
+// Header: magic, version, flags, data size, stored size, checksum of the stored data
+#define SAVE_HEADER_SIZE 24
+#define SAVE_VERSION 1
+#define SAVE_FLAG_COMPRESSED 1
+#define SAVE_EXTENSION "nsav"
+
+namespace NerdThings::Ngine::Filesystem {
+    // FNV-1a, to catch saves that were torn or damaged on disk
+    static unsigned int SaveChecksum(const unsigned char *data_, int size_) {
+        unsigned int hash = 2166136261u;
+        for (auto i = 0; i < size_; i++) {
+            hash ^= data_[i];
+            hash *= 16777619u;
+        }
+        return hash;
+    }
+
+    // Private Fields
+
+    std::condition_variable SaveData::_Condition;
+    std::deque<SaveData::SaveJob> SaveData::_Jobs;
+    std::mutex SaveData::_Lock;
+    bool SaveData::_Running = false;
+    bool SaveData::_Writing = false;
+    std::thread SaveData::_Writer;
+
+    // Private Methods
+
+    bool SaveData::__CreateDirectories(const Path &path_) {
+        if (!path_.Valid() || path_.GetResourceType() == TYPE_DIRECTORY) return true;
+        if (!__CreateDirectories(path_.GetParent())) return false;
+        return Directory(path_).Create();
+    }
+
+    Path SaveData::__GetPath(const std::string &name_, const std::string &chunk_) {
+        if (!SaveDirectory.Valid()) throw std::runtime_error("SaveData::SaveDirectory must be set before saving or loading.");
+
+        auto directory = Path::GetAppDataDirectory() / SaveDirectory;
+        if (chunk_.empty()) return directory / (name_ + "." + SAVE_EXTENSION);
+        return directory / name_ / (chunk_ + "." + SAVE_EXTENSION);
+    }
+
+    bool SaveData::__Load(const Path &path_, std::vector<unsigned char> &data_) {
+        // Serve saves that are still queued, so a load always sees the latest save
+        {
+            std::unique_lock<std::mutex> lock(_Lock);
+            for (auto it = _Jobs.rbegin(); it != _Jobs.rend(); it++) {
+                if (it->Target.GetString() == path_.GetString()) {
+                    data_ = it->Data;
+                    return true;
+                }
+            }
+
+            // The save being written is already out of the queue
+            _Condition.wait(lock, []() { return !_Writing; });
+        }
+
+        if (path_.GetResourceType() != TYPE_FILE) return false;
+
+        std::unique_ptr<FileMapping> mapping;
+        try {
+            mapping = std::make_unique<FileMapping>(path_);
+        } catch (std::runtime_error &e) {
+            ConsoleMessage("Unable to read save \"" + path_.GetString() + "\": " + std::string(e.what()), "WARN", "SaveData");
+            return false;
+        }
+
+        // Read header
+        auto data = mapping->GetData();
+        auto size = mapping->GetSize();
+
+        unsigned int header[SAVE_HEADER_SIZE / sizeof(unsigned int)];
+        if (size < SAVE_HEADER_SIZE) return false;
+        memcpy(header, data, SAVE_HEADER_SIZE);
+
+        if (memcmp(header, "NSAV", 4) != 0 || header[1] != SAVE_VERSION || header[4] != (unsigned int)(size - SAVE_HEADER_SIZE)) {
+            ConsoleMessage("Save \"" + path_.GetString() + "\" is not a valid save.", "WARN", "SaveData");
+            return false;
+        }
+
+        auto stored = data + SAVE_HEADER_SIZE;
+        if (SaveChecksum(stored, (int)header[4]) != header[5]) {
+            ConsoleMessage("Save \"" + path_.GetString() + "\" is corrupt.", "WARN", "SaveData");
+            return false;
+        }
+
+        // The checksum does not cover the header, so bound the size before allocating for it
+        auto compressed = (header[2] & SAVE_FLAG_COMPRESSED) != 0;
+        if (compressed ? header[3] > INT_MAX || header[3] > (unsigned long long)header[4] * LZ4_MAX_RATIO : header[3] != header[4]) {
+            ConsoleMessage("Save \"" + path_.GetString() + "\" is corrupt.", "WARN", "SaveData");
+            return false;
+        }
+
+        data_.resize(header[3]);
+        if (compressed) {
+            if (!LZ4::Decompress(stored, (int)header[4], data_.data(), (int)header[3])) {
+                ConsoleMessage("Save \"" + path_.GetString() + "\" is corrupt.", "WARN", "SaveData");
+                return false;
+            }
+        } else if (header[3] > 0) memcpy(data_.data(), stored, header[3]);
+
+        return true;
+    }
+
+    std::shared_future<bool> SaveData::__Queue(const Path &path_, const void *data_, int size_) {
+        if (data_ == nullptr && size_ > 0) throw std::runtime_error("Cannot save null data.");
+
+        auto result = std::make_shared<std::promise<bool>>();
+        auto future = result->get_future().share();
+
+        std::unique_lock<std::mutex> lock(_Lock);
+
+        // Start the save thread on first use
+        if (!_Running) {
+            _Running = true;
+            _Writer = std::thread(__WriterLoop);
+        }
+
+        // Replace the data of a save that has not been written yet
+        auto data = (const unsigned char *)data_;
+        for (auto &job : _Jobs) {
+            if (job.Target.GetString() == path_.GetString()) {
+                job.Data.assign(data, data + size_);
+                job.Results.push_back(result);
+                return future;
+            }
+        }
+
+        SaveJob job;
+        job.Data.assign(data, data + size_);
+        job.Results.push_back(result);
+        job.Target = path_;
+        _Jobs.push_back(std::move(job));
+
+        lock.unlock();
+        _Condition.notify_all();
+        return future;
+    }
+
+    bool SaveData::__Write(const Path &path_, const std::vector<unsigned char> &data_) {
+        if (!__CreateDirectories(path_.GetParent())) {
+            ConsoleMessage("Unable to create save directory for \"" + path_.GetString() + "\".", "ERR", "SaveData");
+            return false;
+        }
+
+        // Compress if it helps
+        auto size = (int)data_.size();
+        std::vector<unsigned char> compressed;
+        auto isCompressed = Compress && size > 0 && LZ4::Compress(data_.data(), size, compressed);
+        auto stored = isCompressed ? compressed.data() : data_.data();
+        auto storedSize = isCompressed ? (int)compressed.size() : size;
+
+        unsigned int header[SAVE_HEADER_SIZE / sizeof(unsigned int)];
+        memcpy(header, "NSAV", 4);
+        header[1] = SAVE_VERSION;
+        header[2] = isCompressed ? SAVE_FLAG_COMPRESSED : 0;
+        header[3] = (unsigned int)size;
+        header[4] = (unsigned int)storedSize;
+        header[5] = SaveChecksum(stored, storedSize);
+
+        // Write everything to a temporary file first
+        auto tempPath = Path(path_.GetString() + ".tmp");
+        auto file = File(tempPath);
+        if (!file.Open(MODE_WRITE, true)) {
+            ConsoleMessage("Unable to write save \"" + path_.GetString() + "\".", "ERR", "SaveData");
+            return false;
+        }
+
+        auto success = file.WriteBytes((unsigned char *)header, SAVE_HEADER_SIZE);
+        if (success && storedSize > 0) success = file.WriteBytes((unsigned char *)stored, storedSize);
+
+        // Make sure the data is on disk before it replaces the old save
+        auto handle = file.GetFileHandle();
+        success = success && fflush(handle) == 0;
+#if defined(_WIN32)
+        success = success && _commit(_fileno(handle)) == 0;
+#elif defined(__linux__) || defined(__APPLE__)
+        success = success && fsync(fileno(handle)) == 0;
+#endif
+        file.Close();
+
+        if (!success) {
+            ConsoleMessage("Unable to write save \"" + path_.GetString() + "\".", "ERR", "SaveData");
+            remove(tempPath.GetString().c_str());
+            return false;
+        }
+
+        // Swap it in
+#if defined(_WIN32)
+        success = MoveFileExA(tempPath.GetString().c_str(), path_.GetString().c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+        success = rename(tempPath.GetString().c_str(), path_.GetString().c_str()) == 0;
+#endif
+
+        if (!success) {
+            ConsoleMessage("Unable to replace save \"" + path_.GetString() + "\".", "ERR", "SaveData");
+            remove(tempPath.GetString().c_str());
+        }
+
+        return success;
+    }
+
+    void SaveData::__WriterLoop() {
+        while (true) {
+            SaveJob job;
+
+            {
+                std::unique_lock<std::mutex> lock(_Lock);
+                _Condition.wait(lock, []() { return !_Running || !_Jobs.empty(); });
+
+                if (!_Running && _Jobs.empty()) return;
+
+                job = std::move(_Jobs.front());
+                _Jobs.pop_front();
+                _Writing = true;
+            }
+
+            auto success = false;
+            try {
+                success = __Write(job.Target, job.Data);
+            } catch (std::exception &e) {
+                ConsoleMessage("Save threw an exception: " + std::string(e.what()), "ERR", "SaveData");
+            }
+
+            for (auto &result : job.Results)
+                result->set_value(success);
+
+            {
+                std::unique_lock<std::mutex> lock(_Lock);
+                _Writing = false;
+            }
+
+            _Condition.notify_all();
+        }
+    }
+
+    // Public Fields
+
+    bool SaveData::Compress = true;
+    Path SaveData::SaveDirectory;
+
+    // Public Methods
+
+    bool SaveData::Delete(const std::string &name_) {
+        // Queued saves would bring it back
+        Flush();
+
+        auto path = __GetPath(name_, "");
+        auto chunks = Directory(path.GetParent() / name_);
+
+        auto success = true;
+        if (path.GetResourceType() == TYPE_FILE) success = File(path).Delete();
+        if (chunks.Exists()) success = chunks.DeleteRecursive() && success;
+        return success;
+    }
+
+    bool SaveData::Exists(const std::string &name_) {
+        auto path = __GetPath(name_, "");
+
+        {
+            std::unique_lock<std::mutex> lock(_Lock);
+            for (auto &job : _Jobs) {
+                if (job.Target.GetString() == path.GetString() || job.Target.GetParent().GetString() == (path.GetParent() / name_).GetString()) return true;
+            }
+        }
+
+        return path.GetResourceType() == TYPE_FILE || Directory(path.GetParent() / name_).Exists();
+    }
+
+    void SaveData::Flush() {
+        std::unique_lock<std::mutex> lock(_Lock);
+        _Condition.wait(lock, []() { return _Jobs.empty() && !_Writing; });
+    }
+
+    std::vector<std::string> SaveData::GetChunks(const std::string &name_) {
+        auto directory = __GetPath(name_, "").GetParent() / name_;
+        std::vector<std::string> chunks;
+
+        // Include chunks that are not written yet
+        {
+            std::unique_lock<std::mutex> lock(_Lock);
+            for (auto &job : _Jobs) {
+                if (job.Target.GetParent().GetString() != directory.GetString()) continue;
+
+                auto fileName = job.Target.GetObjectName();
+                chunks.push_back(fileName.substr(0, fileName.size() - strlen("." SAVE_EXTENSION)));
+            }
+        }
+
+        if (directory.GetResourceType() == TYPE_DIRECTORY) {
+            DirectoryIterator it(directory, {SAVE_EXTENSION});
+            while (it.Next()) {
+                auto chunk = it.GetRelativePathNoExtension();
+                if (std::find(chunks.begin(), chunks.end(), chunk) == chunks.end()) chunks.push_back(chunk);
+            }
+        }
+
+        return chunks;
+    }
+
+    bool SaveData::Load(const std::string &name_, std::vector<unsigned char> &data_) {
+        return __Load(__GetPath(name_, ""), data_);
+    }
+
+    bool SaveData::LoadChunk(const std::string &name_, const std::string &chunk_, std::vector<unsigned char> &data_) {
+        return __Load(__GetPath(name_, chunk_), data_);
+    }
+
+    std::shared_future<bool> SaveData::Save(const std::string &name_, const void *data_, int size_) {
+        return __Queue(__GetPath(name_, ""), data_, size_);
+    }
+
+    std::shared_future<bool> SaveData::SaveChunk(const std::string &name_, const std::string &chunk_, const void *data_, int size_) {
+        return __Queue(__GetPath(name_, chunk_), data_, size_);
+    }
+
+    void SaveData::Shutdown() {
+        {
+            std::unique_lock<std::mutex> lock(_Lock);
+            if (!_Running) return;
+            _Running = false;
+        }
+
+        _Condition.notify_all();
+        _Writer.join();
+    }
+}
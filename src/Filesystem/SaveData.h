@@ -0,0 +1,188 @@
+/**********************************************************************************************
+*
+*   Ngine - The 2D game engine.
+*
+*   Copyright (C) 2019 NerdThings
+*
+*   LICENSE: Apache License 2.0
+*   View: https://github.com/NerdThings/Ngine/blob/master/LICENSE
+*
+**********************************************************************************************/
+
+
+#ifndef SAVEDATA_H
+#define SAVEDATA_H
+
+#include "../Ngine.h"
+
+#include "Filesystem.h"
+
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <mutex>
+
+namespace NerdThings::Ngine::Filesystem {
+    /*
+     * Writes save data in the background.
+     * Data is copied when a save is queued, then compressed and written to a temporary file on the save thread.
+     * The temporary file replaces the save with an atomic rename, so a crash mid-write leaves the previous save intact.
+     * Large saves can be split into chunks that are saved separately, so only changed chunks are written.
+     */
+    class NEAPI SaveData {
+        // Private Structs
+
+        /*
+         * A queued write
+         */
+        struct SaveJob {
+            /*
+             * The data to save
+             */
+            std::vector<unsigned char> Data;
+
+            /*
+             * Results of every save merged into this one
+             */
+            std::vector<std::shared_ptr<std::promise<bool>>> Results;
+
+            /*
+             * The save file
+             */
+            Path Target;
+        };
+
+        // Private Fields
+
+        /*
+         * Signalled when a save is queued, finished or the save thread stops
+         */
+        static std::condition_variable _Condition;
+
+        /*
+         * Queued saves
+         */
+        static std::deque<SaveJob> _Jobs;
+
+        /*
+         * Lock for the save queue
+         */
+        static std::mutex _Lock;
+
+        /*
+         * Whether or not the save thread is running
+         */
+        static bool _Running;
+
+        /*
+         * Whether or not the save thread is writing a job
+         */
+        static bool _Writing;
+
+        /*
+         * The save thread
+         */
+        static std::thread _Writer;
+
+        // Private Methods
+
+        /*
+         * Create a directory and any missing parents
+         */
+        static bool __CreateDirectories(const Path &path_);
+
+        /*
+         * Get the path of a save file
+         */
+        static Path __GetPath(const std::string &name_, const std::string &chunk_);
+
+        /*
+         * Read and verify a save file
+         */
+        static bool __Load(const Path &path_, std::vector<unsigned char> &data_);
+
+        /*
+         * Queue a copy of data to be written to a save file
+         */
+        static std::shared_future<bool> __Queue(const Path &path_, const void *data_, int size_);
+
+        /*
+         * Compress and write a save file, replacing the old one once it is on disk
+         */
+        static bool __Write(const Path &path_, const std::vector<unsigned char> &data_);
+
+        /*
+         * Save thread loop
+         */
+        static void __WriterLoop();
+    public:
+        // Public Fields
+
+        /*
+         * Whether or not to compress saves.
+         * Data that does not compress is stored as is.
+         * Default: true
+         */
+        static bool Compress;
+
+        /*
+         * Directory below the app data directory that saves are kept in, such as the game name.
+         * Must be set before saving or loading.
+         */
+        static Path SaveDirectory;
+
+        // Public Methods
+
+        /*
+         * Delete a save and all of its chunks
+         */
+        static bool Delete(const std::string &name_);
+
+        /*
+         * Whether or not a save exists
+         */
+        static bool Exists(const std::string &name_);
+
+        /*
+         * Wait until every queued save has been written
+         */
+        static void Flush();
+
+        /*
+         * Get the names of the chunks in a save
+         */
+        static std::vector<std::string> GetChunks(const std::string &name_);
+
+        /*
+         * Load a save.
+         * If a save is queued, its data is returned. Returns false if there is no save or it is corrupt.
+         */
+        static bool Load(const std::string &name_, std::vector<unsigned char> &data_);
+
+        /*
+         * Load a chunk of a save.
+         * If the chunk is queued, its data is returned. Returns false if there is no chunk or it is corrupt.
+         */
+        static bool LoadChunk(const std::string &name_, const std::string &chunk_, std::vector<unsigned char> &data_);
+
+        /*
+         * Save data in the background.
+         * The data is copied before this returns. If the same save is queued again before it is written, only the newest data is written.
+         * The result is set on the save thread once the save is on disk.
+         */
+        static std::shared_future<bool> Save(const std::string &name_, const void *data_, int size_);
+
+        /*
+         * Save a chunk of a save in the background, see Save.
+         * Each chunk is replaced atomically on its own, so only changed chunks need to be saved.
+         */
+        static std::shared_future<bool> SaveChunk(const std::string &name_, const std::string &chunk_, const void *data_, int size_);
+
+        /*
+         * Write every queued save and stop the save thread
+         */
+        static void Shutdown();
+    };
+}
+
+#endif //SAVEDATA_H
@@ -13,10 +13,14 @@
 
 #include "Audio/AudioDevice.h"
 #include "Graphics/GraphicsManager.h"
+#include "Graphics/TextureUploadQueue.h"
 #include "Input/Gamepad.h"
 #include "Input/Keyboard.h"
 #include "Input/Mouse.h"
+#include "Filesystem/AsyncIO.h"
 #include "Filesystem/Resources.h"
+#include "Filesystem/SaveData.h"
+#include "ThreadPool.h"
 
 #if defined(GRAPHICS_OPENGL33) || defined(GRAPHICS_OPENGLES2)
 #include "Graphics/OpenGL/OpenGL.h"
@@ -219,6 +223,15 @@ namespace NerdThings::Ngine {
             // If we need to quit, don't render
             if (!_Running) break;
 
+            // Run file read callbacks
+            Filesystem::AsyncIO::Update();
+
+            // Finish asynchronous resource loads
+            Filesystem::Resources::Update();
+
+            // Upload queued textures
+            Graphics::TextureUploadQueue::Process();
+
             // Only render if visible
             if (Window::Visible()) {
                 // Draw
@@ -277,6 +290,14 @@ namespace NerdThings::Ngine {
         // Delete render target now so that it doesnt try after GL is gone.
         _RenderTarget = nullptr;
 
+        // Finish background work before anything it uses is released
+        Filesystem::AsyncIO::Shutdown();
+        Filesystem::SaveData::Shutdown();
+        ThreadPool::Shutdown();
+
+        // Drop pending texture uploads
+        Graphics::TextureUploadQueue::Clear();
+
         // Delete loaded resources
         Filesystem::Resources::DeleteAll();
 
@@ -11,21 +11,41 @@
 
 #include "Font.h"
 
+#include <climits>
 #include <numeric>
 #include <utility>
 #include <stb_truetype.h>
 
 #include "../Rectangle.h"
+#include "../ThreadPool.h"
 #include "../Vector2.h"
+#include "SkylinePacker.h"
+
+// Native font format
+#define NATIVE_FONT_HEADER_SIZE 32
+#define NATIVE_FONT_VERSION 1
+#define NATIVE_FONT_CHAR_SIZE 36
+#define NATIVE_FONT_KERNING_SIZE 8
+#define NATIVE_FONT_PAGE_HEADER_SIZE 16
 
 namespace NerdThings::Ngine::Graphics {
     // Public Fields
 
+    int Font::AtlasPadding = 1;
     Font *Font::DefaultFont;
+    int Font::MaxAtlasSize = 2048;
+    int Font::SDFPadding = 4;
+
+    // Private Fields
+
+    unsigned int Font::_CurrentFrame = 1;
+    std::atomic<unsigned int> Font::_NextGeneration(1);
 
     // Public Constructor(s)
 
-    Font::Font() {}
+    Font::Font() : _Generation(_NextGeneration++) {
+        std::fill(std::begin(_GlyphTable), std::end(_GlyphTable), -1);
+    }
 
     // Destructor
 
@@ -35,30 +55,225 @@ namespace NerdThings::Ngine::Graphics {
 
     // Public Methods
 
+    void Font::AdvanceFrame() {
+        _CurrentFrame++;
+    }
+
+    bool Font::Export(const Filesystem::Path &path_) const {
+        if (IsDynamic() || _AtlasImages.empty()) {
+            ConsoleMessage("Only rasterized fonts that have not been uploaded can be exported.", "ERR", "FONT");
+            return false;
+        }
+
+        if (path_.GetFileExtension() != "nfnt") {
+            ConsoleMessage("Fonts can only be exported as nfnt.", "ERR", "FONT");
+            return false;
+        }
+
+        std::vector<unsigned char> data;
+        auto write = [&data](const void *value_, int size_) {
+            data.insert(data.end(), (const unsigned char *)value_, (const unsigned char *)value_ + size_);
+        };
+
+        // Header
+        unsigned int header[NATIVE_FONT_HEADER_SIZE / sizeof(unsigned int)] = {};
+        memcpy(header, "NFNT", 4);
+        header[1] = NATIVE_FONT_VERSION;
+        header[2] = (unsigned int)BaseSize;
+        header[3] = _SDF ? 1 : 0;
+        header[4] = (unsigned int)CharacterCount;
+        header[5] = (unsigned int)_AtlasImages.size();
+        header[6] = (unsigned int)_KerningPairs.size();
+        write(header, NATIVE_FONT_HEADER_SIZE);
+
+        // Glyph metrics
+        for (auto i = 0; i < CharacterCount; i++) {
+            auto &info = Characters[i];
+            write(&info.Character, 4);
+            write(&info.Rectangle.X, 4);
+            write(&info.Rectangle.Y, 4);
+            write(&info.Rectangle.Width, 4);
+            write(&info.Rectangle.Height, 4);
+            write(&info.OffsetX, 4);
+            write(&info.OffsetY, 4);
+            write(&info.AdvanceX, 4);
+            write(&info.Page, 4);
+        }
+
+        // Kerning
+        for (auto &pair : _KerningPairs) {
+            write(&pair.first, 4);
+            write(&pair.second, 4);
+        }
+
+        // Atlas pages, as they are uploaded
+        for (auto &atlas : _AtlasImages) {
+            unsigned int pageHeader[NATIVE_FONT_PAGE_HEADER_SIZE / sizeof(unsigned int)] = {(unsigned int)atlas->Width, (unsigned int)atlas->Height, (unsigned int)atlas->Format, (unsigned int)atlas->GetDataSize()};
+            write(pageHeader, NATIVE_FONT_PAGE_HEADER_SIZE);
+            write(atlas->PixelData, pageHeader[3]);
+        }
+
+        auto file = Filesystem::File(path_);
+        if (!file.Open(Filesystem::MODE_WRITE, true)) return false;
+        auto success = file.WriteBytes(data.data(), (int)data.size());
+        file.Close();
+        return success;
+    }
+
+    unsigned int Font::GetCacheGeneration() const {
+        return _CacheGeneration;
+    }
+
+    unsigned int Font::GetGeneration() const {
+        return _Generation;
+    }
+
+    int Font::GetDataSize() const {
+        auto dataSize = 0;
+
+        for (auto &page : Pages) dataSize += page->GetDataSize();
+        for (auto &atlas : _AtlasImages) dataSize += atlas->GetDataSize();
+
+        for (auto &page : _CachePages) {
+            dataSize += page.Texture->GetDataSize();
+            dataSize += page.Pixels->GetDataSize();
+        }
+
+        return dataSize;
+    }
+
     Font *Font::GetDefaultFont() {
         return DefaultFont;
     }
 
+    const CharInfo &Font::GetGlyph(int index_) const {
+        if (index_ >= 0 && index_ < CharacterCount) return Characters[index_];
+        if (index_ >= CharacterCount && index_ - CharacterCount < (int)_CachedGlyphs.size())
+            return _CachedGlyphs[index_ - CharacterCount];
+
+        // Missing glyphs measure and draw as nothing
+        static const CharInfo missing = {};
+        return missing;
+    }
+
     int Font::GetGlyphIndex(int char_) const {
-        for (auto i = 0; i < CharacterCount; i++) {
-            if (Characters[i].Character == char_) return i;
+        if (IsDynamic()) {
+            auto cached = _CacheMap.find(char_);
+            auto index = cached != _CacheMap.end() ? cached->second : __CacheGlyph(char_);
+
+            // No room this frame, use the resident fallback
+            if (index < 0) {
+                auto fallback = _CacheMap.find('?');
+                if (fallback != _CacheMap.end()) index = fallback->second;
+                else if (!_CachedGlyphs.empty()) index = CharacterCount;
+                else return -1;
+            }
+
+            MarkGlyphUsed(index);
+            return index;
         }
 
-        // Fail.
-        return -1;
+        if (char_ >= 0 && char_ < 256) {
+            if (_GlyphTable[char_] >= 0) return _GlyphTable[char_];
+        } else {
+            auto glyph = _GlyphMap.find(char_);
+            if (glyph != _GlyphMap.end()) return glyph->second;
+        }
+
+        // Fall back to '?', then the first glyph
+        if (_GlyphTable['?'] >= 0) return _GlyphTable['?'];
+        return CharacterCount > 0 ? 0 : -1;
+    }
+
+    float Font::GetKerning(int leftIndex_, int rightIndex_) const {
+        if (leftIndex_ < 0 || rightIndex_ < 0) return 0;
+
+        // Dynamic glyphs are looked up in the font directly
+        if (IsDynamic() && leftIndex_ >= CharacterCount && rightIndex_ >= CharacterCount) {
+            if (!_FontInfo->kern && !_FontInfo->gpos) return 0;
+
+            auto left = _CacheSlots[leftIndex_ - CharacterCount].FontGlyph;
+            auto right = _CacheSlots[rightIndex_ - CharacterCount].FontGlyph;
+            return (float)stbtt_GetGlyphKernAdvance(_FontInfo.get(), left, right) * _FontScale;
+        }
+
+        if (_KerningPairs.empty()) return 0;
+
+        auto pair = _KerningPairs.find((leftIndex_ << 16) | rightIndex_);
+        return pair != _KerningPairs.end() ? pair->second : 0;
+    }
+
+    int Font::GetNextCodepoint(const std::string &string_, int index_, int &bytes_) {
+        auto length = (int)string_.length() - index_;
+        auto bytes = (const unsigned char *)string_.data() + index_;
+
+        // Assume invalid until decoded
+        bytes_ = 1;
+        if (length <= 0) return 0;
+
+        auto lead = bytes[0];
+        if (lead < 0x80) return lead;
+
+        // Sequence length and lead bits
+        int count, codepoint;
+        if ((lead & 0xE0) == 0xC0) { count = 2; codepoint = lead & 0x1F; }
+        else if ((lead & 0xF0) == 0xE0) { count = 3; codepoint = lead & 0x0F; }
+        else if ((lead & 0xF8) == 0xF0) { count = 4; codepoint = lead & 0x07; }
+        else return '?';
+
+        if (count > length) return '?';
+
+        for (auto i = 1; i < count; i++) {
+            if ((bytes[i] & 0xC0) != 0x80) return '?';
+            codepoint = (codepoint << 6) | (bytes[i] & 0x3F);
+        }
+
+        // Reject overlong encodings, surrogates and out of range values
+        static const int minimum[5] = {0, 0, 0x80, 0x800, 0x10000};
+        if (codepoint < minimum[count] || codepoint > 0x10FFFF || (codepoint >= 0xD800 && codepoint <= 0xDFFF)) return '?';
+
+        bytes_ = count;
+        return codepoint;
     }
 
-    Texture2D *Font::GetTexture() const {
+    Texture2D *Font::GetTexture(int page_) const {
+        if (page_ >= 0 && page_ < (int)Pages.size()) return Pages[page_].get();
+
+        // Glyph cache pages follow the atlas pages
+        auto cachePage = page_ - (int)Pages.size();
+        if (cachePage >= 0 && cachePage < (int)_CachePages.size()) return _CachePages[cachePage].Texture.get();
+
         return Texture.get();
     }
 
+    bool Font::IsDynamic() const {
+        return _CacheCellsPerPage > 0;
+    }
+
+    bool Font::IsSDF() const {
+        return _SDF;
+    }
+
     bool Font::IsValid() const {
-        return Texture->IsValid();
+        return Texture != nullptr && Texture->IsValid();
     }
 
-    Font *Font::LoadTTFFont(const Filesystem::Path &path_, int baseSize_, std::vector<int> fontChars_) {
-        // Check size
+    Font *Font::LoadNativeFont(const Filesystem::Path &path_) {
+        auto font = ReadNativeFont(path_);
+        if (font != nullptr) font->UploadAtlas();
+        return font;
+    }
+
+    Font *Font::LoadTTFFont(const Filesystem::Path &path_, int baseSize_, std::vector<int> fontChars_, bool sdf_) {
+        auto font = RasterizeTTFFont(path_, baseSize_, std::move(fontChars_), sdf_);
+        font->UploadAtlas();
+        return font;
+    }
+
+    Font *Font::LoadTTFFontDynamic(const Filesystem::Path &path_, int baseSize_, int cachePageSize_, int maxCachePages_) {
+        // Check sizes
         if (baseSize_ < 1) throw std::runtime_error("Invalid base size.");
+        if (cachePageSize_ < 1 || maxCachePages_ < 1) throw std::runtime_error("Invalid glyph cache size.");
 
         // Initialize font
         auto font = new Font();
@@ -66,22 +281,19 @@ namespace NerdThings::Ngine::Graphics {
         // Set default info
         font->BaseSize = baseSize_;
 
-        // Load font info
-        font->__LoadFontInfo(path_, std::move(fontChars_));
+        // Load font file, glyphs are added as they are used
+        font->__LoadFontData(path_);
+        font->__InitGlyphCache(cachePageSize_, maxCachePages_);
 
-        if (!font->Characters.empty()) {
-            // Generate font atals
-            font->__GenerateAtlas();
+        return font;
+    }
 
-            // Unload individual character images
-            for (auto i = 0; i < font->CharacterCount; i++) {
-                font->Characters[i].Image->Unload();
-            }
-        } else {
-            font = GetDefaultFont();
-        }
+    void Font::MarkGlyphUsed(int index_) const {
+        auto slot = index_ - CharacterCount;
+        if (slot < 0 || slot >= (int)_CacheSlots.size()) return;
 
-        return font;
+        // Pinned glyphs keep their marker
+        if (_CacheSlots[slot].LastUsed != UINT_MAX) _CacheSlots[slot].LastUsed = _CurrentFrame;
     }
 
     Vector2 Font::MeasureString(const std::string &string_, const float fontSize_, const float spacing_) const {
@@ -96,16 +308,24 @@ namespace NerdThings::Ngine::Graphics {
 
         int letter = 0;                 // Current character
         int index = 0;                  // Index position in sprite font
+        int next = 0;                   // Bytes used by the current character
 
-        for (auto i = 0; i < string_.length(); i++) {
+        for (auto i = 0; i < (int)string_.length(); i += next) {
             lenCounter++;
 
-            letter = string_[i];
+            letter = GetNextCodepoint(string_, i, next);
             index = GetGlyphIndex(letter);
 
             if (letter != '\n') {
-                if (Characters[index].AdvanceX == 0) textWidth += Characters[index].Rectangle.Width + spacing_;
-                else textWidth += Characters[index].AdvanceX;
+                auto &glyph = GetGlyph(index);
+                if (glyph.AdvanceX == 0) textWidth += glyph.Rectangle.Width + spacing_;
+                else textWidth += glyph.AdvanceX;
+
+                // Kerning with the following character
+                if (i + next < (int)string_.length()) {
+                    int nextBytes;
+                    textWidth += GetKerning(index, GetGlyphIndex(GetNextCodepoint(string_, i + next, nextBytes)));
+                }
             } else {
                 if (tempTextWidth < textWidth) tempTextWidth = textWidth;
                 lenCounter = 0;
@@ -125,181 +345,646 @@ namespace NerdThings::Ngine::Graphics {
         return vec;
     }
 
+    void Font::PrepareGlyphs(const std::string &string_) const {
+        if (!IsDynamic()) return;
+
+        for (auto i = 0; i < (int)string_.length();) {
+            int next;
+            GetGlyphIndex(GetNextCodepoint(string_, i, next));
+            i += next;
+        }
+
+        UploadGlyphCache();
+    }
+
+    Font *Font::RasterizeTTFFont(const Filesystem::Path &path_, int baseSize_, std::vector<int> fontChars_, bool sdf_) {
+        // Check size
+        if (baseSize_ < 1) throw std::runtime_error("Invalid base size.");
+
+        // Initialize font, freed if loading throws
+        std::unique_ptr<Font> font(new Font());
+
+        // Set default info
+        font->BaseSize = baseSize_;
+        font->_SDF = sdf_;
+
+        // Load font info
+        font->__LoadFontData(path_);
+        font->__LoadFontInfo(std::move(fontChars_));
+
+        if (!font->Characters.empty()) {
+            // Build lookup tables
+            font->__BuildGlyphTable();
+
+            // Generate font atals
+            font->__GenerateAtlas();
+        }
+
+        // Only dynamic fonts need the font file after loading
+        font->_FontInfo = nullptr;
+        font->_FontData = nullptr;
+
+        if (font->Characters.empty()) return GetDefaultFont();
+        return font.release();
+    }
+
+    Font *Font::ReadNativeFont(const Filesystem::Path &path_) {
+        std::unique_ptr<Filesystem::FileMapping> file;
+        try {
+            file = std::make_unique<Filesystem::FileMapping>(path_);
+        } catch (std::runtime_error &e) {
+            ConsoleMessage("Unable to open font file: " + std::string(e.what()), "ERR", "FONT");
+            return nullptr;
+        }
+
+        auto data = file->GetData();
+        auto size = (unsigned long long)file->GetSize();
+
+        // Read header
+        unsigned int header[NATIVE_FONT_HEADER_SIZE / sizeof(unsigned int)];
+        if (size < NATIVE_FONT_HEADER_SIZE || memcmp(data, "NFNT", 4) != 0) {
+            ConsoleMessage("File is not a valid native font.", "ERR", "FONT");
+            return nullptr;
+        }
+
+        memcpy(header, data, NATIVE_FONT_HEADER_SIZE);
+        if (header[1] != NATIVE_FONT_VERSION) {
+            ConsoleMessage("Native font version " + std::to_string(header[1]) + " is not supported.", "ERR", "FONT");
+            return nullptr;
+        }
+
+        auto characterCount = header[4];
+        auto pageCount = header[5];
+        auto kerningCount = header[6];
+        auto offset = (unsigned long long)NATIVE_FONT_HEADER_SIZE;
+        auto tablesSize = (unsigned long long)characterCount * NATIVE_FONT_CHAR_SIZE + (unsigned long long)kerningCount * NATIVE_FONT_KERNING_SIZE;
+
+        if (header[2] == 0 || characterCount == 0 || pageCount == 0 || offset + tablesSize > size) {
+            ConsoleMessage("Native font header is invalid.", "ERR", "FONT");
+            return nullptr;
+        }
+
+        auto font = new Font();
+        font->BaseSize = (int)header[2];
+        font->_SDF = header[3] != 0;
+        font->CharacterCount = (int)characterCount;
+        font->Characters.resize(characterCount);
+
+        auto read = [&data, &offset](void *value_, int size_) {
+            memcpy(value_, data + offset, size_);
+            offset += size_;
+        };
+
+        // Glyph metrics
+        for (auto &info : font->Characters) {
+            read(&info.Character, 4);
+            read(&info.Rectangle.X, 4);
+            read(&info.Rectangle.Y, 4);
+            read(&info.Rectangle.Width, 4);
+            read(&info.Rectangle.Height, 4);
+            read(&info.OffsetX, 4);
+            read(&info.OffsetY, 4);
+            read(&info.AdvanceX, 4);
+            read(&info.Page, 4);
+        }
+
+        // Kerning
+        for (auto i = 0u; i < kerningCount; i++) {
+            int key;
+            float value;
+            read(&key, 4);
+            read(&value, 4);
+            font->_KerningPairs[key] = value;
+        }
+
+        // Every glyph must be on a page in the file
+        for (auto &info : font->Characters) {
+            if (info.Page < 0 || (unsigned int)info.Page >= pageCount) {
+                ConsoleMessage("Native font glyph is on a page that does not exist.", "ERR", "FONT");
+                font->Unload();
+                delete font;
+                return nullptr;
+            }
+        }
+
+        // Atlas pages
+        for (auto i = 0u; i < pageCount; i++) {
+            unsigned int pageHeader[NATIVE_FONT_PAGE_HEADER_SIZE / sizeof(unsigned int)];
+            if (offset + NATIVE_FONT_PAGE_HEADER_SIZE > size) break;
+            read(pageHeader, NATIVE_FONT_PAGE_HEADER_SIZE);
+
+            // Sizes come from the file, so check them before they are used. No format is over 16 bytes a pixel.
+            auto pixels = (unsigned long long)pageHeader[0] * pageHeader[1];
+            if (pixels == 0 || pixels > INT_MAX / 16 || pageHeader[2] < UNCOMPRESSED_GRAYSCALE || pageHeader[2] > COMPRESSED_ASTC_8x8_RGBA) break;
+
+            auto atlas = std::make_shared<Image>();
+            atlas->Width = (int)pageHeader[0];
+            atlas->Height = (int)pageHeader[1];
+            atlas->Format = (PixelFormat)pageHeader[2];
+            atlas->Mipmaps = 1;
+
+            auto dataSize = atlas->GetDataSize();
+            if (dataSize <= 0 || (unsigned int)dataSize != pageHeader[3] || offset + dataSize > size) break;
+
+            atlas->PixelData = (unsigned char *)malloc(dataSize);
+            read(atlas->PixelData, dataSize);
+            font->_AtlasImages.push_back(atlas);
+        }
+
+        if (font->_AtlasImages.size() != pageCount) {
+            ConsoleMessage("Native font is truncated.", "ERR", "FONT");
+            font->Unload();
+            delete font;
+            return nullptr;
+        }
+
+        font->__BuildGlyphTable();
+        return font;
+    }
+
     void Font::SetDefaultFont(Font *font_) {
         DefaultFont = font_;
     }
 
     void Font::Unload() {
-        // Unload atlas texture.
-        Texture->Unload();
+        // Unload atlas textures.
+        for (auto &page : Pages) page->Unload();
+        Pages.clear();
         Texture = nullptr;
 
+        for (auto &atlas : _AtlasImages) atlas->Unload();
+        _AtlasImages.clear();
+
+        // Unload glyph cache
+        for (auto &page : _CachePages) {
+            page.Texture->Unload();
+            page.Pixels->Unload();
+        }
+
+        _CachePages.clear();
+        _CacheSlots.clear();
+        _CachedGlyphs.clear();
+        _CacheMap.clear();
+        _CacheCellsPerPage = 0;
+        _FontInfo = nullptr;
+        _FontData = nullptr;
+
         // Unset stuff
         BaseSize = 0;
         CharacterCount = 0;
         Characters.clear();
+        std::fill(std::begin(_GlyphTable), std::end(_GlyphTable), -1);
+        _GlyphMap.clear();
+        _KerningPairs.clear();
+    }
+
+    void Font::UploadAtlas() {
+        if (_AtlasImages.empty()) return;
+
+        // Create textures
+        Pages.clear();
+        for (auto &atlas : _AtlasImages) {
+            Pages.push_back(std::make_shared<Texture2D>(atlas));
+            atlas->Unload();
+
+            // Distance fields are interpolated by the shader
+            if (_SDF) Pages.back()->SetTextureFilter(FILTER_BILINEAR);
+        }
+
+        _AtlasImages.clear();
+        Texture = Pages[0];
+    }
+
+    void Font::UploadGlyphCache() const {
+        for (auto &page : _CachePages) {
+            if (page.DirtyEnd <= page.DirtyBegin) continue;
+
+            // Upload the changed band of rows in one go
+            auto stride = page.Pixels->Width * 2;
+            page.Texture->SetPixelData(page.Pixels->PixelData + page.DirtyBegin * stride, page.DirtyBegin, page.DirtyEnd - page.DirtyBegin);
+
+            page.DirtyBegin = 0;
+            page.DirtyEnd = 0;
+        }
     }
 
     // Private Methods
 
+    void Font::__AddCachePage() const {
+        GlyphCachePage page;
+
+        // Start with a transparent page
+        page.Pixels = std::make_shared<Image>();
+        page.Pixels->Width = _CachePageSize;
+        page.Pixels->Height = _CachePageSize;
+        page.Pixels->Format = UNCOMPRESSED_GRAY_ALPHA;
+        page.Pixels->Mipmaps = 1;
+        page.Pixels->PixelData = (unsigned char *)calloc(_CachePageSize * _CachePageSize * 2, 1);
+        page.Texture = std::make_shared<Texture2D>(page.Pixels);
+        _CachePages.push_back(page);
+
+        // Add its cells
+        _CacheSlots.resize(_CacheSlots.size() + _CacheCellsPerPage);
+        _CachedGlyphs.resize(_CachedGlyphs.size() + _CacheCellsPerPage);
+    }
+
+    void Font::__BuildGlyphTable() {
+        std::fill(std::begin(_GlyphTable), std::end(_GlyphTable), -1);
+        _GlyphMap.clear();
+
+        // First glyph wins if a character appears twice
+        for (auto i = 0; i < CharacterCount; i++) {
+            auto character = Characters[i].Character;
+
+            if (character >= 0 && character < 256) {
+                if (_GlyphTable[character] < 0) _GlyphTable[character] = i;
+            } else _GlyphMap.emplace(character, i);
+        }
+    }
+
+    int Font::__CacheGlyph(int char_) const {
+        // Characters missing from the font share the fallback glyph
+        auto fontGlyph = stbtt_FindGlyphIndex(_FontInfo.get(), char_);
+        if (fontGlyph == 0 && char_ != '?') {
+            auto fallback = _CacheMap.find('?');
+            if (fallback == _CacheMap.end()) return -1;
+
+            _CacheMap[char_] = fallback->second;
+            return fallback->second;
+        }
+
+        // Use a free cell, then a new page, then the least recently used cell not used this frame
+        auto slot = -1;
+        for (auto i = 0; i < (int)_CacheSlots.size(); i++) {
+            if (_CacheSlots[i].Character < 0) {
+                slot = i;
+                break;
+            }
+        }
+
+        if (slot < 0 && (int)_CachePages.size() < _CacheMaxPages) {
+            slot = (int)_CacheSlots.size();
+            __AddCachePage();
+        }
+
+        if (slot < 0) {
+            auto oldest = _CurrentFrame;
+            for (auto i = 0; i < (int)_CacheSlots.size(); i++) {
+                if (_CacheSlots[i].LastUsed < oldest) {
+                    oldest = _CacheSlots[i].LastUsed;
+                    slot = i;
+                }
+            }
+
+            if (slot < 0) {
+                ConsoleMessage("Glyph cache is full, every glyph is in use this frame.", "WARN", "FONT");
+                return -1;
+            }
+
+            // Evict, including any missing characters that pointed at it
+            auto evicted = CharacterCount + slot;
+            for (auto it = _CacheMap.begin(); it != _CacheMap.end();) {
+                if (it->second == evicted) it = _CacheMap.erase(it);
+                else it++;
+            }
+
+            _CacheGeneration++;
+        }
+
+        // Find the cell
+        auto padding = std::max(0, AtlasPadding);
+        auto &page = _CachePages[slot / _CacheCellsPerPage];
+        auto cell = slot % _CacheCellsPerPage;
+        auto cellX = padding + (cell % _CacheColumns) * _CacheCellWidth;
+        auto cellY = padding + (cell / _CacheColumns) * _CacheCellHeight;
+        auto cellWidth = _CacheCellWidth - padding;
+        auto cellHeight = _CacheCellHeight - padding;
+        auto pixels = page.Pixels;
+
+        // Clear the cell
+        for (auto y = 0; y < cellHeight; y++)
+            memset(pixels->PixelData + ((cellY + y) * pixels->Width + cellX) * 2, 0, cellWidth * 2);
+
+        // Rasterize into the cell
+        auto &info = _CachedGlyphs[slot];
+        info = CharInfo();
+        info.Character = char_;
+        info.Page = (int)Pages.size() + slot / _CacheCellsPerPage;
+
+        int bitmapWidth = 0, bitmapHeight = 0;
+        auto bitmap = stbtt_GetGlyphBitmap(_FontInfo.get(), _FontScale, _FontScale, fontGlyph, &bitmapWidth, &bitmapHeight, &info.OffsetX, &info.OffsetY);
+
+        // Oversized glyphs are cropped to the cell, the bitmap keeps its own stride
+        auto width = std::min(bitmapWidth, cellWidth);
+        auto height = std::min(bitmapHeight, cellHeight);
+
+        if (bitmap != nullptr) {
+            Image glyph;
+            glyph.PixelData = bitmap;
+            glyph.Width = bitmapWidth;
+            glyph.Height = bitmapHeight;
+            glyph.Format = UNCOMPRESSED_GRAYSCALE;
+            glyph.Mipmaps = 1;
+
+            glyph.GrayscaleToAlpha();
+            pixels->Blit(glyph, 0, 0, width, height, cellX, cellY);
+            glyph.Unload();
+        }
+
+        info.Rectangle = {(float)cellX, (float)cellY, (float)width, (float)height};
+        info.OffsetY += _FontAscent;
+
+        stbtt_GetGlyphHMetrics(_FontInfo.get(), fontGlyph, &info.AdvanceX, nullptr);
+        info.AdvanceX *= _FontScale;
+
+        // Mark the rows for upload
+        if (page.DirtyEnd <= page.DirtyBegin) {
+            page.DirtyBegin = cellY;
+            page.DirtyEnd = cellY + cellHeight;
+        } else {
+            page.DirtyBegin = std::min(page.DirtyBegin, cellY);
+            page.DirtyEnd = std::max(page.DirtyEnd, cellY + cellHeight);
+        }
+
+        _CacheSlots[slot].Character = char_;
+        _CacheSlots[slot].FontGlyph = fontGlyph;
+        _CacheSlots[slot].LastUsed = _CurrentFrame;
+
+        auto index = CharacterCount + slot;
+        _CacheMap[char_] = index;
+        return index;
+    }
+
     // All from raylib.
 
     void Font::__GenerateAtlas() {
-        // Generate atlas texture.
-        auto atlas = std::make_shared<Image>();
-
-        // Undetermined constants
-        int padding = 0;
-
-        // By this point, no validation is required.
-
-        // Load rectangles
-        std::vector<Rectangle> recs(CharacterCount);
-
-        // Calculate image size
-        float requiredArea = 0;
-        for (int i = 0; i < CharacterCount; i++) requiredArea += ((Characters[i].Image->Width + 2*padding)*(Characters[i].Image->Height + 2*padding));
-        float guessSize = sqrtf(requiredArea)*1.3f;
-        int imageSize = (int)powf(2, ceilf(logf((float)guessSize)/logf(2)));  // Calculate next POT
-
-        // Set image parameters
-        atlas->Width = imageSize;
-        atlas->Height = imageSize;
-        atlas->PixelData = new unsigned char[atlas->Width * atlas->Height];
-        atlas->Format = UNCOMPRESSED_GRAYSCALE;
-        atlas->Mipmaps = 1;
-
-        // Default packing method (not adding skyline for now.)
-        int offsetX = padding;
-        int offsetY = padding;
-
-        // NOTE: Using simple packaging, one char after another
-        auto maxH = 0;
-        for (int i = 0; i < CharacterCount; i++)
-        {
-            // Copy pixel data from fc.data to atlas
-            for (int y = 0; y < Characters[i].Image->Height; y++)
-            {
-                for (int x = 0; x < Characters[i].Image->Width; x++)
-                {
-                    ((unsigned char *)atlas->PixelData)[(offsetY + y)*atlas->Width + (offsetX + x)] = ((unsigned char *)Characters[i].Image->PixelData)[y*Characters[i].Image->Width + x];
-                }
+        auto padding = std::max(0, AtlasPadding);
+        auto maxSize = MaxAtlasSize;
+
+        // Next power of two
+        auto nextPOT = [](int value_) {
+            auto pot = 1;
+            while (pot < value_) pot <<= 1;
+            return pot;
+        };
+
+        // Collect glyphs to pack, tallest first to keep the skyline flat
+        std::vector<int> order;
+        long long requiredArea = 0;
+        auto widest = 1;
+
+        for (auto i = 0; i < CharacterCount; i++) {
+            auto width = (int)Characters[i].Rectangle.Width;
+            auto height = (int)Characters[i].Rectangle.Height;
+            Characters[i].Page = 0;
+
+            if (width <= 0 || height <= 0) {
+                Characters[i].Rectangle = {0, 0, 0, 0};
+                continue;
+            }
+
+            if (width + 2 * padding > maxSize || height + 2 * padding > maxSize) {
+                ConsoleMessage("Character " + std::to_string(Characters[i].Character) + " is too large for the atlas and has been skipped.", "WARN", "FONT");
+                Characters[i].Rectangle = {0, 0, 0, 0};
+                continue;
             }
 
-            // Fill chars rectangles in atlas info
-            recs[i].X = (float)offsetX;
-            recs[i].Y = (float)offsetY;
-            recs[i].Width = (float)Characters[i].Image->Width;
-            recs[i].Height = (float)Characters[i].Image->Height;
+            order.push_back(i);
+            requiredArea += (long long)(width + padding) * (height + padding);
+            widest = std::max(widest, width + 2 * padding);
+        }
 
-            if (maxH < recs[i].Height) maxH = recs[i].Height;
+        std::stable_sort(order.begin(), order.end(), [&](int a_, int b_) {
+            auto &rectA = Characters[a_].Rectangle;
+            auto &rectB = Characters[b_].Rectangle;
+            if (rectA.Height != rectB.Height) return rectA.Height > rectB.Height;
+            return rectA.Width > rectB.Width;
+        });
+
+        // Pack into pages of the given width
+        struct Placement {
+            int Character;
+            int Page;
+            int X;
+            int Y;
+        };
+
+        auto pack = [&](int pageWidth_, std::vector<Placement> &placements_, std::vector<int> &pageHeights_) {
+            placements_.clear();
+            pageHeights_.clear();
+
+            // Glyphs carry padding on their right and bottom, the area is inset for the left and top
+            SkylinePacker packer(pageWidth_ - padding, maxSize - padding);
+
+            for (auto character : order) {
+                auto width = (int)Characters[character].Rectangle.Width + padding;
+                auto height = (int)Characters[character].Rectangle.Height + padding;
+                int x, y;
+
+                if (!packer.Pack(width, height, x, y)) {
+                    // Page is full, start another
+                    pageHeights_.push_back(packer.GetUsedHeight() + padding);
+                    packer.Reset();
+                    packer.Pack(width, height, x, y);
+                }
 
-            // Save rectangle
-            Characters[i].Rectangle = recs[i];
+                placements_.push_back({character, (int)pageHeights_.size(), x + padding, y + padding});
+            }
+
+            pageHeights_.push_back(packer.GetUsedHeight() + padding);
+        };
 
-            // Move atlas position X for next character drawing
-            offsetX += (Characters[i].Image->Width + 2*padding);
+        // Try widths around the square estimate, keeping the fewest pages then the smallest area
+        auto estimate = std::min(maxSize, std::max(nextPOT(widest), nextPOT((int)ceil(sqrt((double)requiredArea)))));
+        auto bestWidth = 0;
+        auto bestPages = 0;
+        long long bestArea = 0;
+        std::vector<Placement> placements;
+        std::vector<int> pageHeights;
 
-            if (offsetX >= (atlas->Width - Characters[i].Image->Width - padding))
-            {
-                offsetX = padding;
+        for (auto width : {estimate / 2, estimate, estimate * 2}) {
+            if (width < widest || width > maxSize) continue;
 
-                // NOTE: Be careful on offsetY for SDF fonts, by default SDF
-                // use an internal padding of 4 pixels, it means char rectangle
-                // height is bigger than fontSize, it could be up to (fontSize + 8)
-                offsetY += (maxH + 2*padding);
+            pack(width, placements, pageHeights);
 
-                maxH = 0;
+            long long area = 0;
+            for (auto height : pageHeights) area += (long long)width * nextPOT(height);
 
-                if (offsetY > (atlas->Height - BaseSize - padding)) break;
+            auto pages = (int)pageHeights.size();
+            if (bestWidth == 0 || pages < bestPages || (pages == bestPages && area < bestArea)) {
+                bestWidth = width;
+                bestPages = pages;
+                bestArea = area;
             }
         }
 
-        // Convert to gray alpha
-        unsigned char *dataGrayAlpha = new unsigned char[atlas->Width * atlas->Height * 2];
+        pack(bestWidth, placements, pageHeights);
+
+        // Build each page
+        std::vector<std::shared_ptr<Image>> atlases;
+        for (auto height : pageHeights) {
+            auto atlas = std::make_shared<Image>();
+            atlas->Width = bestWidth;
+            atlas->Height = nextPOT(height);
+            atlas->PixelData = (unsigned char *)calloc(atlas->Width * atlas->Height, 1);
+            atlas->Format = UNCOMPRESSED_GRAYSCALE;
+            atlas->Mipmaps = 1;
+            atlases.push_back(atlas);
+        }
+
+        for (const auto &placement : placements) {
+            auto &character = Characters[placement.Character];
 
-        for (auto i = 0, k = 0; i < atlas->Width * atlas->Height; i++, k += 2) {
-            dataGrayAlpha[k] = 255;
-            dataGrayAlpha[k + 1] = atlas->PixelData[i];
+            // Save rectangle
+            character.Rectangle.X = (float)placement.X;
+            character.Rectangle.Y = (float)placement.Y;
+            character.Page = placement.Page;
         }
 
-        // Complete atlas
-        delete atlas->PixelData;
-        atlas->PixelData = dataGrayAlpha;
-        atlas->Format = UNCOMPRESSED_GRAY_ALPHA;
+        // Rasterize glyphs in place, each one owns its own area of the atlas
+        ThreadPool::ParallelFor(0, (int)placements.size(), [&](int begin_, int end_) {
+            for (auto i = begin_; i < end_; i++) {
+                const auto &placement = placements[i];
+                auto &atlas = *atlases[placement.Page];
+                __RasterizeGlyph(placement.Character, atlas.PixelData + placement.Y * atlas.Width + placement.X, atlas.Width);
+            }
+        }, 8);
 
-        // Create texture
-        Texture = std::make_shared<Texture2D>(atlas);
+        // Convert to white gray alpha, using coverage as alpha
+        for (auto &atlas : atlases) atlas->GrayscaleToAlpha();
 
-        // Delete atlas
-        atlas->Unload();
+        _AtlasImages = std::move(atlases);
     }
 
-    void Font::__LoadFontInfo(const Filesystem::Path &path_, std::vector<int> chars_) {
-        // Characters
-        std::vector<CharInfo> characters;
+    void Font::__InitGlyphCache(int pageSize_, int maxPages_) {
+        auto padding = std::max(0, AtlasPadding);
 
-        // TODO: Support for bitmap fonts something to consider?
+        // Size cells to fit any glyph in the font
+        int x0, y0, x1, y1;
+        stbtt_GetFontBoundingBox(_FontInfo.get(), &x0, &y0, &x1, &y1);
+        _CacheCellWidth = (int)ceilf((float)(x1 - x0) * _FontScale) + 1 + padding;
+        _CacheCellHeight = (int)ceilf((float)(y1 - y0) * _FontScale) + 1 + padding;
 
-        // Load font file
-        auto fontFile = Filesystem::File(path_);
-        if (fontFile.Open(Filesystem::MODE_READ, true)) {
-            // Get font data
-            auto size = fontFile.GetSize();
+        _CachePageSize = pageSize_;
+        _CacheMaxPages = maxPages_;
+        _CacheColumns = (pageSize_ - padding) / _CacheCellWidth;
+        _CacheCellsPerPage = _CacheColumns * ((pageSize_ - padding) / _CacheCellHeight);
 
-            auto fontData = fontFile.ReadBytes();
-            fontFile.Close();
+        if (_CacheCellsPerPage <= 0) throw std::runtime_error("Glyph cache page is too small for the font size.");
 
-            // Get ready to read data
-            stbtt_fontinfo fontInfo;
-            if (!stbtt_InitFont(&fontInfo, fontData, 0)) throw std::runtime_error("Failed to init font.");
+        __AddCachePage();
+        Texture = _CachePages[0].Texture;
 
-            //Get font scale factor
-            auto scaleFactor = stbtt_ScaleForPixelHeight(&fontInfo, (float)BaseSize);
+        // Keep the fallback glyph resident
+        auto fallback = __CacheGlyph('?');
+        if (fallback >= 0) _CacheSlots[fallback - CharacterCount].LastUsed = UINT_MAX;
+        UploadGlyphCache();
+    }
 
-            // Calculate metrics
-            int ascent, descent, lineGap;
-            stbtt_GetFontVMetrics(&fontInfo, &ascent, &descent, &lineGap);
+    void Font::__LoadFontData(const Filesystem::Path &path_) {
+        // TODO: Support for bitmap fonts something to consider?
 
-            // Verify character count
-            CharacterCount = (CharacterCount > 0) ? CharacterCount : 95;
+        // Map font file, only the tables stb_truetype touches are read from disk
+        _FontData = std::make_unique<Filesystem::FileMapping>(path_);
 
-            // Set characters if empty
-            if (chars_.empty()) {
-                // Set size
-                chars_.resize(CharacterCount);
+        // Get ready to read data
+        _FontInfo = std::make_shared<stbtt_fontinfo>();
+        if (!stbtt_InitFont(_FontInfo.get(), _FontData->GetData(), 0)) throw std::runtime_error("Failed to init font.");
 
-                // Fill
-                std::iota(chars_.begin(), chars_.end(), 32); //32 = space
-            }
+        //Get font scale factor
+        _FontScale = stbtt_ScaleForPixelHeight(_FontInfo.get(), (float)BaseSize);
 
-            // Reserve space for character info
-            Characters.resize(CharacterCount);
+        // Calculate metrics
+        int ascent, descent, lineGap;
+        stbtt_GetFontVMetrics(_FontInfo.get(), &ascent, &descent, &lineGap);
+        _FontAscent = (int)((float)ascent*_FontScale);
+    }
 
-            // Fetch character data
-            for (auto i = 0; i < CharacterCount; i++) {
-                int chw = 0, chh = 0; // Character w and h.
-                int ch = chars_[i]; // Character value
-                Characters[i].Character = ch;
+    void Font::__LoadFontInfo(std::vector<int> chars_) {
+        auto &fontInfo = *_FontInfo;
+        auto scaleFactor = _FontScale;
 
-                // Get image data
-                auto pixels = stbtt_GetCodepointBitmap(&fontInfo, scaleFactor, scaleFactor, ch, &chw, &chh, &Characters[i].OffsetX, &Characters[i].OffsetY);
+        // Set characters if empty
+        if (chars_.empty()) {
+            // Set size
+            chars_.resize(95);
 
-                // Load image
-                Characters[i].Image = std::make_shared<Image>(pixels, chw, chh, UNCOMPRESSED_GRAYSCALE);
+            // Fill
+            std::iota(chars_.begin(), chars_.end(), 32); //32 = space
+        }
 
-                // Set offset
-                Characters[i].OffsetY += (int)((float)ascent*scaleFactor);
+        // Reserve space for character info
+        CharacterCount = (int)chars_.size();
+        Characters.resize(CharacterCount);
 
-                // Get advance
-                stbtt_GetCodepointHMetrics(&fontInfo, ch, &Characters[i].AdvanceX, nullptr);
-                Characters[i].AdvanceX *= scaleFactor;
+        // Fetch character metrics, glyphs are rasterized straight into the atlas later
+        for (auto i = 0; i < CharacterCount; i++) {
+            int ch = chars_[i]; // Character value
+            Characters[i].Character = ch;
+
+            auto glyph = stbtt_FindGlyphIndex(&fontInfo, ch);
+
+            // Get bitmap bounds
+            int x0, y0, x1, y1;
+            stbtt_GetGlyphBitmapBox(&fontInfo, glyph, scaleFactor, scaleFactor, &x0, &y0, &x1, &y1);
+
+            // Distance fields extend past the outline, matching stbtt_GetGlyphSDF
+            if (_SDF && x1 > x0 && y1 > y0) {
+                auto padding = std::max(1, SDFPadding);
+                x0 -= padding;
+                y0 -= padding;
+                x1 += padding;
+                y1 += padding;
             }
 
-            // Delete font data
-            delete fontData;
-        } else {
-            throw std::runtime_error("Unable to open font file.");
+            Characters[i].Rectangle = {0, 0, (float)(x1 - x0), (float)(y1 - y0)};
+            Characters[i].OffsetX = x0;
+            Characters[i].OffsetY = y0 + _FontAscent;
+
+            // Get advance
+            stbtt_GetGlyphHMetrics(&fontInfo, glyph, &Characters[i].AdvanceX, nullptr);
+            Characters[i].AdvanceX *= scaleFactor;
+        }
+
+        // Precompute kerning pairs.
+        // Large character sets only pair the Latin-1 range to keep this bounded.
+        _KerningPairs.clear();
+        if (fontInfo.kern || fontInfo.gpos) {
+            std::vector<std::pair<int, int>> glyphs;
+            for (auto i = 0; i < CharacterCount && i < 0x10000; i++) {
+                if (CharacterCount <= 256 || Characters[i].Character < 256)
+                    glyphs.emplace_back(i, stbtt_FindGlyphIndex(&fontInfo, Characters[i].Character));
+            }
+
+            for (const auto &left : glyphs) {
+                for (const auto &right : glyphs) {
+                    auto kern = stbtt_GetGlyphKernAdvance(&fontInfo, left.second, right.second);
+                    if (kern != 0) _KerningPairs[(left.first << 16) | right.first] = (float)kern * scaleFactor;
+                }
+            }
         }
     }
+
+    void Font::__RasterizeGlyph(int index_, unsigned char *pixels_, int stride_) const {
+        auto &character = Characters[index_];
+        auto width = (int)character.Rectangle.Width;
+        auto height = (int)character.Rectangle.Height;
+        if (width <= 0 || height <= 0) return;
+
+        auto glyph = stbtt_FindGlyphIndex(_FontInfo.get(), character.Character);
+
+        if (_SDF) {
+            // Distance fields put the glyph edge at 128 and fall off to 0 over SDFPadding pixels.
+            // There is no in-place variant, so copy the rows over.
+            auto padding = std::max(1, SDFPadding);
+            int sdfWidth, sdfHeight, offsetX, offsetY;
+            auto sdf = stbtt_GetGlyphSDF(_FontInfo.get(), _FontScale, glyph, padding, 128, 128.0f / (float)padding, &sdfWidth, &sdfHeight, &offsetX, &offsetY);
+            if (sdf == nullptr) return;
+
+            for (auto y = 0; y < std::min(height, sdfHeight); y++)
+                memcpy(pixels_ + y * stride_, sdf + y * sdfWidth, std::min(width, sdfWidth));
+
+            stbtt_FreeSDF(sdf, nullptr);
+        } else stbtt_MakeGlyphBitmap(_FontInfo.get(), pixels_, width, height, stride_, _FontScale, _FontScale, glyph);
+    }
 }
@@ -14,6 +14,9 @@
 
 #include "../Ngine.h"
 
+#include <atomic>
+#include <unordered_map>
+
 #include "../Filesystem/Filesystem.h"
 #include "../Rectangle.h"
 #include "../Resource.h"
@@ -21,6 +24,9 @@
 #include "Image.h"
 #include "Texture2D.h"
 
+// Forward declare, stb_truetype is private to the engine
+struct stbtt_fontinfo;
+
 namespace NerdThings::Ngine::Graphics {
     /*
      * Character information
@@ -54,9 +60,9 @@ namespace NerdThings::Ngine::Graphics {
         int AdvanceX;
 
         /*
-         * Greyscale pixel data
+         * The atlas page containing the character
          */
-        std::shared_ptr<Graphics::Image> Image;
+        int Page;
 
         // Public Constructor
 
@@ -64,7 +70,8 @@ namespace NerdThings::Ngine::Graphics {
             : Character(0),
               OffsetX(0),
               OffsetY(0),
-              AdvanceX(0) {}
+              AdvanceX(0),
+              Page(0) {}
     };
 
     /*
@@ -73,16 +80,37 @@ namespace NerdThings::Ngine::Graphics {
     struct NEAPI Font : public IResource {
         // Public Fields
 
+        /*
+         * Padding around each glyph in newly generated atlases
+         */
+        static int AtlasPadding;
+
         /*
          * The default font
          */
         static Font *DefaultFont;
 
         /*
-         * Font texture
+         * Maximum width and height of an atlas page.
+         * Characters that do not fit on one page continue on another.
+         */
+        static int MaxAtlasSize;
+
+        /*
+         * Distance range in pixels around each glyph in newly loaded signed distance field fonts
+         */
+        static int SDFPadding;
+
+        /*
+         * Font texture (the first atlas page)
          */
         std::shared_ptr<Texture2D> Texture;
 
+        /*
+         * All atlas pages
+         */
+        std::vector<std::shared_ptr<Texture2D>> Pages;
+
         /*
          * Base size (default char height)
          */
@@ -94,7 +122,8 @@ namespace NerdThings::Ngine::Graphics {
         int CharacterCount = 0;
 
         /*
-         * Character data
+         * Character data.
+         * Glyphs held by a dynamic font's glyph cache are not included, see GetGlyph.
          */
         std::vector<CharInfo> Characters;
 
@@ -105,26 +134,93 @@ namespace NerdThings::Ngine::Graphics {
          */
         Font();
 
+        Font(const Font &) = delete;
+
+        /*
+         * Take the data of another font, including its generation
+         */
+        Font(Font &&font_) = default;
+
         // Destructor
 
         virtual ~Font();
 
         // Public Methods
 
+        /*
+         * Mark the start of a new frame for glyph cache eviction.
+         * Intended for internal use. Called by Renderer::BeginDrawing.
+         */
+        static void AdvanceFrame();
+
+        /*
+         * Export the font as a native (nfnt) file, holding the atlas pages, glyph metrics and kerning.
+         * Only fonts rasterized with RasterizeTTFFont that have not been uploaded yet can be exported.
+         */
+        bool Export(const Filesystem::Path &path_) const;
+
+        /*
+         * Get the glyph cache generation.
+         * This changes whenever a cached glyph is evicted, so anything holding glyph indices must look them up again.
+         */
+        unsigned int GetCacheGeneration() const;
+
+        /*
+         * Get the font generation.
+         * Every loaded font gets a new one which moves with its data, so a font loaded again in place after eviction can be told apart from its old data.
+         */
+        unsigned int GetGeneration() const;
+
+        /*
+         * Get the size of the font atlas, including glyph cache pages and any atlas not yet uploaded
+         */
+        int GetDataSize() const;
+
         /*
          * Get the default font
          */
         static Font *GetDefaultFont();
 
         /*
-         * Get a character glyph index
+         * Get glyph information by index.
+         * Invalid indices give an empty glyph.
+         */
+        const CharInfo &GetGlyph(int index_) const;
+
+        /*
+         * Get a character glyph index.
+         * Dynamic fonts rasterize the character into the glyph cache on first use.
+         * Unknown characters use the '?' glyph, or the first glyph if the font has none.
+         * Returns -1 if the font has no glyphs at all, GetGlyph gives an empty glyph for it.
          */
         int GetGlyphIndex(int char_) const;
 
         /*
-         * Get the font texture
+         * Get the kerning adjustment between two glyphs, at the base size
+         */
+        float GetKerning(int leftIndex_, int rightIndex_) const;
+
+        /*
+         * Decode the UTF-8 codepoint starting at the given byte.
+         * The number of bytes used is written to bytes_. Invalid sequences return '?' using a single byte.
+         */
+        static int GetNextCodepoint(const std::string &string_, int index_, int &bytes_);
+
+        /*
+         * Get the font texture for an atlas page
+         */
+        Texture2D *GetTexture(int page_ = 0) const;
+
+        /*
+         * Whether or not the font rasterizes glyphs on demand
          */
-        Texture2D *GetTexture() const;
+        bool IsDynamic() const;
+
+        /*
+         * Whether or not the atlas holds signed distance fields.
+         * These are drawn with the SDF shader so one atlas stays sharp at any size.
+         */
+        bool IsSDF() const;
 
         /*
          * Whether or not the font is valid.
@@ -132,15 +228,55 @@ namespace NerdThings::Ngine::Graphics {
         bool IsValid() const override;
 
         /*
-         * Load a true type font with specified characters
+         * Load a native (nfnt) font, see Export.
+         * Nothing is rasterized, the atlas is uploaded as stored. Returns null if the file is invalid.
+         */
+        static Font *LoadNativeFont(const Filesystem::Path &path_);
+
+        /*
+         * Load a true type font with specified characters.
+         * With sdf_ set, glyphs are stored as signed distance fields that scale cleanly to any draw size.
+         */
+        static Font *LoadTTFFont(const Filesystem::Path &path_, int baseSize_ = 36, std::vector<int> fontChars_ = std::vector<int>(), bool sdf_ = false);
+
+        /*
+         * Load a true type font that rasterizes glyphs the first time they are used.
+         * Glyphs are kept in up to maxCachePages_ atlas pages, evicting the least recently used glyph when full.
+         * Glyphs used in the current frame are never evicted.
+         */
+        static Font *LoadTTFFontDynamic(const Filesystem::Path &path_, int baseSize_ = 36, int cachePageSize_ = 512, int maxCachePages_ = 4);
+
+        /*
+         * Mark a glyph as used this frame so it is not evicted from the glyph cache.
+         * Intended for internal use. See TextLayout.
          */
-        static Font *LoadTTFFont(const Filesystem::Path &path_, int baseSize_ = 36, std::vector<int> fontChars_ = std::vector<int>());
+        void MarkGlyphUsed(int index_) const;
 
         /*
          * Measure the dimensions of a string
          */
         Vector2 MeasureString(const std::string &string_, float fontSize_, float spacing_) const;
 
+        /*
+         * Make sure every character of a string is in the glyph cache and uploaded.
+         * Does nothing for fonts that are not dynamic.
+         */
+        void PrepareGlyphs(const std::string &string_) const;
+
+        /*
+         * Load a true type font and rasterize its atlas without uploading it.
+         * This may be called from any thread, UploadAtlas must then be called on the main thread before use.
+         * Intended for internal use. See LoadTTFFont instead.
+         */
+        static Font *RasterizeTTFFont(const Filesystem::Path &path_, int baseSize_ = 36, std::vector<int> fontChars_ = std::vector<int>(), bool sdf_ = false);
+
+        /*
+         * Read a native (nfnt) font without uploading it.
+         * This may be called from any thread, UploadAtlas must then be called on the main thread before use.
+         * Intended for internal use. See LoadNativeFont instead.
+         */
+        static Font *ReadNativeFont(const Filesystem::Path &path_);
+
         /*
          * Set the default font
          */
@@ -150,12 +286,234 @@ namespace NerdThings::Ngine::Graphics {
          * Unload the font
          */
         void Unload() override;
+
+        /*
+         * Upload atlas pages rasterized by RasterizeTTFFont.
+         * Must be called on the main thread.
+         */
+        void UploadAtlas();
+
+        /*
+         * Upload glyphs rasterized into the glyph cache since the last upload.
+         * Only the changed rows of each page are uploaded.
+         */
+        void UploadGlyphCache() const;
+
+        // Operators
+
+        Font &operator=(const Font &) = delete;
+
+        /*
+         * Take the data of another font, including its generation
+         */
+        Font &operator=(Font &&font_) = default;
     private:
+        /*
+         * A page of the glyph cache
+         */
+        struct GlyphCachePage {
+            /*
+             * First row changed since the last upload
+             */
+            int DirtyBegin = 0;
+
+            /*
+             * Row after the last row changed since the last upload
+             */
+            int DirtyEnd = 0;
+
+            /*
+             * CPU copy of the page
+             */
+            std::shared_ptr<Image> Pixels;
+
+            /*
+             * The page texture
+             */
+            std::shared_ptr<Texture2D> Texture;
+        };
+
+        /*
+         * A cell in the glyph cache
+         */
+        struct GlyphCacheSlot {
+            /*
+             * The character held, -1 if free
+             */
+            int Character = -1;
+
+            /*
+             * The glyph index within the font file
+             */
+            int FontGlyph = 0;
+
+            /*
+             * The frame the glyph was last used
+             */
+            unsigned int LastUsed = 0;
+        };
+
+        // Private Fields
+
+        /*
+         * Rasterized atlas pages waiting for upload
+         */
+        std::vector<std::shared_ptr<Image>> _AtlasImages;
+
+        /*
+         * Glyph cache cell height
+         */
+        int _CacheCellHeight = 0;
+
+        /*
+         * Glyph cache cells on each page, 0 if the font is not dynamic
+         */
+        int _CacheCellsPerPage = 0;
+
+        /*
+         * Glyph cache cell width
+         */
+        int _CacheCellWidth = 0;
+
+        /*
+         * Glyph cache columns on each page
+         */
+        int _CacheColumns = 0;
+
+        /*
+         * Glyph cache generation, incremented on eviction
+         */
+        mutable unsigned int _CacheGeneration = 0;
+
+        /*
+         * Glyph indices of cached characters
+         */
+        mutable std::unordered_map<int, int> _CacheMap;
+
+        /*
+         * Maximum number of glyph cache pages
+         */
+        int _CacheMaxPages = 0;
+
+        /*
+         * Glyph cache pages
+         */
+        mutable std::vector<GlyphCachePage> _CachePages;
+
+        /*
+         * Glyph cache page width and height
+         */
+        int _CachePageSize = 0;
+
+        /*
+         * Glyph cache cells
+         */
+        mutable std::vector<GlyphCacheSlot> _CacheSlots;
+
+        /*
+         * Character information of the glyph cache cells
+         */
+        mutable std::vector<CharInfo> _CachedGlyphs;
+
+        /*
+         * The current frame, for glyph cache eviction
+         */
+        static unsigned int _CurrentFrame;
+
+        /*
+         * Scaled font ascent
+         */
+        int _FontAscent = 0;
+
+        /*
+         * Mapped font file, retained for dynamic fonts
+         */
+        std::unique_ptr<Filesystem::FileMapping> _FontData;
+
+        /*
+         * Font information, retained for dynamic fonts
+         */
+        std::shared_ptr<stbtt_fontinfo> _FontInfo;
+
+        /*
+         * Scale from font units to pixels at the base size
+         */
+        float _FontScale = 0;
+
+        /*
+         * The font generation
+         */
+        unsigned int _Generation;
+
+        /*
+         * Glyph index of each codepoint in the Latin-1 range, -1 if missing
+         */
+        int _GlyphTable[256];
+
+        /*
+         * Glyph indices of codepoints outside of the Latin-1 range
+         */
+        std::unordered_map<int, int> _GlyphMap;
+
+        /*
+         * Kerning adjustments between glyph pairs, keyed by (left << 16) | right
+         */
+        std::unordered_map<int, float> _KerningPairs;
+
+        /*
+         * Generation given to the next font
+         */
+        static std::atomic<unsigned int> _NextGeneration;
+
+        /*
+         * Whether or not glyphs are signed distance fields
+         */
+        bool _SDF = false;
+
         // Private Methods
 
+        /*
+         * Add a page to the glyph cache
+         */
+        void __AddCachePage() const;
+
+        /*
+         * Build the codepoint to glyph lookup tables
+         */
+        void __BuildGlyphTable();
+
+        /*
+         * Rasterize a character into the glyph cache.
+         * Returns the glyph index, or -1 if the cache has no room this frame.
+         */
+        int __CacheGlyph(int char_) const;
+
+        /*
+         * Pack the characters into atlas pages and rasterize them in place, ready for UploadAtlas
+         */
         void __GenerateAtlas();
 
-        void __LoadFontInfo(const Filesystem::Path &path_, std::vector<int> chars_);
+        /*
+         * Set up the glyph cache
+         */
+        void __InitGlyphCache(int pageSize_, int maxPages_);
+
+        /*
+         * Load the font file and its metrics
+         */
+        void __LoadFontData(const Filesystem::Path &path_);
+
+        /*
+         * Load metrics for a fixed set of characters.
+         * Glyph sizes are stored in each rectangle, the glyphs are rasterized by __GenerateAtlas.
+         */
+        void __LoadFontInfo(std::vector<int> chars_);
+
+        /*
+         * Rasterize a character into 8-bit coverage (or distance) pixels of the given stride.
+         * Safe to call from several threads at once.
+         */
+        void __RasterizeGlyph(int index_, unsigned char *pixels_, int stride_) const;
     };
 }
 
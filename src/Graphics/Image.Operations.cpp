@@ -0,0 +1,833 @@
+/**********************************************************************************************
+*
+*   Ngine - The 2D game engine.
+*
+*   Copyright (C) 2019 NerdThings
+*
+*   LICENSE: Apache License 2.0
+*   View: https://github.com/NerdThings/Ngine/blob/master/LICENSE
+*
+**********************************************************************************************/
+
+#include "Image.h"
+
+#include <climits>
+#include <cstdlib>
+#include <vector>
+
+#include "../ThreadPool.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define IMAGE_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace NerdThings::Ngine::Graphics {
+    // Public Fields
+
+    int Image::ParallelThreshold = 256 * 256;
+
+    // Public Methods
+
+    void Image::Blit(const Image &src_, int x_, int y_) {
+        Blit(src_, 0, 0, src_.Width, src_.Height, x_, y_);
+    }
+
+    void Image::Blit(const Image &src_, int srcX_, int srcY_, int width_, int height_, int x_, int y_) {
+        if (!IsValid() || !src_.IsValid()) return;
+
+        auto srcChannels = __GetChannelCount(src_.Format);
+        auto dstChannels = __GetChannelCount(Format);
+        if (srcChannels == 0 || dstChannels == 0) {
+            ConsoleMessage("Blit only supports uncompressed 8-bit formats.", "WARN", "Image");
+            return;
+        }
+
+        // Clip to the source
+        if (srcX_ < 0) { width_ += srcX_; x_ -= srcX_; srcX_ = 0; }
+        if (srcY_ < 0) { height_ += srcY_; y_ -= srcY_; srcY_ = 0; }
+        width_ = std::min(width_, src_.Width - srcX_);
+        height_ = std::min(height_, src_.Height - srcY_);
+
+        // Clip to the destination
+        if (x_ < 0) { width_ += x_; srcX_ -= x_; x_ = 0; }
+        if (y_ < 0) { height_ += y_; srcY_ -= y_; y_ = 0; }
+        width_ = std::min(width_, Width - x_);
+        height_ = std::min(height_, Height - y_);
+
+        if (width_ <= 0 || height_ <= 0) return;
+
+        auto srcStride = src_.Width * srcChannels;
+        auto dstStride = Width * dstChannels;
+        auto srcData = src_.PixelData + srcY_ * srcStride + srcX_ * srcChannels;
+        auto dstData = PixelData + y_ * dstStride + x_ * dstChannels;
+
+        __ForEachRow(height_, width_, [&](int begin_, int end_) {
+            for (auto y = begin_; y < end_; y++) {
+                if (srcChannels == dstChannels)
+                    memcpy(dstData + y * dstStride, srcData + y * srcStride, width_ * dstChannels);
+                else __ConvertPixels(srcData + y * srcStride, srcChannels, dstData + y * dstStride, dstChannels, width_);
+            }
+        });
+
+        // Mipmaps are now out of date
+        Mipmaps = 1;
+    }
+
+    bool Image::Compress(PixelFormat format_) {
+        if (!IsValid()) return false;
+        if (Format == format_) return true;
+
+        if (format_ != COMPRESSED_DXT1_RGB && format_ != COMPRESSED_DXT1_RGBA && format_ != COMPRESSED_DXT5_RGBA) {
+            ConsoleMessage("Images can only be compressed to DXT1 or DXT5.", "WARN", "Image");
+            return false;
+        }
+
+        // Encode from RGBA8, keeping the mip chain
+        if (IsCompressed() && !Decompress()) return false;
+
+        if (Format != UNCOMPRESSED_R8G8B8A8) {
+            if (__GetChannelCount(Format) == 0) {
+                ConsoleMessage("Compression only supports uncompressed 8-bit formats.", "WARN", "Image");
+                return false;
+            }
+
+            auto hadMipmaps = Mipmaps > 1;
+            ConvertFormat(UNCOMPRESSED_R8G8B8A8);
+            if (hadMipmaps) GenerateMipmaps();
+        }
+
+        auto blockSize = format_ == COMPRESSED_DXT5_RGBA ? 16 : 8;
+        auto totalSize = 0;
+        auto mipWidth = Width;
+        auto mipHeight = Height;
+        for (auto i = 0; i < Mipmaps; i++) {
+            totalSize += GetPixelDataSize(mipWidth, mipHeight, format_);
+            mipWidth = mipWidth > 1 ? mipWidth / 2 : 1;
+            mipHeight = mipHeight > 1 ? mipHeight / 2 : 1;
+        }
+
+        auto compressed = (unsigned char *)malloc(totalSize);
+        auto src = PixelData;
+        auto dst = compressed;
+        mipWidth = Width;
+        mipHeight = Height;
+
+        for (auto i = 0; i < Mipmaps; i++) {
+            auto blocksX = (mipWidth + 3) / 4;
+            auto blocksY = (mipHeight + 3) / 4;
+            auto w = mipWidth;
+            auto h = mipHeight;
+
+            __ForEachRow(blocksY, blocksX * 16, [&](int begin_, int end_) {
+                for (auto by = begin_; by < end_; by++) {
+                    for (auto bx = 0; bx < blocksX; bx++) {
+                        // Gather the block, repeating edge pixels into partial blocks
+                        unsigned char pixels[16 * 4];
+                        for (auto p = 0; p < 16; p++) {
+                            auto x = std::min(bx * 4 + p % 4, w - 1);
+                            auto y = std::min(by * 4 + p / 4, h - 1);
+                            memcpy(pixels + p * 4, src + (y * w + x) * 4, 4);
+                        }
+
+                        auto block = dst + (by * blocksX + bx) * blockSize;
+                        if (format_ == COMPRESSED_DXT5_RGBA) {
+                            __EncodeDXTAlphaBlock(pixels, block);
+                            __EncodeDXTColorBlock(pixels, block + 8, false);
+                        } else __EncodeDXTColorBlock(pixels, block, format_ == COMPRESSED_DXT1_RGBA);
+                    }
+                }
+            });
+
+            src += mipWidth * mipHeight * 4;
+            dst += blocksX * blocksY * blockSize;
+            mipWidth = mipWidth > 1 ? mipWidth / 2 : 1;
+            mipHeight = mipHeight > 1 ? mipHeight / 2 : 1;
+        }
+
+        free(PixelData);
+        PixelData = compressed;
+        Format = format_;
+        return true;
+    }
+
+    void Image::ConvertFormat(PixelFormat format_) {
+        if (!IsValid() || Format == format_) return;
+
+        auto srcChannels = __GetChannelCount(Format);
+        auto dstChannels = __GetChannelCount(format_);
+        if (srcChannels == 0 || dstChannels == 0) {
+            ConsoleMessage("Format conversion only supports uncompressed 8-bit formats.", "WARN", "Image");
+            return;
+        }
+
+        auto data = (unsigned char *)malloc(Width * Height * dstChannels);
+        auto src = PixelData;
+
+        __ForEachRow(Height, Width, [&](int begin_, int end_) {
+            __ConvertPixels(src + begin_ * Width * srcChannels, srcChannels, data + begin_ * Width * dstChannels, dstChannels, (end_ - begin_) * Width);
+        });
+
+        free(PixelData);
+        PixelData = data;
+        Format = format_;
+        Mipmaps = 1;
+    }
+
+    void Image::Crop(int x_, int y_, int width_, int height_) {
+        if (!IsValid()) return;
+
+        auto channels = __GetChannelCount(Format);
+        if (channels == 0) {
+            ConsoleMessage("Crop only supports uncompressed 8-bit formats.", "WARN", "Image");
+            return;
+        }
+
+        // Clip region to the image
+        if (x_ < 0) { width_ += x_; x_ = 0; }
+        if (y_ < 0) { height_ += y_; y_ = 0; }
+        width_ = std::min(width_, Width - x_);
+        height_ = std::min(height_, Height - y_);
+
+        if (width_ <= 0 || height_ <= 0) {
+            ConsoleMessage("Crop region is outside of the image.", "WARN", "Image");
+            return;
+        }
+
+        auto data = (unsigned char *)malloc(width_ * height_ * channels);
+        for (auto y = 0; y < height_; y++)
+            memcpy(data + y * width_ * channels, PixelData + ((y_ + y) * Width + x_) * channels, width_ * channels);
+
+        free(PixelData);
+        PixelData = data;
+        Width = width_;
+        Height = height_;
+        Mipmaps = 1;
+    }
+
+    void Image::FlipHorizontal() {
+        if (!IsValid()) return;
+
+        auto channels = __GetChannelCount(Format);
+        if (channels == 0) {
+            ConsoleMessage("Flip only supports uncompressed 8-bit formats.", "WARN", "Image");
+            return;
+        }
+
+        auto data = PixelData;
+        auto width = Width;
+
+        __ForEachRow(Height, Width, [&](int begin_, int end_) {
+            for (auto y = begin_; y < end_; y++) {
+                auto row = data + y * width * channels;
+                auto left = 0;
+                auto right = width - 1;
+
+#if defined(IMAGE_SSE2)
+                if (channels == 4) {
+                    // Swap and reverse 4 pixels from each end
+                    for (; left + 4 <= right - 3; left += 4, right -= 4) {
+                        auto l = _mm_loadu_si128((const __m128i *)(row + left * 4));
+                        auto r = _mm_loadu_si128((const __m128i *)(row + (right - 3) * 4));
+                        _mm_storeu_si128((__m128i *)(row + left * 4), _mm_shuffle_epi32(r, _MM_SHUFFLE(0, 1, 2, 3)));
+                        _mm_storeu_si128((__m128i *)(row + (right - 3) * 4), _mm_shuffle_epi32(l, _MM_SHUFFLE(0, 1, 2, 3)));
+                    }
+                }
+#endif
+
+                // Remaining pixels
+                for (; left < right; left++, right--) {
+                    for (auto c = 0; c < channels; c++)
+                        std::swap(row[left * channels + c], row[right * channels + c]);
+                }
+            }
+        });
+
+        Mipmaps = 1;
+    }
+
+    void Image::FlipVertical() {
+        if (!IsValid()) return;
+
+        auto channels = __GetChannelCount(Format);
+        if (channels == 0) {
+            ConsoleMessage("Flip only supports uncompressed 8-bit formats.", "WARN", "Image");
+            return;
+        }
+
+        auto data = PixelData;
+        auto stride = Width * channels;
+        auto height = Height;
+
+        __ForEachRow(Height / 2, Width * 2, [&](int begin_, int end_) {
+            auto temp = (unsigned char *)malloc(stride);
+
+            for (auto y = begin_; y < end_; y++) {
+                auto top = data + y * stride;
+                auto bottom = data + (height - 1 - y) * stride;
+                memcpy(temp, top, stride);
+                memcpy(top, bottom, stride);
+                memcpy(bottom, temp, stride);
+            }
+
+            free(temp);
+        });
+
+        Mipmaps = 1;
+    }
+
+    void Image::GrayscaleToAlpha() {
+        if (!IsValid()) return;
+
+        if (Format != UNCOMPRESSED_GRAYSCALE) {
+            ConsoleMessage("Only grayscale images can be converted to alpha.", "WARN", "Image");
+            return;
+        }
+
+        auto data = (unsigned char *)malloc(Width * Height * 2);
+        auto src = PixelData;
+        auto width = Width;
+
+        __ForEachRow(Height, Width, [&](int begin_, int end_) {
+            auto in = src + begin_ * width;
+            auto out = data + begin_ * width * 2;
+            auto count = (end_ - begin_) * width;
+            auto i = 0;
+
+#if defined(IMAGE_SSE2)
+            // Interleave white with the gray values, 16 pixels per iteration
+            const auto white = _mm_set1_epi8((char)0xFF);
+
+            for (; i + 16 <= count; i += 16) {
+                auto v = _mm_loadu_si128((const __m128i *)(in + i));
+                _mm_storeu_si128((__m128i *)(out + i * 2), _mm_unpacklo_epi8(white, v));
+                _mm_storeu_si128((__m128i *)(out + i * 2 + 16), _mm_unpackhi_epi8(white, v));
+            }
+#endif
+
+            for (; i < count; i++) {
+                out[i * 2] = 255;
+                out[i * 2 + 1] = in[i];
+            }
+        });
+
+        free(PixelData);
+        PixelData = data;
+        Format = UNCOMPRESSED_GRAY_ALPHA;
+        Mipmaps = 1;
+    }
+
+    void Image::PremultiplyAlpha() {
+        if (!IsValid()) return;
+
+        if (Format != UNCOMPRESSED_R8G8B8A8 && Format != UNCOMPRESSED_GRAY_ALPHA) {
+            ConsoleMessage("Premultiplied alpha requires an RGBA8 or gray alpha image.", "WARN", "Image");
+            return;
+        }
+
+        auto channels = __GetChannelCount(Format);
+        auto data = PixelData;
+        auto width = Width;
+
+        __ForEachRow(Height, Width, [&](int begin_, int end_) {
+            __PremultiplyPixels(data + begin_ * width * channels, (end_ - begin_) * width, channels);
+        });
+
+        Mipmaps = 1;
+    }
+
+    void Image::Resize(int width_, int height_, ResizeFilter filter_) {
+        if (!IsValid() || width_ <= 0 || height_ <= 0) return;
+        if (width_ == Width && height_ == Height) return;
+
+        auto channels = __GetChannelCount(Format);
+        if (channels == 0) {
+            ConsoleMessage("Resize only supports uncompressed 8-bit formats.", "WARN", "Image");
+            return;
+        }
+
+        auto data = (unsigned char *)malloc(width_ * height_ * channels);
+        auto src = PixelData;
+        auto width = Width;
+        auto height = Height;
+
+        if (filter_ == RESIZE_BOX && width_ == std::max(1, Width / 2) && height_ == std::max(1, Height / 2)) {
+            // Exact halving, use the mipmap kernel
+            __ForEachRow(height_, width_, [&](int begin_, int end_) {
+                __DownsampleBox(src, width, height, data, channels, begin_, end_);
+            });
+        } else if (filter_ == RESIZE_BOX) {
+            __ForEachRow(height_, width_, [&](int begin_, int end_) {
+                __ResizeBox(src, width, height, data, width_, height_, channels, begin_, end_);
+            });
+        } else {
+            __ForEachRow(height_, width_, [&](int begin_, int end_) {
+                __ResizeBilinear(src, width, height, data, width_, height_, channels, begin_, end_);
+            });
+        }
+
+        free(PixelData);
+        PixelData = data;
+        Width = width_;
+        Height = height_;
+        Mipmaps = 1;
+    }
+
+    // Private Methods
+
+    void Image::__ConvertPixels(const unsigned char *src_, int srcChannels_, unsigned char *dst_, int dstChannels_, int count_) {
+        auto i = 0;
+
+#if defined(IMAGE_SSE2)
+        const auto white = _mm_set1_epi8((char)0xFF);
+
+        if (srcChannels_ == 1 && dstChannels_ == 2) {
+            // Gray to gray alpha, 16 pixels per iteration
+            for (; i + 16 <= count_; i += 16) {
+                auto v = _mm_loadu_si128((const __m128i *)(src_ + i));
+                _mm_storeu_si128((__m128i *)(dst_ + i * 2), _mm_unpacklo_epi8(v, white));
+                _mm_storeu_si128((__m128i *)(dst_ + i * 2 + 16), _mm_unpackhi_epi8(v, white));
+            }
+        } else if (srcChannels_ == 1 && dstChannels_ == 4) {
+            // Gray to RGBA, 16 pixels per iteration
+            for (; i + 16 <= count_; i += 16) {
+                auto v = _mm_loadu_si128((const __m128i *)(src_ + i));
+                auto gg0 = _mm_unpacklo_epi8(v, v);
+                auto gg1 = _mm_unpackhi_epi8(v, v);
+                auto ga0 = _mm_unpacklo_epi8(v, white);
+                auto ga1 = _mm_unpackhi_epi8(v, white);
+                _mm_storeu_si128((__m128i *)(dst_ + i * 4), _mm_unpacklo_epi16(gg0, ga0));
+                _mm_storeu_si128((__m128i *)(dst_ + i * 4 + 16), _mm_unpackhi_epi16(gg0, ga0));
+                _mm_storeu_si128((__m128i *)(dst_ + i * 4 + 32), _mm_unpacklo_epi16(gg1, ga1));
+                _mm_storeu_si128((__m128i *)(dst_ + i * 4 + 48), _mm_unpackhi_epi16(gg1, ga1));
+            }
+        } else if (srcChannels_ == 2 && dstChannels_ == 4) {
+            // Gray alpha to RGBA, 8 pixels per iteration
+            const auto low = _mm_set1_epi16(0x00FF);
+
+            for (; i + 8 <= count_; i += 8) {
+                auto ga = _mm_loadu_si128((const __m128i *)(src_ + i * 2));
+                auto gg = _mm_or_si128(_mm_and_si128(ga, low), _mm_slli_epi16(ga, 8));
+                _mm_storeu_si128((__m128i *)(dst_ + i * 4), _mm_unpacklo_epi16(gg, ga));
+                _mm_storeu_si128((__m128i *)(dst_ + i * 4 + 16), _mm_unpackhi_epi16(gg, ga));
+            }
+        }
+#endif
+
+        // Remaining pixels, via RGBA
+        for (; i < count_; i++) {
+            auto in = src_ + i * srcChannels_;
+            auto out = dst_ + i * dstChannels_;
+            unsigned char r, g, b, a = 255;
+
+            switch (srcChannels_) {
+                case 1: r = g = b = in[0]; break;
+                case 2: r = g = b = in[0]; a = in[1]; break;
+                case 3: r = in[0]; g = in[1]; b = in[2]; break;
+                default: r = in[0]; g = in[1]; b = in[2]; a = in[3]; break;
+            }
+
+            switch (dstChannels_) {
+                case 1:
+                    out[0] = (unsigned char)((r * 77 + g * 150 + b * 29 + 128) >> 8);
+                    break;
+                case 2:
+                    out[0] = (unsigned char)((r * 77 + g * 150 + b * 29 + 128) >> 8);
+                    out[1] = a;
+                    break;
+                case 3:
+                    out[0] = r; out[1] = g; out[2] = b;
+                    break;
+                default:
+                    out[0] = r; out[1] = g; out[2] = b; out[3] = a;
+                    break;
+            }
+        }
+    }
+
+    void Image::__DownsampleBox(const unsigned char *src_, int srcWidth_, int srcHeight_, unsigned char *dst_, int channels_, int rowBegin_, int rowEnd_) {
+        auto dstWidth = srcWidth_ > 1 ? srcWidth_ / 2 : 1;
+        auto srcStride = srcWidth_ * channels_;
+        auto dstStride = dstWidth * channels_;
+
+        for (auto y = rowBegin_; y < rowEnd_; y++) {
+            auto row0 = src_ + (srcHeight_ > 1 ? y * 2 : 0) * srcStride;
+            auto row1 = srcHeight_ > 1 ? row0 + srcStride : row0;
+            auto out = dst_ + y * dstStride;
+
+            // Single column, only filter vertically
+            if (srcWidth_ == 1) {
+                for (auto c = 0; c < channels_; c++)
+                    out[c] = (unsigned char)((row0[c] + row1[c] + 1) >> 1);
+                continue;
+            }
+
+            auto x = 0;
+
+#if defined(IMAGE_SSE2)
+            const auto zero = _mm_setzero_si128();
+            const auto two = _mm_set1_epi16(2);
+
+            if (channels_ == 4) {
+                // 4 output pixels per iteration, pixels are 64-bit lanes once widened
+                for (; x + 4 <= dstWidth; x += 4) {
+                    auto a0 = _mm_loadu_si128((const __m128i *)(row0 + x * 8));
+                    auto a1 = _mm_loadu_si128((const __m128i *)(row0 + x * 8 + 16));
+                    auto b0 = _mm_loadu_si128((const __m128i *)(row1 + x * 8));
+                    auto b1 = _mm_loadu_si128((const __m128i *)(row1 + x * 8 + 16));
+
+                    // Vertical sums
+                    auto p01 = _mm_add_epi16(_mm_unpacklo_epi8(a0, zero), _mm_unpacklo_epi8(b0, zero));
+                    auto p23 = _mm_add_epi16(_mm_unpackhi_epi8(a0, zero), _mm_unpackhi_epi8(b0, zero));
+                    auto p45 = _mm_add_epi16(_mm_unpacklo_epi8(a1, zero), _mm_unpacklo_epi8(b1, zero));
+                    auto p67 = _mm_add_epi16(_mm_unpackhi_epi8(a1, zero), _mm_unpackhi_epi8(b1, zero));
+
+                    // Horizontal sums
+                    auto s0 = _mm_add_epi16(_mm_unpacklo_epi64(p01, p23), _mm_unpackhi_epi64(p01, p23));
+                    auto s1 = _mm_add_epi16(_mm_unpacklo_epi64(p45, p67), _mm_unpackhi_epi64(p45, p67));
+
+                    // Average
+                    s0 = _mm_srli_epi16(_mm_add_epi16(s0, two), 2);
+                    s1 = _mm_srli_epi16(_mm_add_epi16(s1, two), 2);
+                    _mm_storeu_si128((__m128i *)(out + x * 4), _mm_packus_epi16(s0, s1));
+                }
+            } else if (channels_ == 2) {
+                // 8 output pixels per iteration, pixels are 32-bit lanes once widened
+                for (; x + 8 <= dstWidth; x += 8) {
+                    auto a0 = _mm_loadu_si128((const __m128i *)(row0 + x * 4));
+                    auto a1 = _mm_loadu_si128((const __m128i *)(row0 + x * 4 + 16));
+                    auto b0 = _mm_loadu_si128((const __m128i *)(row1 + x * 4));
+                    auto b1 = _mm_loadu_si128((const __m128i *)(row1 + x * 4 + 16));
+
+                    // Vertical sums
+                    auto q0 = _mm_add_epi16(_mm_unpacklo_epi8(a0, zero), _mm_unpacklo_epi8(b0, zero));
+                    auto q1 = _mm_add_epi16(_mm_unpackhi_epi8(a0, zero), _mm_unpackhi_epi8(b0, zero));
+                    auto q2 = _mm_add_epi16(_mm_unpacklo_epi8(a1, zero), _mm_unpacklo_epi8(b1, zero));
+                    auto q3 = _mm_add_epi16(_mm_unpackhi_epi8(a1, zero), _mm_unpackhi_epi8(b1, zero));
+
+                    // Horizontal sums of even and odd pixels
+                    auto s0 = _mm_add_epi16(
+                            _mm_unpacklo_epi64(_mm_shuffle_epi32(q0, _MM_SHUFFLE(2, 0, 2, 0)), _mm_shuffle_epi32(q1, _MM_SHUFFLE(2, 0, 2, 0))),
+                            _mm_unpacklo_epi64(_mm_shuffle_epi32(q0, _MM_SHUFFLE(3, 1, 3, 1)), _mm_shuffle_epi32(q1, _MM_SHUFFLE(3, 1, 3, 1))));
+                    auto s1 = _mm_add_epi16(
+                            _mm_unpacklo_epi64(_mm_shuffle_epi32(q2, _MM_SHUFFLE(2, 0, 2, 0)), _mm_shuffle_epi32(q3, _MM_SHUFFLE(2, 0, 2, 0))),
+                            _mm_unpacklo_epi64(_mm_shuffle_epi32(q2, _MM_SHUFFLE(3, 1, 3, 1)), _mm_shuffle_epi32(q3, _MM_SHUFFLE(3, 1, 3, 1))));
+
+                    // Average
+                    s0 = _mm_srli_epi16(_mm_add_epi16(s0, two), 2);
+                    s1 = _mm_srli_epi16(_mm_add_epi16(s1, two), 2);
+                    _mm_storeu_si128((__m128i *)(out + x * 2), _mm_packus_epi16(s0, s1));
+                }
+            } else if (channels_ == 1) {
+                // 16 output pixels per iteration, split even and odd bytes
+                const auto mask = _mm_set1_epi16(0x00FF);
+
+                for (; x + 16 <= dstWidth; x += 16) {
+                    auto a0 = _mm_loadu_si128((const __m128i *)(row0 + x * 2));
+                    auto a1 = _mm_loadu_si128((const __m128i *)(row0 + x * 2 + 16));
+                    auto b0 = _mm_loadu_si128((const __m128i *)(row1 + x * 2));
+                    auto b1 = _mm_loadu_si128((const __m128i *)(row1 + x * 2 + 16));
+
+                    // Horizontal then vertical sums
+                    auto s0 = _mm_add_epi16(_mm_add_epi16(_mm_and_si128(a0, mask), _mm_srli_epi16(a0, 8)),
+                                            _mm_add_epi16(_mm_and_si128(b0, mask), _mm_srli_epi16(b0, 8)));
+                    auto s1 = _mm_add_epi16(_mm_add_epi16(_mm_and_si128(a1, mask), _mm_srli_epi16(a1, 8)),
+                                            _mm_add_epi16(_mm_and_si128(b1, mask), _mm_srli_epi16(b1, 8)));
+
+                    // Average
+                    s0 = _mm_srli_epi16(_mm_add_epi16(s0, two), 2);
+                    s1 = _mm_srli_epi16(_mm_add_epi16(s1, two), 2);
+                    _mm_storeu_si128((__m128i *)(out + x), _mm_packus_epi16(s0, s1));
+                }
+            }
+#endif
+
+            // Remaining pixels
+            for (; x < dstWidth; x++) {
+                auto in0 = row0 + x * 2 * channels_;
+                auto in1 = row1 + x * 2 * channels_;
+
+                for (auto c = 0; c < channels_; c++)
+                    out[x * channels_ + c] = (unsigned char)((in0[c] + in0[c + channels_] + in1[c] + in1[c + channels_] + 2) >> 2);
+            }
+        }
+    }
+
+    void Image::__EncodeDXTAlphaBlock(const unsigned char *pixels_, unsigned char *block_) {
+        // Endpoints are the alpha range, using the 8 value mode
+        int maxAlpha = 0, minAlpha = 255;
+        for (auto p = 0; p < 16; p++) {
+            maxAlpha = std::max(maxAlpha, (int)pixels_[p * 4 + 3]);
+            minAlpha = std::min(minAlpha, (int)pixels_[p * 4 + 3]);
+        }
+
+        block_[0] = (unsigned char)maxAlpha;
+        block_[1] = (unsigned char)minAlpha;
+
+        int alphas[8] = {maxAlpha, minAlpha};
+        for (auto a = 1; a < 7; a++) alphas[a + 1] = ((7 - a) * maxAlpha + a * minAlpha) / 7;
+
+        // Nearest palette entry for each pixel, 3 bits each
+        unsigned long long indices = 0;
+        if (maxAlpha > minAlpha) {
+            for (auto p = 0; p < 16; p++) {
+                auto best = 0;
+                for (auto a = 1; a < 8; a++) {
+                    if (abs(alphas[a] - pixels_[p * 4 + 3]) < abs(alphas[best] - pixels_[p * 4 + 3])) best = a;
+                }
+                indices |= (unsigned long long)best << (p * 3);
+            }
+        }
+
+        for (auto b = 0; b < 6; b++) block_[2 + b] = (unsigned char)(indices >> (b * 8));
+    }
+
+    void Image::__EncodeDXTColorBlock(const unsigned char *pixels_, unsigned char *block_, bool allowTransparent_) {
+        // Bounding box of the opaque colors
+        int minColor[3] = {255, 255, 255}, maxColor[3] = {0, 0, 0};
+        auto transparent = false;
+        for (auto p = 0; p < 16; p++) {
+            if (allowTransparent_ && pixels_[p * 4 + 3] < 128) {
+                transparent = true;
+                continue;
+            }
+
+            for (auto c = 0; c < 3; c++) {
+                minColor[c] = std::min(minColor[c], (int)pixels_[p * 4 + c]);
+                maxColor[c] = std::max(maxColor[c], (int)pixels_[p * 4 + c]);
+            }
+        }
+
+        // Fully transparent block
+        if (minColor[0] > maxColor[0]) {
+            minColor[0] = minColor[1] = minColor[2] = 0;
+            maxColor[0] = maxColor[1] = maxColor[2] = 0;
+        }
+
+        // Inset the box slightly, the endpoints are rarely hit exactly
+        for (auto c = 0; c < 3; c++) {
+            auto inset = (maxColor[c] - minColor[c]) / 16;
+            minColor[c] += inset;
+            maxColor[c] -= inset;
+        }
+
+        unsigned int c0 = ((maxColor[0] >> 3) << 11) | ((maxColor[1] >> 2) << 5) | (maxColor[2] >> 3);
+        unsigned int c1 = ((minColor[0] >> 3) << 11) | ((minColor[1] >> 2) << 5) | (minColor[2] >> 3);
+
+        // The endpoint order selects the mode, the transparent mode needs c0 <= c1
+        if (transparent ? c0 > c1 : c0 < c1) std::swap(c0, c1);
+
+        block_[0] = (unsigned char)(c0 & 0xff);
+        block_[1] = (unsigned char)(c0 >> 8);
+        block_[2] = (unsigned char)(c1 & 0xff);
+        block_[3] = (unsigned char)(c1 >> 8);
+
+        // Get the palette exactly as it is decoded, with indices 0 to 3 on the first row
+        block_[4] = 0xe4;
+        block_[5] = block_[6] = block_[7] = 0;
+
+        // Opaque blocks are written with c0 > c1 unless the endpoints are equal, so the DXT1 palette matches every format
+        unsigned char decoded[16 * 4];
+        __DecodeDXTColorBlock(block_, decoded, allowTransparent_ ? COMPRESSED_DXT1_RGBA : COMPRESSED_DXT1_RGB);
+
+        // Equal endpoints leave one color to pick
+        auto colors = c0 == c1 ? 1 : (transparent ? 3 : 4);
+
+        unsigned int indices = 0;
+        for (auto p = 0; p < 16; p++) {
+            auto best = 0;
+
+            if (transparent && pixels_[p * 4 + 3] < 128) best = 3;
+            else {
+                auto bestDistance = INT_MAX;
+                for (auto i = 0; i < colors; i++) {
+                    auto distance = 0;
+                    for (auto c = 0; c < 3; c++) {
+                        auto d = (int)decoded[i * 4 + c] - (int)pixels_[p * 4 + c];
+                        distance += d * d;
+                    }
+
+                    if (distance < bestDistance) {
+                        bestDistance = distance;
+                        best = i;
+                    }
+                }
+            }
+
+            indices |= (unsigned int)best << (p * 2);
+        }
+
+        block_[4] = (unsigned char)(indices & 0xff);
+        block_[5] = (unsigned char)(indices >> 8);
+        block_[6] = (unsigned char)(indices >> 16);
+        block_[7] = (unsigned char)(indices >> 24);
+    }
+
+    void Image::__ForEachRow(int rows_, int rowPixels_, const std::function<void(int, int)> &func_) {
+        if (ParallelThreshold > 0 && (long long)rows_ * rowPixels_ >= ParallelThreshold) {
+            // Keep chunks at a reasonable size so small rows are not scheduled one by one
+            auto grain = std::max(1, 16384 / std::max(1, rowPixels_));
+            ThreadPool::ParallelFor(0, rows_, func_, grain);
+        } else func_(0, rows_);
+    }
+
+    int Image::__GetChannelCount(PixelFormat format_) {
+        switch (format_) {
+            case UNCOMPRESSED_GRAYSCALE: return 1;
+            case UNCOMPRESSED_GRAY_ALPHA: return 2;
+            case UNCOMPRESSED_R8G8B8: return 3;
+            case UNCOMPRESSED_R8G8B8A8: return 4;
+            default: return 0;
+        }
+    }
+
+    void Image::__PremultiplyPixels(unsigned char *data_, int count_, int channels_) {
+        auto i = 0;
+
+#if defined(IMAGE_SSE2)
+        if (channels_ == 4) {
+            // 4 pixels per iteration, multiply in 16-bit lanes.
+            // The alpha lane is multiplied by 255 so it is left unchanged.
+            const auto zero = _mm_setzero_si128();
+            const auto alphaMask = _mm_set_epi16(-1, 0, 0, 0, -1, 0, 0, 0);
+            const auto alphaOne = _mm_set_epi16(255, 0, 0, 0, 255, 0, 0, 0);
+            const auto half = _mm_set1_epi16(128);
+
+            auto multiply = [&](__m128i px) {
+                auto alpha = _mm_shufflehi_epi16(_mm_shufflelo_epi16(px, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+                alpha = _mm_or_si128(_mm_andnot_si128(alphaMask, alpha), alphaOne);
+
+                // (x * a + 128 + ((x * a + 128) >> 8)) >> 8 is x * a / 255 rounded
+                auto t = _mm_add_epi16(_mm_mullo_epi16(px, alpha), half);
+                return _mm_srli_epi16(_mm_add_epi16(t, _mm_srli_epi16(t, 8)), 8);
+            };
+
+            for (; i + 4 <= count_; i += 4) {
+                auto v = _mm_loadu_si128((const __m128i *)(data_ + i * 4));
+                auto lo = multiply(_mm_unpacklo_epi8(v, zero));
+                auto hi = multiply(_mm_unpackhi_epi8(v, zero));
+                _mm_storeu_si128((__m128i *)(data_ + i * 4), _mm_packus_epi16(lo, hi));
+            }
+        }
+#endif
+
+        // Remaining pixels
+        for (; i < count_; i++) {
+            auto px = data_ + i * channels_;
+            auto a = px[channels_ - 1];
+
+            for (auto c = 0; c < channels_ - 1; c++) {
+                auto t = px[c] * a + 128;
+                px[c] = (unsigned char)((t + (t >> 8)) >> 8);
+            }
+        }
+    }
+
+    void Image::__ResizeBilinear(const unsigned char *src_, int srcWidth_, int srcHeight_, unsigned char *dst_, int dstWidth_, int dstHeight_, int channels_, int rowBegin_, int rowEnd_) {
+        auto srcStride = srcWidth_ * channels_;
+
+        // Map a destination coordinate to a source index and 8-bit weight.
+        // The index is kept one short of the edge so the neighbour is always in bounds, using a full weight instead.
+        auto map = [](int dst_, int dstSize_, int srcSize_, int &index_, int &weight_) {
+            auto pos = (int)(((long long)(2 * dst_ + 1) * srcSize_ * 256) / (2 * dstSize_)) - 128;
+            if (pos < 0) pos = 0;
+            index_ = pos >> 8;
+            weight_ = pos & 0xFF;
+
+            if (srcSize_ == 1) {
+                index_ = 0;
+                weight_ = 0;
+            } else if (index_ >= srcSize_ - 1) {
+                index_ = srcSize_ - 2;
+                weight_ = 256;
+            }
+        };
+
+        // Horizontal lookup
+        std::vector<int> xIndex(dstWidth_), xWeight(dstWidth_);
+        for (auto x = 0; x < dstWidth_; x++)
+            map(x, dstWidth_, srcWidth_, xIndex[x], xWeight[x]);
+
+        auto next = srcWidth_ > 1 ? channels_ : 0;
+
+        for (auto y = rowBegin_; y < rowEnd_; y++) {
+            int yIndex, fy;
+            map(y, dstHeight_, srcHeight_, yIndex, fy);
+
+            auto row0 = src_ + yIndex * srcStride;
+            auto row1 = srcHeight_ > 1 ? row0 + srcStride : row0;
+            auto out = dst_ + y * dstWidth_ * channels_;
+            auto x = 0;
+
+#if defined(IMAGE_SSE2)
+            if (channels_ == 4 && srcWidth_ > 1) {
+                const auto zero = _mm_setzero_si128();
+                const auto half = _mm_set1_epi16(128);
+                const auto wy0 = _mm_set1_epi16((short)(256 - fy));
+                const auto wy1 = _mm_set1_epi16((short)fy);
+
+                for (; x < dstWidth_; x++) {
+                    auto fx = (short)xWeight[x];
+                    auto wx = _mm_set_epi16(fx, fx, fx, fx, (short)(256 - fx), (short)(256 - fx), (short)(256 - fx), (short)(256 - fx));
+
+                    // Both neighbours of each row in one register, then fold the halves
+                    auto a = _mm_mullo_epi16(_mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)(row0 + xIndex[x] * 4)), zero), wx);
+                    auto b = _mm_mullo_epi16(_mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)(row1 + xIndex[x] * 4)), zero), wx);
+                    a = _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(a, _mm_srli_si128(a, 8)), half), 8);
+                    b = _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(b, _mm_srli_si128(b, 8)), half), 8);
+
+                    // Vertical
+                    auto v = _mm_add_epi16(_mm_add_epi16(_mm_mullo_epi16(a, wy0), _mm_mullo_epi16(b, wy1)), half);
+                    v = _mm_srli_epi16(v, 8);
+
+                    auto px = _mm_cvtsi128_si32(_mm_packus_epi16(v, zero));
+                    memcpy(out + x * 4, &px, 4);
+                }
+            }
+#endif
+
+            // Remaining pixels
+            for (; x < dstWidth_; x++) {
+                auto in0 = row0 + xIndex[x] * channels_;
+                auto in1 = row1 + xIndex[x] * channels_;
+                auto fx = xWeight[x];
+
+                for (auto c = 0; c < channels_; c++) {
+                    auto top = (in0[c] * (256 - fx) + in0[c + next] * fx + 128) >> 8;
+                    auto bottom = (in1[c] * (256 - fx) + in1[c + next] * fx + 128) >> 8;
+                    out[x * channels_ + c] = (unsigned char)((top * (256 - fy) + bottom * fy + 128) >> 8);
+                }
+            }
+        }
+    }
+
+    void Image::__ResizeBox(const unsigned char *src_, int srcWidth_, int srcHeight_, unsigned char *dst_, int dstWidth_, int dstHeight_, int channels_, int rowBegin_, int rowEnd_) {
+        auto srcStride = srcWidth_ * channels_;
+
+        for (auto y = rowBegin_; y < rowEnd_; y++) {
+            // Source rows covered by this pixel
+            auto y0 = (int)((long long)y * srcHeight_ / dstHeight_);
+            auto y1 = std::max(y0 + 1, (int)((long long)(y + 1) * srcHeight_ / dstHeight_));
+            auto out = dst_ + y * dstWidth_ * channels_;
+
+            for (auto x = 0; x < dstWidth_; x++) {
+                // Source columns covered by this pixel
+                auto x0 = (int)((long long)x * srcWidth_ / dstWidth_);
+                auto x1 = std::max(x0 + 1, (int)((long long)(x + 1) * srcWidth_ / dstWidth_));
+                auto count = (x1 - x0) * (y1 - y0);
+
+                unsigned int sum[4] = {0, 0, 0, 0};
+                for (auto sy = y0; sy < y1; sy++) {
+                    auto in = src_ + sy * srcStride + x0 * channels_;
+                    for (auto sx = 0; sx < (x1 - x0) * channels_; sx += channels_) {
+                        for (auto c = 0; c < channels_; c++)
+                            sum[c] += in[sx + c];
+                    }
+                }
+
+                for (auto c = 0; c < channels_; c++)
+                    out[x * channels_ + c] = (unsigned char)((sum[c] + count / 2) / count);
+            }
+        }
+    }
+}
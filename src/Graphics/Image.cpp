@@ -13,6 +13,26 @@
 
 #include <stb_image.h>
 
+#include <climits>
+
+// QOI format
+#define QOI_HEADER_SIZE 14
+#define QOI_OP_INDEX 0x00
+#define QOI_OP_DIFF 0x40
+#define QOI_OP_LUMA 0x80
+#define QOI_OP_RUN 0xc0
+#define QOI_OP_RGB 0xfe
+#define QOI_OP_RGBA 0xff
+#define QOI_MASK_2 0xc0
+#define QOI_HASH(px) ((px[0]*3 + px[1]*5 + px[2]*7 + px[3]*11) % 64)
+
+// Largest width or height read from an image file
+#define IMAGE_MAX_DIMENSION 16384
+
+// Native image format
+#define NATIVE_IMAGE_HEADER_SIZE 32
+#define NATIVE_IMAGE_VERSION 1
+
 namespace NerdThings::Ngine::Graphics {
     // Public Constructors
 
@@ -22,45 +42,57 @@ namespace NerdThings::Ngine::Graphics {
         // Check format
         auto ext = path_.GetFileExtension();
 
-        if (ext == "png"
-            || ext == "bmp"
-            || ext == "tga"
-            || ext == "jpg"
-            || ext == "gif"
-            || ext == "pic"
-            || ext == "psd") {
-            // Open file
-            auto file = Filesystem::File(path_);
-            file.Open(Filesystem::MODE_READ, true);
+        try {
+            if (ext == "png"
+                || ext == "bmp"
+                || ext == "tga"
+                || ext == "jpg"
+                || ext == "gif"
+                || ext == "pic"
+                || ext == "psd") {
+                // Map file, stb_image decodes straight from it
+                auto file = Filesystem::File(path_).Map();
 
-            // Load data
-            int width = 0, height = 0, bpp = 0;
-            // TODO: One day: Work out why these cause havoc with the renderer
-            //stbi_set_flip_vertically_on_load(true);
-            auto data = stbi_load_from_file(file.GetFileHandle(), &width, &height, &bpp, 4);;
-            //stbi_set_flip_vertically_on_load(false);
+                // Load data
+                int width = 0, height = 0, bpp = 0;
+                // TODO: One day: Work out why these cause havoc with the renderer
+                //stbi_set_flip_vertically_on_load(true);
+                auto data = stbi_load_from_memory(file->GetData(), file->GetSize(), &width, &height, &bpp, 4);
+                //stbi_set_flip_vertically_on_load(false);
 
-            // Load image
-            *this = Image(data, width, height, UNCOMPRESSED_R8G8B8A8);
+                // Adopt the decoded pixels, stb_image allocates with malloc like we do
+                if (data != nullptr) {
+                    PixelData = data;
+                    Width = width;
+                    Height = height;
+                    Format = UNCOMPRESSED_R8G8B8A8;
+                    Mipmaps = 1;
+                }
+            } else if (ext == "qoi") {
+                // Map file and decode
+                __LoadQOI(*Filesystem::File(path_).Map());
+            } else if (ext == "nimg" || ext == "dds" || ext == "ktx") {
+                // Open file, the pixel data is read straight into the chain
+                auto file = Filesystem::FileReader(path_);
 
-            // Close file
-            stbi_image_free(data);
-            file.Close();
+                // Load image and mipmaps
+                if (ext == "nimg") __LoadNative(file);
+                else if (ext == "dds") __LoadDDS(file);
+                else __LoadKTX(file);
+            }
+        } catch (std::runtime_error &e) {
+            ConsoleMessage("Unable to open image file: " + std::string(e.what()), "ERR", "Image");
         }
     }
 
     Image::Image(unsigned char *pixelData_, int width_, int height_, PixelFormat format_) {
-        // Bits per pixel
-        int bpp = 0;
-        if (format_ == UNCOMPRESSED_GRAYSCALE) bpp = 1;
-        else if (format_ == UNCOMPRESSED_GRAY_ALPHA) bpp = 2;
-        else if (format_ == UNCOMPRESSED_R8G8B8) bpp = 3;
-        else if (format_ == UNCOMPRESSED_R8G8B8A8) bpp = 4;
-        else throw std::runtime_error("Incompatible format.");
+        // Get data size
+        auto dataSize = GetPixelDataSize(width_, height_, format_);
+        if (dataSize <= 0) throw std::runtime_error("Incompatible format.");
 
         // Copy pixel data
-        PixelData = new unsigned char[width_*height_*bpp];
-        memcpy(PixelData, pixelData_, width_*height_*sizeof(unsigned char)*bpp);
+        PixelData = (unsigned char *)malloc(dataSize);
+        memcpy(PixelData, pixelData_, dataSize);
 
         // Set fields
         Width = width_;
@@ -71,6 +103,211 @@ namespace NerdThings::Ngine::Graphics {
 
     // Public Methods
 
+    bool Image::Decompress() {
+        if (!IsValid()) return false;
+        if (!IsCompressed()) return true;
+
+        // Get block size
+        int blockSize;
+        switch (Format) {
+            case COMPRESSED_DXT1_RGB:
+            case COMPRESSED_DXT1_RGBA:
+            case COMPRESSED_ETC1_RGB:
+            case COMPRESSED_ETC2_RGB: blockSize = 8; break;
+            case COMPRESSED_DXT3_RGBA:
+            case COMPRESSED_DXT5_RGBA:
+            case COMPRESSED_ETC2_EAC_RGBA: blockSize = 16; break;
+            default:
+                ConsoleMessage("Unable to decompress PVRT or ASTC images.", "WARN", "Image");
+                return false;
+        }
+
+        // Allocate RGBA8 chain
+        auto totalSize = 0;
+        auto mipWidth = Width;
+        auto mipHeight = Height;
+        for (auto i = 0; i < Mipmaps; i++) {
+            totalSize += mipWidth * mipHeight * 4;
+            mipWidth = mipWidth > 1 ? mipWidth / 2 : 1;
+            mipHeight = mipHeight > 1 ? mipHeight / 2 : 1;
+        }
+
+        auto decompressed = (unsigned char *)malloc(totalSize);
+        auto src = PixelData;
+        auto dst = decompressed;
+        mipWidth = Width;
+        mipHeight = Height;
+
+        for (auto i = 0; i < Mipmaps; i++) {
+            auto blocksX = (mipWidth + 3) / 4;
+            auto blocksY = (mipHeight + 3) / 4;
+
+            for (auto by = 0; by < blocksY; by++) {
+                for (auto bx = 0; bx < blocksX; bx++) {
+                    unsigned char pixels[16 * 4];
+
+                    // Decode block
+                    switch (Format) {
+                        case COMPRESSED_DXT1_RGB:
+                        case COMPRESSED_DXT1_RGBA:
+                            __DecodeDXTColorBlock(src, pixels, Format);
+                            break;
+                        case COMPRESSED_DXT3_RGBA:
+                            __DecodeDXTColorBlock(src + 8, pixels, Format);
+                            for (auto p = 0; p < 16; p++) {
+                                auto alpha = (src[p / 2] >> ((p % 2) * 4)) & 15;
+                                pixels[p * 4 + 3] = (unsigned char)((alpha << 4) | alpha);
+                            }
+                            break;
+                        case COMPRESSED_DXT5_RGBA: {
+                            __DecodeDXTColorBlock(src + 8, pixels, Format);
+
+                            // Alpha palette
+                            int alphas[8] = {src[0], src[1]};
+                            if (alphas[0] > alphas[1]) {
+                                for (auto a = 1; a < 7; a++) alphas[a + 1] = ((7 - a) * alphas[0] + a * alphas[1]) / 7;
+                            } else {
+                                for (auto a = 1; a < 5; a++) alphas[a + 1] = ((5 - a) * alphas[0] + a * alphas[1]) / 5;
+                                alphas[6] = 0;
+                                alphas[7] = 255;
+                            }
+
+                            unsigned long long indices = 0;
+                            for (auto b = 7; b >= 2; b--) indices = (indices << 8) | src[b];
+                            for (auto p = 0; p < 16; p++) pixels[p * 4 + 3] = (unsigned char)alphas[(indices >> (p * 3)) & 7];
+                        } break;
+                        case COMPRESSED_ETC1_RGB:
+                        case COMPRESSED_ETC2_RGB:
+                            __DecodeETCBlock(src, pixels);
+                            break;
+                        case COMPRESSED_ETC2_EAC_RGBA:
+                            __DecodeETCBlock(src + 8, pixels);
+                            __DecodeEACAlphaBlock(src, pixels);
+                            break;
+                        default: break;
+                    }
+
+                    // Copy visible pixels
+                    for (auto y = 0; y < 4 && by * 4 + y < mipHeight; y++) {
+                        auto w = mipWidth - bx * 4 < 4 ? mipWidth - bx * 4 : 4;
+                        memcpy(dst + ((by * 4 + y) * mipWidth + bx * 4) * 4, pixels + y * 16, w * 4);
+                    }
+
+                    src += blockSize;
+                }
+            }
+
+            dst += mipWidth * mipHeight * 4;
+            mipWidth = mipWidth > 1 ? mipWidth / 2 : 1;
+            mipHeight = mipHeight > 1 ? mipHeight / 2 : 1;
+        }
+
+        // Replace pixel data
+        free(PixelData);
+        PixelData = decompressed;
+        Format = UNCOMPRESSED_R8G8B8A8;
+        return true;
+    }
+
+    bool Image::Export(const Filesystem::Path &path_) const {
+        if (!IsValid()) return false;
+
+        // Check format
+        auto ext = path_.GetFileExtension();
+        if (ext != "qoi" && ext != "nimg") {
+            ConsoleMessage("Images can only be exported as qoi or nimg.", "ERR", "Image");
+            return false;
+        }
+
+        // Open file
+        auto file = Filesystem::File(path_);
+        if (!file.Open(Filesystem::MODE_WRITE, true)) return false;
+
+        // Write image
+        auto success = ext == "qoi" ? __SaveQOI(file) : __SaveNative(file);
+
+        // Close file
+        file.Close();
+        return success;
+    }
+
+    void Image::GenerateMipmaps() {
+        if (!IsValid()) return;
+
+        // Get channel count
+        auto channels = __GetChannelCount(Format);
+        if (channels == 0) {
+            ConsoleMessage("Mipmaps can only be generated for uncompressed 8-bit formats.", "WARN", "Image");
+            return;
+        }
+
+        // Count levels and total size
+        auto mipCount = 1;
+        auto mipWidth = Width;
+        auto mipHeight = Height;
+        auto baseSize = GetPixelDataSize(Width, Height, Format);
+        auto dataSize = baseSize;
+
+        while (mipWidth > 1 || mipHeight > 1) {
+            mipWidth = mipWidth > 1 ? mipWidth / 2 : 1;
+            mipHeight = mipHeight > 1 ? mipHeight / 2 : 1;
+            dataSize += GetPixelDataSize(mipWidth, mipHeight, Format);
+            mipCount++;
+        }
+
+        // Already generated
+        if (Mipmaps == mipCount) return;
+
+        // Allocate the chain, keeping the base level
+        auto chain = (unsigned char *)malloc(dataSize);
+        memcpy(chain, PixelData, baseSize);
+
+        // Build each level from the last
+        auto src = chain;
+        mipWidth = Width;
+        mipHeight = Height;
+
+        for (auto i = 1; i < mipCount; i++) {
+            auto dst = src + GetPixelDataSize(mipWidth, mipHeight, Format);
+            auto dstWidth = mipWidth > 1 ? mipWidth / 2 : 1;
+            auto dstHeight = mipHeight > 1 ? mipHeight / 2 : 1;
+            __ForEachRow(dstHeight, dstWidth, [&](int begin_, int end_) {
+                __DownsampleBox(src, mipWidth, mipHeight, dst, channels, begin_, end_);
+            });
+
+            src = dst;
+            mipWidth = mipWidth > 1 ? mipWidth / 2 : 1;
+            mipHeight = mipHeight > 1 ? mipHeight / 2 : 1;
+        }
+
+        // Replace pixel data
+        free(PixelData);
+        PixelData = chain;
+        Mipmaps = mipCount;
+    }
+
+    int Image::GetDataSize() const {
+        auto dataSize = 0;
+        auto mipWidth = Width;
+        auto mipHeight = Height;
+
+        for (auto i = 0; i < Mipmaps; i++) {
+            dataSize += GetPixelDataSize(mipWidth, mipHeight, Format);
+            mipWidth = mipWidth > 1 ? mipWidth / 2 : 1;
+            mipHeight = mipHeight > 1 ? mipHeight / 2 : 1;
+        }
+
+        return dataSize;
+    }
+
+    int Image::GetPixelDataSize(int width_, int height_, PixelFormat format_) {
+        return (int)__GetPixelDataSize64(width_, height_, format_);
+    }
+
+    bool Image::IsCompressed() const {
+        return Format >= COMPRESSED_DXT1_RGB;
+    }
+
     bool Image::IsValid() const {
         return Width > 0
                 && Height > 0
@@ -90,9 +327,664 @@ namespace NerdThings::Ngine::Graphics {
         Format = UNCOMPRESSED_GRAYSCALE;
         Height = 0;
         Mipmaps = 0;
-        delete[] PixelData;
+        free(PixelData);
         PixelData = nullptr;
         Width = 0;
     }
 
-}
\ No newline at end of file
+    // Private Methods
+
+    void Image::__DecodeDXTColorBlock(const unsigned char *block_, unsigned char *out_, PixelFormat format_) {
+        // Endpoints (RGB565)
+        unsigned int c0 = block_[0] | (block_[1] << 8);
+        unsigned int c1 = block_[2] | (block_[3] << 8);
+
+        unsigned char palette[4][4];
+        for (auto i = 0; i < 2; i++) {
+            auto c = i == 0 ? c0 : c1;
+            auto r = (c >> 11) & 31, g = (c >> 5) & 63, b = c & 31;
+            palette[i][0] = (unsigned char)((r << 3) | (r >> 2));
+            palette[i][1] = (unsigned char)((g << 2) | (g >> 4));
+            palette[i][2] = (unsigned char)((b << 3) | (b >> 2));
+            palette[i][3] = 255;
+        }
+
+        // Interpolated colors, DXT1 picks the mode with the endpoint order
+        auto fourColors = c0 > c1 || (format_ != COMPRESSED_DXT1_RGB && format_ != COMPRESSED_DXT1_RGBA);
+        for (auto c = 0; c < 3; c++) {
+            if (fourColors) {
+                palette[2][c] = (unsigned char)((2 * palette[0][c] + palette[1][c]) / 3);
+                palette[3][c] = (unsigned char)((palette[0][c] + 2 * palette[1][c]) / 3);
+            } else {
+                palette[2][c] = (unsigned char)((palette[0][c] + palette[1][c]) / 2);
+                palette[3][c] = 0;
+            }
+        }
+        palette[2][3] = 255;
+
+        // Only DXT1 with alpha makes the black entry transparent
+        palette[3][3] = (fourColors || format_ != COMPRESSED_DXT1_RGBA) ? 255 : 0;
+
+        // Indices, 2 bits per pixel in row order
+        unsigned int indices = block_[4] | (block_[5] << 8) | (block_[6] << 16) | ((unsigned int)block_[7] << 24);
+        for (auto i = 0; i < 16; i++)
+            memcpy(out_ + i * 4, palette[(indices >> (i * 2)) & 3], 4);
+    }
+
+    void Image::__DecodeEACAlphaBlock(const unsigned char *block_, unsigned char *out_) {
+        static const int modifiers[16][8] = {
+                {-3, -6, -9, -15, 2, 5, 8, 14},
+                {-3, -7, -10, -13, 2, 6, 9, 12},
+                {-2, -5, -8, -13, 1, 4, 7, 12},
+                {-2, -4, -6, -13, 1, 3, 5, 12},
+                {-3, -6, -8, -12, 2, 5, 7, 11},
+                {-3, -7, -9, -11, 2, 6, 8, 10},
+                {-4, -7, -8, -11, 3, 6, 7, 10},
+                {-3, -5, -8, -11, 2, 4, 7, 10},
+                {-2, -6, -8, -10, 1, 5, 7, 9},
+                {-2, -5, -8, -10, 1, 4, 7, 9},
+                {-2, -4, -8, -10, 1, 3, 7, 9},
+                {-2, -5, -7, -10, 1, 4, 6, 9},
+                {-3, -4, -7, -10, 2, 3, 6, 9},
+                {-1, -2, -3, -10, 0, 1, 2, 9},
+                {-4, -6, -8, -9, 3, 5, 7, 8},
+                {-3, -5, -7, -9, 2, 4, 6, 8}
+        };
+
+        auto base = (int)block_[0];
+        auto multiplier = block_[1] >> 4;
+        auto table = modifiers[block_[1] & 15];
+
+        // 3 bit indices, pixels in column order
+        unsigned long long indices = 0;
+        for (auto i = 2; i < 8; i++) indices = (indices << 8) | block_[i];
+
+        for (auto i = 0; i < 16; i++) {
+            auto x = i / 4, y = i % 4;
+            auto alpha = base + table[(indices >> (45 - i * 3)) & 7] * multiplier;
+            out_[(y * 4 + x) * 4 + 3] = (unsigned char)(alpha < 0 ? 0 : (alpha > 255 ? 255 : alpha));
+        }
+    }
+
+    void Image::__DecodeETCBlock(const unsigned char *block_, unsigned char *out_) {
+        static const int modifiers[8][4] = {
+                {2, 8, -2, -8}, {5, 17, -5, -17}, {9, 29, -9, -29}, {13, 42, -13, -42},
+                {18, 60, -18, -60}, {24, 80, -24, -80}, {33, 106, -33, -106}, {47, 183, -47, -183}
+        };
+        static const int distances[8] = {3, 6, 11, 16, 23, 32, 41, 64};
+
+        auto clamp = [](int v_) { return (unsigned char)(v_ < 0 ? 0 : (v_ > 255 ? 255 : v_)); };
+        auto extend4 = [](int v_) { return (v_ << 4) | v_; };
+        auto extend5 = [](int v_) { return (v_ << 3) | (v_ >> 2); };
+        auto extend6 = [](int v_) { return (v_ << 2) | (v_ >> 4); };
+        auto extend7 = [](int v_) { return (v_ << 1) | (v_ >> 6); };
+
+        const unsigned char *b = block_;
+        auto indices = ((unsigned int)b[4] << 24) | (b[5] << 16) | (b[6] << 8) | b[7];
+        auto diff = (b[3] & 2) != 0;
+        auto flip = (b[3] & 1) != 0;
+
+        int base[2][3];
+        int paint[4][3];
+        auto paintMode = false;
+
+        if (!diff) {
+            // Individual mode
+            base[0][0] = extend4(b[0] >> 4); base[1][0] = extend4(b[0] & 15);
+            base[0][1] = extend4(b[1] >> 4); base[1][1] = extend4(b[1] & 15);
+            base[0][2] = extend4(b[2] >> 4); base[1][2] = extend4(b[2] & 15);
+        } else {
+            // Differential mode, overflow selects the ETC2 modes
+            int c1[3], c2[3];
+            for (auto c = 0; c < 3; c++) {
+                c1[c] = b[c] >> 3;
+                auto delta = b[c] & 7;
+                c2[c] = c1[c] + (delta >= 4 ? delta - 8 : delta);
+            }
+
+            if (c2[0] < 0 || c2[0] > 31) {
+                // T mode
+                int t1[3] = {extend4(((b[0] & 0x18) >> 1) | (b[0] & 3)), extend4(b[1] >> 4), extend4(b[1] & 15)};
+                int t2[3] = {extend4(b[2] >> 4), extend4(b[2] & 15), extend4(b[3] >> 4)};
+                auto d = distances[(((b[3] >> 2) & 3) << 1) | (b[3] & 1)];
+
+                for (auto c = 0; c < 3; c++) {
+                    paint[0][c] = t1[c];
+                    paint[1][c] = t2[c] + d;
+                    paint[2][c] = t2[c];
+                    paint[3][c] = t2[c] - d;
+                }
+                paintMode = true;
+            } else if (c2[1] < 0 || c2[1] > 31) {
+                // H mode
+                int h1[3] = {extend4((b[0] >> 3) & 15), extend4(((b[0] & 7) << 1) | ((b[1] >> 4) & 1)),
+                             extend4((b[1] & 8) | ((b[1] & 3) << 1) | (b[2] >> 7))};
+                int h2[3] = {extend4((b[2] >> 3) & 15), extend4(((b[2] & 7) << 1) | (b[3] >> 7)), extend4((b[3] >> 3) & 15)};
+                auto v1 = (h1[0] << 16) | (h1[1] << 8) | h1[2];
+                auto v2 = (h2[0] << 16) | (h2[1] << 8) | h2[2];
+                auto d = distances[(b[3] & 4) | ((b[3] & 1) << 1) | (v1 >= v2 ? 1 : 0)];
+
+                for (auto c = 0; c < 3; c++) {
+                    paint[0][c] = h1[c] + d;
+                    paint[1][c] = h1[c] - d;
+                    paint[2][c] = h2[c] + d;
+                    paint[3][c] = h2[c] - d;
+                }
+                paintMode = true;
+            } else if (c2[2] < 0 || c2[2] > 31) {
+                // Planar mode
+                int o[3] = {extend6((b[0] >> 1) & 63), extend7(((b[0] & 1) << 6) | ((b[1] >> 1) & 63)),
+                            extend6(((b[1] & 1) << 5) | (b[2] & 0x18) | ((b[2] & 3) << 1) | (b[3] >> 7))};
+                int h[3] = {extend6(((b[3] >> 1) & 0x3E) | (b[3] & 1)), extend7(b[4] >> 1), extend6(((b[4] & 1) << 5) | (b[5] >> 3))};
+                int v[3] = {extend6(((b[5] & 7) << 3) | (b[6] >> 5)), extend7(((b[6] & 31) << 2) | (b[7] >> 6)), extend6(b[7] & 63)};
+
+                for (auto y = 0; y < 4; y++) {
+                    for (auto x = 0; x < 4; x++) {
+                        auto out = out_ + (y * 4 + x) * 4;
+                        for (auto c = 0; c < 3; c++)
+                            out[c] = clamp((x * (h[c] - o[c]) + y * (v[c] - o[c]) + 4 * o[c] + 2) >> 2);
+                        out[3] = 255;
+                    }
+                }
+                return;
+            } else {
+                for (auto c = 0; c < 3; c++) {
+                    base[0][c] = extend5(c1[c]);
+                    base[1][c] = extend5(c2[c]);
+                }
+            }
+        }
+
+        // Write pixels, indices are in column order
+        for (auto i = 0; i < 16; i++) {
+            auto x = i / 4, y = i % 4;
+            auto index = (((indices >> (16 + i)) & 1) << 1) | ((indices >> i) & 1);
+            auto out = out_ + (y * 4 + x) * 4;
+
+            if (paintMode) {
+                for (auto c = 0; c < 3; c++) out[c] = clamp(paint[index][c]);
+            } else {
+                auto sub = flip ? (y >= 2) : (x >= 2);
+                auto modifier = modifiers[(b[3] >> (sub ? 2 : 5)) & 7][index];
+                for (auto c = 0; c < 3; c++) out[c] = clamp(base[sub][c] + modifier);
+            }
+            out[3] = 255;
+        }
+    }
+
+    unsigned long long Image::__GetPixelDataSize64(int width_, int height_, PixelFormat format_) {
+        auto bpp = 0;
+
+        switch (format_)
+        {
+            case UNCOMPRESSED_GRAYSCALE: bpp = 8; break;
+            case UNCOMPRESSED_GRAY_ALPHA:
+            case UNCOMPRESSED_R5G6B5:
+            case UNCOMPRESSED_R5G5B5A1:
+            case UNCOMPRESSED_R4G4B4A4: bpp = 16; break;
+            case UNCOMPRESSED_R8G8B8A8: bpp = 32; break;
+            case UNCOMPRESSED_R8G8B8: bpp = 24; break;
+            case UNCOMPRESSED_R32: bpp = 32; break;
+            case UNCOMPRESSED_R32G32B32: bpp = 32*3; break;
+            case UNCOMPRESSED_R32G32B32A32: bpp = 32*4; break;
+            case COMPRESSED_DXT1_RGB:
+            case COMPRESSED_DXT1_RGBA:
+            case COMPRESSED_ETC1_RGB:
+            case COMPRESSED_ETC2_RGB:
+            case COMPRESSED_PVRT_RGB:
+            case COMPRESSED_PVRT_RGBA: bpp = 4; break;
+            case COMPRESSED_DXT3_RGBA:
+            case COMPRESSED_DXT5_RGBA:
+            case COMPRESSED_ETC2_EAC_RGBA:
+            case COMPRESSED_ASTC_4x4_RGBA: bpp = 8; break;
+            case COMPRESSED_ASTC_8x8_RGBA: bpp = 2; break;
+            default: break;
+        }
+
+        auto dataSize = (unsigned long long)width_*height_*bpp/8;  // Total data size in bytes
+
+        // Compressed formats are stored in whole blocks, partial blocks at the edges are padded
+        if (format_ == COMPRESSED_ASTC_8x8_RGBA)
+            dataSize = (unsigned long long)((width_ + 7)/8)*((height_ + 7)/8)*16;
+        else if (format_ == COMPRESSED_PVRT_RGB || format_ == COMPRESSED_PVRT_RGBA)
+            dataSize = (unsigned long long)(width_ < 8 ? 8 : width_)*(height_ < 8 ? 8 : height_)*bpp/8;
+        else if (format_ >= COMPRESSED_DXT1_RGB)
+            dataSize = (unsigned long long)((width_ + 3)/4)*((height_ + 3)/4)*(bpp*2);
+
+        return dataSize;
+    }
+
+    bool Image::__IsValidSize(int width_, int height_, int mipmaps_, PixelFormat format_) {
+        if (width_ < 1 || height_ < 1 || width_ > IMAGE_MAX_DIMENSION || height_ > IMAGE_MAX_DIMENSION) return false;
+
+        // A chain ends at 1x1
+        auto maxMipmaps = 1;
+        for (auto dim = width_ > height_ ? width_ : height_; dim > 1; dim /= 2) maxMipmaps++;
+        if (mipmaps_ < 1 || mipmaps_ > maxMipmaps) return false;
+
+        // Sizes are ints, so the whole chain must fit in one
+        unsigned long long dataSize = 0;
+        for (auto i = 0; i < mipmaps_; i++) {
+            dataSize += __GetPixelDataSize64(width_, height_, format_);
+            width_ = width_ > 1 ? width_ / 2 : 1;
+            height_ = height_ > 1 ? height_ / 2 : 1;
+        }
+
+        return dataSize > 0 && dataSize <= INT_MAX;
+    }
+
+    bool Image::__LoadDDS(Filesystem::FileReader &file_) {
+        // Read magic and header (31 dwords)
+        unsigned int header[32];
+        if (file_.Read(header, sizeof(header)) != sizeof(header) || memcmp(header, "DDS ", 4) != 0) {
+            ConsoleMessage("File is not a valid DDS file.", "ERR", "Image");
+            return false;
+        }
+
+        auto flags = header[2];
+        auto height = (int)header[3];
+        auto width = (int)header[4];
+        auto mipmaps = (flags & 0x20000) && header[7] > 0 ? (int)header[7] : 1;
+
+        // Pixel format
+        auto pfFlags = header[20];
+        auto fourCC = (const char *)&header[21];
+        auto bitCount = header[22];
+        auto redMask = header[23];
+        auto alphaMask = header[26];
+
+        PixelFormat format;
+        if (pfFlags & 0x4) {
+            if (memcmp(fourCC, "DXT1", 4) == 0) format = (pfFlags & 0x1) ? COMPRESSED_DXT1_RGBA : COMPRESSED_DXT1_RGB;
+            else if (memcmp(fourCC, "DXT3", 4) == 0) format = COMPRESSED_DXT3_RGBA;
+            else if (memcmp(fourCC, "DXT5", 4) == 0) format = COMPRESSED_DXT5_RGBA;
+            else {
+                ConsoleMessage("Unsupported DDS compression format.", "ERR", "Image");
+                return false;
+            }
+        } else if ((pfFlags & 0x40) && bitCount == 32) format = UNCOMPRESSED_R8G8B8A8;
+        else if ((pfFlags & 0x40) && bitCount == 24) format = UNCOMPRESSED_R8G8B8;
+        else {
+            ConsoleMessage("Unsupported DDS pixel format.", "ERR", "Image");
+            return false;
+        }
+
+        if (!__IsValidSize(width, height, mipmaps, format)) {
+            ConsoleMessage("DDS header is invalid.", "ERR", "Image");
+            return false;
+        }
+
+        // Read the whole chain straight into the pixel buffer, DDS stores levels in our layout
+        Width = width;
+        Height = height;
+        Format = format;
+        Mipmaps = mipmaps;
+
+        auto dataSize = GetDataSize();
+        PixelData = (unsigned char *)malloc(dataSize);
+        if (PixelData == nullptr) {
+            ConsoleMessage("Failed to allocate memory for DDS image.", "ERR", "Image");
+            Unload();
+            return false;
+        }
+
+        if (file_.Read(PixelData, dataSize) != dataSize) {
+            ConsoleMessage("DDS file is truncated.", "ERR", "Image");
+            Unload();
+            return false;
+        }
+
+        // Swizzle BGR(A) to RGB(A)
+        if (format == UNCOMPRESSED_R8G8B8A8 || format == UNCOMPRESSED_R8G8B8) {
+            auto bpp = format == UNCOMPRESSED_R8G8B8A8 ? 4 : 3;
+            auto swap = redMask == 0x00FF0000;
+            auto opaque = format == UNCOMPRESSED_R8G8B8A8 && (!(pfFlags & 0x1) || alphaMask == 0);
+
+            if (swap || opaque) {
+                for (auto i = 0; i + bpp <= dataSize; i += bpp) {
+                    if (swap) std::swap(PixelData[i], PixelData[i + 2]);
+                    if (opaque) PixelData[i + 3] = 255;
+                }
+            }
+        }
+
+        return true;
+    }
+
+    bool Image::__LoadKTX(Filesystem::FileReader &file_) {
+        // Read identifier and header
+        static const unsigned char identifier[12] = {0xAB, 'K', 'T', 'X', ' ', '1', '1', 0xBB, '\r', '\n', 0x1A, '\n'};
+        unsigned char fileIdentifier[12];
+        unsigned int header[13];
+
+        if (file_.Read(fileIdentifier, 12) != 12 || memcmp(fileIdentifier, identifier, 12) != 0
+            || file_.Read(header, sizeof(header)) != sizeof(header)) {
+            ConsoleMessage("File is not a valid KTX file.", "ERR", "Image");
+            return false;
+        }
+
+        if (header[0] != 0x04030201) {
+            ConsoleMessage("Big endian KTX files are not supported.", "ERR", "Image");
+            return false;
+        }
+
+        auto glInternalFormat = header[4];
+        auto width = (int)header[6];
+        auto height = (int)header[7];
+        auto mipmaps = header[11] > 0 ? (int)header[11] : 1;
+
+        if (header[8] > 1 || header[9] > 0 || header[10] > 1) {
+            ConsoleMessage("Only 2D KTX textures are supported.", "ERR", "Image");
+            return false;
+        }
+
+        // Map the GL internal format
+        PixelFormat format;
+        switch (glInternalFormat) {
+            case 0x8D64: format = COMPRESSED_ETC1_RGB; break;           // GL_ETC1_RGB8_OES
+            case 0x9274: format = COMPRESSED_ETC2_RGB; break;           // GL_COMPRESSED_RGB8_ETC2
+            case 0x9278: format = COMPRESSED_ETC2_EAC_RGBA; break;      // GL_COMPRESSED_RGBA8_ETC2_EAC
+            case 0x83F0: format = COMPRESSED_DXT1_RGB; break;           // GL_COMPRESSED_RGB_S3TC_DXT1_EXT
+            case 0x83F1: format = COMPRESSED_DXT1_RGBA; break;          // GL_COMPRESSED_RGBA_S3TC_DXT1_EXT
+            case 0x83F2: format = COMPRESSED_DXT3_RGBA; break;          // GL_COMPRESSED_RGBA_S3TC_DXT3_EXT
+            case 0x83F3: format = COMPRESSED_DXT5_RGBA; break;          // GL_COMPRESSED_RGBA_S3TC_DXT5_EXT
+            case 0x8C00: format = COMPRESSED_PVRT_RGB; break;           // GL_COMPRESSED_RGB_PVRTC_4BPPV1_IMG
+            case 0x8C02: format = COMPRESSED_PVRT_RGBA; break;          // GL_COMPRESSED_RGBA_PVRTC_4BPPV1_IMG
+            case 0x93B0: format = COMPRESSED_ASTC_4x4_RGBA; break;      // GL_COMPRESSED_RGBA_ASTC_4x4_KHR
+            case 0x93B7: format = COMPRESSED_ASTC_8x8_RGBA; break;      // GL_COMPRESSED_RGBA_ASTC_8x8_KHR
+            case 0x1908:                                                // GL_RGBA
+            case 0x8058: format = UNCOMPRESSED_R8G8B8A8; break;         // GL_RGBA8
+            case 0x1907:                                                // GL_RGB
+            case 0x8051: format = UNCOMPRESSED_R8G8B8; break;           // GL_RGB8
+            default:
+                ConsoleMessage("Unsupported KTX internal format.", "ERR", "Image");
+                return false;
+        }
+
+        // Skip key/value data
+        file_.Skip(header[12]);
+
+        if (!__IsValidSize(width, height, mipmaps, format)) {
+            ConsoleMessage("KTX header is invalid.", "ERR", "Image");
+            return false;
+        }
+
+        // Read each level straight into the chain
+        Width = width;
+        Height = height;
+        Format = format;
+        Mipmaps = mipmaps;
+        PixelData = (unsigned char *)malloc(GetDataSize());
+        if (PixelData == nullptr) {
+            ConsoleMessage("Failed to allocate memory for KTX image.", "ERR", "Image");
+            Unload();
+            return false;
+        }
+
+        auto mipWidth = width;
+        auto mipHeight = height;
+        auto mipOffset = 0;
+
+        for (auto i = 0; i < mipmaps; i++) {
+            auto mipSize = GetPixelDataSize(mipWidth, mipHeight, format);
+            unsigned int imageSize = 0;
+
+            if (file_.Read(&imageSize, sizeof(unsigned int)) != sizeof(unsigned int)) {
+                ConsoleMessage("KTX file is truncated.", "ERR", "Image");
+                Unload();
+                return false;
+            }
+
+            auto rowSize = GetPixelDataSize(mipWidth, 1, format);
+            auto paddedRowSize = (rowSize + 3) & ~3;
+            auto read = true;
+
+            if (imageSize == (unsigned int)mipSize) {
+                read = file_.Read(PixelData + mipOffset, mipSize) == mipSize;
+            } else if (!IsCompressed() && imageSize == (unsigned int)(paddedRowSize * mipHeight)) {
+                // Uncompressed rows are padded to 4 bytes
+                for (auto y = 0; y < mipHeight && read; y++) {
+                    read = file_.Read(PixelData + mipOffset + y * rowSize, rowSize) == rowSize;
+                    file_.Skip(paddedRowSize - rowSize);
+                }
+            } else read = false;
+
+            if (!read) {
+                ConsoleMessage("KTX mipmap data is invalid.", "ERR", "Image");
+                Unload();
+                return false;
+            }
+
+            // Skip mip padding
+            file_.Skip(3 - ((imageSize + 3) % 4));
+
+            mipOffset += mipSize;
+            mipWidth = mipWidth > 1 ? mipWidth / 2 : 1;
+            mipHeight = mipHeight > 1 ? mipHeight / 2 : 1;
+        }
+
+        return true;
+    }
+
+    bool Image::__LoadNative(Filesystem::FileReader &file_) {
+        // Read header
+        unsigned int header[NATIVE_IMAGE_HEADER_SIZE / sizeof(unsigned int)];
+        if (file_.Read(header, NATIVE_IMAGE_HEADER_SIZE) != NATIVE_IMAGE_HEADER_SIZE
+            || memcmp(header, "NIMG", 4) != 0) {
+            ConsoleMessage("File is not a valid native image.", "ERR", "Image");
+            return false;
+        }
+
+        if (header[1] != NATIVE_IMAGE_VERSION) {
+            ConsoleMessage("Native image version " + std::to_string(header[1]) + " is not supported.", "ERR", "Image");
+            return false;
+        }
+
+        Width = (int)header[2];
+        Height = (int)header[3];
+        Format = (PixelFormat)header[4];
+        Mipmaps = (int)header[5];
+
+        // Check the data matches the header
+        auto dataSize = GetDataSize();
+        if (dataSize <= 0 || (unsigned int)dataSize != header[6]) {
+            ConsoleMessage("Native image header is invalid.", "ERR", "Image");
+            Width = Height = Mipmaps = 0;
+            return false;
+        }
+
+        // Read the chain straight into the pixel buffer
+        PixelData = (unsigned char *)malloc(dataSize);
+        if (file_.Read(PixelData, dataSize) != dataSize) {
+            ConsoleMessage("Native image is truncated.", "ERR", "Image");
+            Unload();
+            return false;
+        }
+
+        return true;
+    }
+
+    bool Image::__LoadQOI(const Filesystem::FileMapping &file_) {
+        auto size = file_.GetSize();
+        if (size < QOI_HEADER_SIZE + 8) {
+            ConsoleMessage("File is not a valid QOI image.", "ERR", "Image");
+            return false;
+        }
+
+        auto data = file_.GetData();
+
+        if (memcmp(data, "qoif", 4) != 0) {
+            ConsoleMessage("File is not a valid QOI image.", "ERR", "Image");
+            return false;
+        }
+
+        auto width = (int)(((unsigned int)data[4] << 24) | (data[5] << 16) | (data[6] << 8) | data[7]);
+        auto height = (int)(((unsigned int)data[8] << 24) | (data[9] << 16) | (data[10] << 8) | data[11]);
+        auto channels = (int)data[12];
+
+        if ((channels != 3 && channels != 4) || !__IsValidSize(width, height, 1, channels == 4 ? UNCOMPRESSED_R8G8B8A8 : UNCOMPRESSED_R8G8B8)) {
+            ConsoleMessage("QOI image header is invalid.", "ERR", "Image");
+            return false;
+        }
+
+        // Decode straight into the pixel buffer
+        auto pixelCount = width * height;
+        auto out = (unsigned char *)malloc((size_t)pixelCount * channels);
+        if (out == nullptr) {
+            ConsoleMessage("Failed to allocate memory for QOI image.", "ERR", "Image");
+            return false;
+        }
+
+        unsigned char index[64][4] = {};
+        unsigned char px[4] = {0, 0, 0, 255};
+        auto p = QOI_HEADER_SIZE;
+        auto end = size - 8;
+        auto run = 0;
+
+        for (auto i = 0; i < pixelCount; i++) {
+            if (run > 0) run--;
+            else if (p < end) {
+                auto b1 = data[p++];
+
+                if (b1 == QOI_OP_RGB) {
+                    px[0] = data[p++];
+                    px[1] = data[p++];
+                    px[2] = data[p++];
+                } else if (b1 == QOI_OP_RGBA) {
+                    px[0] = data[p++];
+                    px[1] = data[p++];
+                    px[2] = data[p++];
+                    px[3] = data[p++];
+                } else if ((b1 & QOI_MASK_2) == QOI_OP_INDEX) {
+                    memcpy(px, index[b1], 4);
+                } else if ((b1 & QOI_MASK_2) == QOI_OP_DIFF) {
+                    px[0] += ((b1 >> 4) & 3) - 2;
+                    px[1] += ((b1 >> 2) & 3) - 2;
+                    px[2] += (b1 & 3) - 2;
+                } else if ((b1 & QOI_MASK_2) == QOI_OP_LUMA) {
+                    auto b2 = data[p++];
+                    auto vg = (b1 & 0x3f) - 32;
+                    px[0] += vg - 8 + ((b2 >> 4) & 0x0f);
+                    px[1] += vg;
+                    px[2] += vg - 8 + (b2 & 0x0f);
+                } else if ((b1 & QOI_MASK_2) == QOI_OP_RUN) {
+                    run = b1 & 0x3f;
+                }
+
+                memcpy(index[QOI_HASH(px)], px, 4);
+            }
+
+            memcpy(out + i * channels, px, channels);
+        }
+
+        // Set fields
+        PixelData = out;
+        Width = width;
+        Height = height;
+        Format = channels == 4 ? UNCOMPRESSED_R8G8B8A8 : UNCOMPRESSED_R8G8B8;
+        Mipmaps = 1;
+        return true;
+    }
+
+    bool Image::__SaveNative(Filesystem::File &file_) const {
+        // Write header
+        unsigned int header[NATIVE_IMAGE_HEADER_SIZE / sizeof(unsigned int)] = {};
+        memcpy(header, "NIMG", 4);
+        header[1] = NATIVE_IMAGE_VERSION;
+        header[2] = (unsigned int)Width;
+        header[3] = (unsigned int)Height;
+        header[4] = (unsigned int)Format;
+        header[5] = (unsigned int)Mipmaps;
+        header[6] = (unsigned int)GetDataSize();
+
+        return file_.WriteBytes((unsigned char *)header, NATIVE_IMAGE_HEADER_SIZE)
+               && file_.WriteBytes(PixelData, header[6]);
+    }
+
+    bool Image::__SaveQOI(Filesystem::File &file_) const {
+        int channels;
+        if (Format == UNCOMPRESSED_R8G8B8A8) channels = 4;
+        else if (Format == UNCOMPRESSED_R8G8B8) channels = 3;
+        else {
+            ConsoleMessage("Only RGB8 and RGBA8 images can be saved as QOI.", "ERR", "Image");
+            return false;
+        }
+
+        // Allocate worst case
+        auto pixelCount = Width * Height;
+        std::vector<unsigned char> out;
+        out.reserve(QOI_HEADER_SIZE + pixelCount * (channels + 1) + 8);
+
+        // Write header
+        const char magic[4] = {'q', 'o', 'i', 'f'};
+        out.insert(out.end(), magic, magic + 4);
+        for (auto value : {(unsigned int)Width, (unsigned int)Height}) {
+            out.push_back((unsigned char)(value >> 24));
+            out.push_back((unsigned char)(value >> 16));
+            out.push_back((unsigned char)(value >> 8));
+            out.push_back((unsigned char)value);
+        }
+        out.push_back((unsigned char)channels);
+        out.push_back(0); // sRGB with linear alpha
+
+        // Encode
+        unsigned char index[64][4] = {};
+        unsigned char prev[4] = {0, 0, 0, 255};
+        unsigned char px[4] = {0, 0, 0, 255};
+        auto run = 0;
+
+        for (auto i = 0; i < pixelCount; i++) {
+            memcpy(px, PixelData + i * channels, channels);
+
+            if (memcmp(px, prev, 4) == 0) {
+                run++;
+                if (run == 62 || i == pixelCount - 1) {
+                    out.push_back((unsigned char)(QOI_OP_RUN | (run - 1)));
+                    run = 0;
+                }
+                continue;
+            }
+
+            if (run > 0) {
+                out.push_back((unsigned char)(QOI_OP_RUN | (run - 1)));
+                run = 0;
+            }
+
+            auto hash = QOI_HASH(px);
+            if (memcmp(index[hash], px, 4) == 0) {
+                out.push_back((unsigned char)(QOI_OP_INDEX | hash));
+            } else {
+                memcpy(index[hash], px, 4);
+
+                if (px[3] == prev[3]) {
+                    auto vr = (signed char)(px[0] - prev[0]);
+                    auto vg = (signed char)(px[1] - prev[1]);
+                    auto vb = (signed char)(px[2] - prev[2]);
+                    auto vgr = vr - vg;
+                    auto vgb = vb - vg;
+
+                    if (vr > -3 && vr < 2 && vg > -3 && vg < 2 && vb > -3 && vb < 2) {
+                        out.push_back((unsigned char)(QOI_OP_DIFF | (vr + 2) << 4 | (vg + 2) << 2 | (vb + 2)));
+                    } else if (vgr > -9 && vgr < 8 && vg > -33 && vg < 32 && vgb > -9 && vgb < 8) {
+                        out.push_back((unsigned char)(QOI_OP_LUMA | (vg + 32)));
+                        out.push_back((unsigned char)((vgr + 8) << 4 | (vgb + 8)));
+                    } else {
+                        out.push_back(QOI_OP_RGB);
+                        out.insert(out.end(), px, px + 3);
+                    }
+                } else {
+                    out.push_back(QOI_OP_RGBA);
+                    out.insert(out.end(), px, px + 4);
+                }
+            }
+
+            memcpy(prev, px, 4);
+        }
+
+        // End marker
+        const unsigned char padding[8] = {0, 0, 0, 0, 0, 0, 0, 1};
+        out.insert(out.end(), padding, padding + 8);
+
+        return file_.WriteBytes(out.data(), (int)out.size());
+    }
+}
@@ -14,6 +14,8 @@
 
 #include "../Ngine.h"
 
+#include <functional>
+
 #include "../Filesystem/Filesystem.h"
 #include "../Resource.h"
 
@@ -46,6 +48,22 @@ namespace NerdThings::Ngine::Graphics {
         COMPRESSED_ASTC_8x8_RGBA
     };
 
+    /*
+     * Image resize filter
+     */
+    enum ResizeFilter {
+        /*
+         * Average of the covered source pixels.
+         * Best for downscaling, this is nearest neighbour when upscaling.
+         */
+        RESIZE_BOX = 0,
+
+        /*
+         * Bilinear interpolation
+         */
+        RESIZE_BILINEAR
+    };
+
     /*
      * An image stored in CPU memory.
      */
@@ -68,7 +86,14 @@ namespace NerdThings::Ngine::Graphics {
         int Mipmaps = 0;
 
         /*
-         * The raw pixel data pointer
+         * The minimum number of pixels before image operations are split across the thread pool.
+         * 0 disables parallel processing.
+         */
+        static int ParallelThreshold;
+
+        /*
+         * The raw pixel data pointer.
+         * Allocated with malloc so that decoder output can be adopted without a copy.
          */
         unsigned char *PixelData = nullptr;
 
@@ -85,7 +110,8 @@ namespace NerdThings::Ngine::Graphics {
         Image();
 
         /*
-         * Load an image file
+         * Load an image file.
+         * DDS, KTX and native (nimg) files keep their format and mipmaps.
          */
         Image(const Filesystem::Path &path_);
 
@@ -97,6 +123,89 @@ namespace NerdThings::Ngine::Graphics {
 
         // Public Methods
 
+        /*
+         * Copy another image into this image at the given position.
+         * The source is converted if the formats differ and the copy is clipped to the image bounds.
+         */
+        void Blit(const Image &src_, int x_, int y_);
+
+        /*
+         * Copy a region of another image into this image at the given position.
+         * The source is converted if the formats differ and the copy is clipped to the image bounds.
+         */
+        void Blit(const Image &src_, int srcX_, int srcY_, int width_, int height_, int x_, int y_);
+
+        /*
+         * Compress the image (and its mipmaps) to DXT1 or DXT5.
+         * Uncompressed 8-bit images are supported, other compressed formats are decompressed first.
+         * This does not touch the GPU, so it may be run on a worker thread.
+         */
+        bool Compress(PixelFormat format_);
+
+        /*
+         * Convert the image to another uncompressed 8-bit format.
+         * Conversions to grayscale use the luminance of the color.
+         */
+        void ConvertFormat(PixelFormat format_);
+
+        /*
+         * Crop the image to the given region
+         */
+        void Crop(int x_, int y_, int width_, int height_);
+
+        /*
+         * Decompress a compressed image (and its mipmaps) to RGBA8.
+         * DXT, ETC1 and ETC2 formats are supported.
+         * Returns false if the format cannot be decompressed.
+         */
+        bool Decompress();
+
+        /*
+         * Export the image to a file.
+         * QOI (RGB8/RGBA8 only, no mipmaps) and the native nimg format are supported.
+         * The native format stores the pixel data and mipmaps as they are uploaded, after a 32 byte header.
+         */
+        bool Export(const Filesystem::Path &path_) const;
+
+        /*
+         * Flip the image horizontally
+         */
+        void FlipHorizontal();
+
+        /*
+         * Flip the image vertically
+         */
+        void FlipVertical();
+
+        /*
+         * Generate a full mipmap chain with a box filter.
+         * The chain is stored in one allocation in the layout used for texture uploads.
+         * Only uncompressed 8-bit formats are supported.
+         * This does not touch the GPU, so it may be run on a worker thread.
+         */
+        void GenerateMipmaps();
+
+        /*
+         * Get the size of the pixel data, including all mipmaps
+         */
+        int GetDataSize() const;
+
+        /*
+         * Get the size of pixel data in the given format
+         */
+        static int GetPixelDataSize(int width_, int height_, PixelFormat format_);
+
+        /*
+         * Convert a grayscale image into a white gray alpha image, using the gray value as alpha.
+         * Used for coverage masks such as font glyphs.
+         */
+        void GrayscaleToAlpha();
+
+        /*
+         * Whether or not the image uses a compressed pixel format
+         */
+        bool IsCompressed() const;
+
         /*
          * Test whether or not the image is valid
          */
@@ -113,10 +222,127 @@ namespace NerdThings::Ngine::Graphics {
          */
         static Image *LoadPixels(unsigned char *pixelData_, int width_, int height_, PixelFormat format_);
 
+        /*
+         * Multiply the color channels by alpha.
+         * Only RGBA8 and gray alpha images are affected.
+         */
+        void PremultiplyAlpha();
+
+        /*
+         * Resize the image
+         */
+        void Resize(int width_, int height_, ResizeFilter filter_ = RESIZE_BILINEAR);
+
         /*
          * Unload image from memory.
          */
         void Unload() override;
+    private:
+        // Private Methods
+
+        /*
+         * Convert pixels between uncompressed 8-bit formats by channel count
+         */
+        static void __ConvertPixels(const unsigned char *src_, int srcChannels_, unsigned char *dst_, int dstChannels_, int count_);
+
+        /*
+         * Decode a DXT color block to 4x4 RGBA8.
+         * DXT1 blocks with c0 <= c1 use three colors and black, color blocks in DXT3/5 always use four colors.
+         */
+        static void __DecodeDXTColorBlock(const unsigned char *block_, unsigned char *out_, PixelFormat format_);
+
+        /*
+         * Decode an EAC alpha block into the alpha channel of 4x4 RGBA8.
+         */
+        static void __DecodeEACAlphaBlock(const unsigned char *block_, unsigned char *out_);
+
+        /*
+         * Decode an ETC1/ETC2 RGB block to 4x4 RGBA8.
+         */
+        static void __DecodeETCBlock(const unsigned char *block_, unsigned char *out_);
+
+        /*
+         * Downsample rows of a mipmap level into the next with a 2x2 box filter.
+         * Works on any format with 8 bits per channel.
+         */
+        static void __DownsampleBox(const unsigned char *src_, int srcWidth_, int srcHeight_, unsigned char *dst_, int channels_, int rowBegin_, int rowEnd_);
+
+        /*
+         * Run a function over a number of rows, using the thread pool for large images
+         */
+        static void __ForEachRow(int rows_, int rowPixels_, const std::function<void(int, int)> &func_);
+
+        /*
+         * Encode the alpha of 4x4 RGBA8 pixels as a DXT5 alpha block.
+         */
+        static void __EncodeDXTAlphaBlock(const unsigned char *pixels_, unsigned char *block_);
+
+        /*
+         * Encode 4x4 RGBA8 pixels as a DXT color block.
+         * With allowTransparent_, pixels with alpha below half use the transparent index.
+         */
+        static void __EncodeDXTColorBlock(const unsigned char *pixels_, unsigned char *block_, bool allowTransparent_);
+
+        /*
+         * Get the number of channels in an uncompressed 8-bit format, or 0 if unsupported
+         */
+        static int __GetChannelCount(PixelFormat format_);
+
+        /*
+         * Get the size of one mipmap level in bytes, without overflowing for large images
+         */
+        static unsigned long long __GetPixelDataSize64(int width_, int height_, PixelFormat format_);
+
+        /*
+         * Whether or not dimensions and a mipmap count read from a file are sane.
+         * The dimensions must be 1 to IMAGE_MAX_DIMENSION, there can be no more mipmaps than levels down to 1x1 and the chain size must fit in an int.
+         */
+        static bool __IsValidSize(int width_, int height_, int mipmaps_, PixelFormat format_);
+
+        /*
+         * Load a DDS file.
+         */
+        bool __LoadDDS(Filesystem::FileReader &file_);
+
+        /*
+         * Load a KTX (version 1) file.
+         */
+        bool __LoadKTX(Filesystem::FileReader &file_);
+
+        /*
+         * Load a native image file.
+         */
+        bool __LoadNative(Filesystem::FileReader &file_);
+
+        /*
+         * Load a QOI file.
+         */
+        bool __LoadQOI(const Filesystem::FileMapping &file_);
+
+        /*
+         * Multiply color by alpha for a number of pixels
+         */
+        static void __PremultiplyPixels(unsigned char *data_, int count_, int channels_);
+
+        /*
+         * Resize rows with a bilinear filter
+         */
+        static void __ResizeBilinear(const unsigned char *src_, int srcWidth_, int srcHeight_, unsigned char *dst_, int dstWidth_, int dstHeight_, int channels_, int rowBegin_, int rowEnd_);
+
+        /*
+         * Resize rows with a box filter
+         */
+        static void __ResizeBox(const unsigned char *src_, int srcWidth_, int srcHeight_, unsigned char *dst_, int dstWidth_, int dstHeight_, int channels_, int rowBegin_, int rowEnd_);
+
+        /*
+         * Save as a native image file.
+         */
+        bool __SaveNative(Filesystem::File &file_) const;
+
+        /*
+         * Save as a QOI file.
+         */
+        bool __SaveQOI(Filesystem::File &file_) const;
     };
 }
 
@@ -60,6 +60,21 @@ namespace NerdThings::Ngine::Graphics::OpenGL {
         return _Usage;
     }
 
+    void *GLBuffer::Map(int dataSize_) {
+#if defined(GRAPHICS_OPENGL33)
+        // Bind
+        Bind();
+
+        // Orphan the old storage so we don't stall on a previous use
+        glBufferData(_Type, dataSize_, nullptr, _Usage);
+
+        // Map for writing
+        return glMapBufferRange(_Type, 0, dataSize_, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+#else
+        return nullptr;
+#endif
+    }
+
     void GLBuffer::SetData(void *data_, int dataSize_) {
         // Bind
         Bind();
@@ -67,5 +82,22 @@ namespace NerdThings::Ngine::Graphics::OpenGL {
         // Set data
         glBufferData(_Type, dataSize_, data_, _Usage);
     }
+
+    void GLBuffer::Unbind() {
+        // Unbind buffer
+        glBindBuffer(_Type, 0);
+    }
+
+    bool GLBuffer::Unmap() {
+#if defined(GRAPHICS_OPENGL33)
+        // Bind
+        Bind();
+
+        // Unmap
+        return glUnmapBuffer(_Type) == GL_TRUE;
+#else
+        return false;
+#endif
+    }
 }
 #endif
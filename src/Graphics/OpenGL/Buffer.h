@@ -25,7 +25,12 @@ namespace NerdThings::Ngine::Graphics::OpenGL {
         /*
          * Index buffer
          */
-        BUFFER_INDEX = 0x8893
+        BUFFER_INDEX = 0x8893,
+
+        /*
+         * Pixel unpack buffer (texture uploads)
+         */
+        BUFFER_PIXEL_UNPACK = 0x88EC
     };
 
     enum GLBufferUsage {
@@ -37,7 +42,12 @@ namespace NerdThings::Ngine::Graphics::OpenGL {
         /*
          * Dynamic usa
          */
-        USAGE_DYNAMIC = 0x88E8
+        USAGE_DYNAMIC = 0x88E8,
+
+        /*
+         * Stream use (written once, used once)
+         */
+        USAGE_STREAM = 0x88E0
     };
 
     /*
@@ -84,10 +94,26 @@ namespace NerdThings::Ngine::Graphics::OpenGL {
          */
         GLBufferUsage GetBufferUsage();
 
+        /*
+         * Orphan the buffer storage and map it for writing.
+         * Returns null if mapping is not supported or failed.
+         */
+        void *Map(int dataSize_);
+
         /*
          * Set the buffer data
          */
         void SetData(void *data_, int dataSize_);
+
+        /*
+         * Unbind buffer
+         */
+        void Unbind();
+
+        /*
+         * Unmap the buffer after a call to Map().
+         */
+        bool Unmap();
     };
 }
 
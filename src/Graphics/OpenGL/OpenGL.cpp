@@ -110,6 +110,7 @@ namespace NerdThings::Ngine::Graphics::OpenGL {
 
     std::shared_ptr<GLShaderProgram> GL::_CurrentShaderProgram = nullptr;
     std::shared_ptr<GLShaderProgram> GL::_DefaultShaderProgram = nullptr;
+    std::shared_ptr<GLShaderProgram> GL::_SDFShaderProgram = nullptr;
 
     // Draw Batching Related Fields
 
@@ -119,6 +120,10 @@ namespace NerdThings::Ngine::Graphics::OpenGL {
     int GL::_DrawCounter = 0;
     GLDynamicBuffer GL::_VertexData[];
 
+    // Texture Related Fields
+
+    std::unique_ptr<GLBuffer> GL::_PixelUnpackBuffer = nullptr;
+
     // Matrix Related Fields
 
     Matrix *GL::_CurrentMatrix = nullptr;
@@ -134,6 +139,7 @@ namespace NerdThings::Ngine::Graphics::OpenGL {
 
     float GL::MaxAnisotropicLevel = 0.0f;
     int GL::MaxDepthBits = 16;
+    bool GL::PBOSupported = false;
     bool GL::TexAnisotropicFilterSupported = false;
     bool GL::TexCompDXTSupported = false;
     bool GL::TexCompETC1Supported = false;
@@ -149,6 +155,28 @@ namespace NerdThings::Ngine::Graphics::OpenGL {
     // Textures
     std::shared_ptr<GLTexture> GL::DefaultTexture = nullptr;
 
+    GLBuffer *GL::GetPixelUnpackBuffer() {
+        // Create on first use
+        if (_PixelUnpackBuffer == nullptr)
+            _PixelUnpackBuffer = std::make_unique<GLBuffer>(BUFFER_PIXEL_UNPACK, USAGE_STREAM);
+        return _PixelUnpackBuffer.get();
+    }
+
+    // Shader Related Methods
+
+    std::shared_ptr<GLShaderProgram> GL::GetSDFShaderProgram() {
+        return _SDFShaderProgram;
+    }
+
+    void GL::UseShaderProgram(std::shared_ptr<GLShaderProgram> program_) {
+        if (program_ == nullptr) program_ = _DefaultShaderProgram;
+        if (program_ == _CurrentShaderProgram) return;
+
+        // The whole batch is drawn with one program
+        Draw();
+        _CurrentShaderProgram = program_;
+    }
+
     // Vertex Array Methods
 
     void GL::GenVertexArrays(int n, unsigned int *arrays) {
@@ -404,7 +432,7 @@ namespace NerdThings::Ngine::Graphics::OpenGL {
         }
 
         auto fragmentShader = std::make_shared<GLShader>(fragmentShaderSrc, SHADER_FRAGMENT);
-        if (vertexShader->IsDirty()) {
+        if (fragmentShader->IsDirty()) {
             ConsoleMessage("Failed to compile internal fragment shader.", "FATAL", "OpenGL");
             throw std::runtime_error("ERROR, INTERNAL SHADER FAILED TO COMPILE!");
         }
@@ -417,6 +445,62 @@ namespace NerdThings::Ngine::Graphics::OpenGL {
             throw std::runtime_error("ERROR, INTERNAL SHADER FAILED TO COMPILE!");
         }
         ConsoleMessage("Loaded internal shader.", "NOTICE", "OpenGL");
+
+        // Text shaders share the vertex shader
+        LoadSDFShader(vertexShader);
+    }
+
+    void GL::LoadSDFShader(std::shared_ptr<GLShader> vertexShader_) {
+        // The distance is stored in alpha, with the glyph edge at 0.5
+        std::string fragmentShaderSrc =
+#if defined(GRAPHICS_OPENGL21)
+                "#version 120\n"
+#elif defined(GRAPHICS_OPENGLES2)
+                "#version 100\n"
+                "precision mediump float;\n"
+#endif
+#if defined(GRAPHICS_OPENGLES2) || defined(GRAPHICS_OPENGL21)
+                "varying vec2 fragTexCoord;\n"
+                "varying vec4 fragColor;\n"
+#else
+                "#version 330\n"
+                "in vec2 fragTexCoord;\n"
+                "in vec4 fragColor;\n"
+                "out vec4 finalColor;\n"
+#endif
+                "uniform sampler2D texture;\n"
+                "void main()\n"
+                "{\n"
+                "    float distance = texture2D(texture, fragTexCoord).a;\n"
+#if defined(GRAPHICS_OPENGLES2)
+                // Derivatives are an extension on ES2, use a fixed edge width
+                "    float smoothing = 0.0625;\n"
+#else
+                "    float smoothing = max(fwidth(distance), 0.001);\n"
+#endif
+                "    float alpha = smoothstep(0.5 - smoothing, 0.5 + smoothing, distance);\n"
+#if defined(GRAPHICS_OPENGLES2) || defined(GRAPHICS_OPENGL21)
+                "    gl_FragColor = vec4(fragColor.rgb, fragColor.a*alpha);\n"
+#elif defined(GRAPHICS_OPENGL33)
+                "    finalColor = vec4(fragColor.rgb, fragColor.a*alpha);\n"
+#endif
+                "}\n";
+
+        // Load shader
+        auto fragmentShader = std::make_shared<GLShader>(fragmentShaderSrc, SHADER_FRAGMENT);
+        if (fragmentShader->IsDirty()) {
+            ConsoleMessage("Failed to compile internal SDF fragment shader.", "FATAL", "OpenGL");
+            throw std::runtime_error("ERROR, INTERNAL SHADER FAILED TO COMPILE!");
+        }
+
+        // Load program
+        _SDFShaderProgram = std::make_shared<GLShaderProgram>(fragmentShader, vertexShader_);
+
+        if (_SDFShaderProgram->IsDirty() || !_SDFShaderProgram->IsLinked()) {
+            ConsoleMessage("Failed to link internal SDF shader.", "FATAL", "OpenGL");
+            throw std::runtime_error("ERROR, INTERNAL SHADER FAILED TO COMPILE!");
+        }
+        ConsoleMessage("Loaded internal SDF shader.", "NOTICE", "OpenGL");
     }
 
     void GL::UpdateBuffersDefault() {
@@ -517,6 +601,54 @@ namespace NerdThings::Ngine::Graphics::OpenGL {
 
     // Vertex Methods
 
+    void GL::AppendQuads(std::shared_ptr<GLTexture> texture_, const float *positions_, const float *texCoords_,
+                         int quadCount_, Vector2 offset_, Graphics::Color color_) {
+        float color[4] = {color_.RedF(), color_.GreenF(), color_.BlueF(), color_.AlphaF()};
+
+        while (quadCount_ > 0) {
+            // Fit as many quads as the batch allows, End() flushes at this point too
+            auto space = (MAX_BATCH_ELEMENTS * 4 - 4 - _VertexData[_CurrentBuffer].VCounter) / 4;
+            if (space <= 0) {
+                Draw();
+                space = (MAX_BATCH_ELEMENTS * 4 - 4 - _VertexData[_CurrentBuffer].VCounter) / 4;
+                if (space <= 0) throw std::runtime_error("Buffer overflow.");
+            }
+
+            auto count = std::min(space, quadCount_);
+
+            Begin(PRIMITIVE_QUADS);
+            UseTexture(texture_);
+
+            auto &buffer = _VertexData[_CurrentBuffer];
+            auto vertices = buffer.Vertices.get() + 3 * buffer.VCounter;
+            auto texCoords = buffer.TexCoords.get() + 2 * buffer.TCCounter;
+            auto colors = buffer.Colors.get() + 4 * buffer.CCounter;
+
+            for (auto i = 0; i < count * 4; i++) {
+                Vector3 pos = {positions_[2 * i] + offset_.X, positions_[2 * i + 1] + offset_.Y, _CurrentDepth};
+                if (_UseTransformMatrix) pos = pos.Transform(_TransformMatrix);
+
+                vertices[3 * i] = pos.X;
+                vertices[3 * i + 1] = pos.Y;
+                vertices[3 * i + 2] = pos.Z;
+                texCoords[2 * i] = texCoords_[2 * i];
+                texCoords[2 * i + 1] = texCoords_[2 * i + 1];
+                memcpy(colors + 4 * i, color, sizeof(color));
+            }
+
+            buffer.VCounter += count * 4;
+            buffer.TCCounter += count * 4;
+            buffer.CCounter += count * 4;
+            _DrawCalls[_DrawCounter - 1].VertexCount += count * 4;
+
+            End();
+
+            positions_ += count * 8;
+            texCoords_ += count * 8;
+            quadCount_ -= count;
+        }
+    }
+
     void GL::Begin(GLPrimitiveMode mode_) {
         if (_DrawCalls[_DrawCounter - 1].Mode != mode_) {
             if (_DrawCalls[_DrawCounter - 1].VertexCount > 0) {
@@ -704,9 +836,11 @@ namespace NerdThings::Ngine::Graphics::OpenGL {
             _DrawCalls[i] = GLDrawCall();
 
         DefaultTexture = nullptr;
+        _PixelUnpackBuffer = nullptr;
 
         _CurrentShaderProgram = nullptr;
         _DefaultShaderProgram = nullptr;
+        _SDFShaderProgram = nullptr;
     }
 
     void GL::Init() {
@@ -730,6 +864,7 @@ namespace NerdThings::Ngine::Graphics::OpenGL {
         VAOSupported = true;
 
         // Default supported
+        PBOSupported = true;
         TexNPOTSupported = true;
         TexFloatSupported = true;
         TexDepthSupported = true;
@@ -865,9 +1000,9 @@ namespace NerdThings::Ngine::Graphics::OpenGL {
 
     void GL::GetGLTextureFormats(int format_, unsigned int *glInternalFormat_, unsigned int *glFormat_,
                                  unsigned int *glType_) {
-        *glInternalFormat_ = -1;
-        *glFormat_ = -1;
-        *glType_ = -1;
+        *glInternalFormat_ = TEXTURE_FORMAT_UNSUPPORTED;
+        *glFormat_ = TEXTURE_FORMAT_UNSUPPORTED;
+        *glType_ = TEXTURE_FORMAT_UNSUPPORTED;
 
         switch (format_) {
 #if defined(GRAPHICS_OPENGL21) || defined(GRAPHICS_OPENGLES2)
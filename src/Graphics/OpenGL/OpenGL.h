@@ -23,6 +23,11 @@
 #include "Texture.h"
 #include "VertexArray.h"
 
+/*
+ * Returned by GL::GetGLTextureFormats for formats the context cannot use
+ */
+#define TEXTURE_FORMAT_UNSUPPORTED ((unsigned int)-1)
+
 /*
  * This file is sorted by function then alphabetically to make it more clear.
  * This will be done engine wide soon.
@@ -174,6 +179,11 @@ namespace NerdThings::Ngine::Graphics::OpenGL {
          */
         static std::shared_ptr<GLShaderProgram> _DefaultShaderProgram;
 
+        /*
+         * The signed distance field text shader program
+         */
+        static std::shared_ptr<GLShaderProgram> _SDFShaderProgram;
+
         // Draw Batching Related Fields
 
         /*
@@ -201,6 +211,13 @@ namespace NerdThings::Ngine::Graphics::OpenGL {
          */
         static GLDynamicBuffer _VertexData[MAX_BATCH_BUFFERING]; // TODO: Will we ever use these other batches?
 
+        // Texture Related Fields
+
+        /*
+         * Pixel unpack buffer used to stage texture uploads
+         */
+        static std::unique_ptr<GLBuffer> _PixelUnpackBuffer;
+
         // Matrix Related Fields
 
         /*
@@ -260,6 +277,11 @@ namespace NerdThings::Ngine::Graphics::OpenGL {
          */
         static void LoadDefaultShader();
 
+        /*
+         * Initialize the signed distance field shader program
+         */
+        static void LoadSDFShader(std::shared_ptr<GLShader> vertexShader_);
+
         /*
          * Update the data in the internal buffers
          */
@@ -278,6 +300,11 @@ namespace NerdThings::Ngine::Graphics::OpenGL {
          */
         static int MaxDepthBits;
 
+        /*
+         * Pixel buffer object support
+         */
+        static bool PBOSupported;
+
         /*
          * Anisotropic filtering support
          */
@@ -340,6 +367,25 @@ namespace NerdThings::Ngine::Graphics::OpenGL {
          */
         static std::shared_ptr<GLTexture> DefaultTexture;
 
+        /*
+         * Get the pixel unpack buffer used for staging texture uploads.
+         * Intended for internal use. See OpenGL::GLTexture::UploadMipmap instead.
+         */
+        static GLBuffer *GetPixelUnpackBuffer();
+
+        // Shader Related Methods
+
+        /*
+         * Get the shader program used to draw signed distance field fonts
+         */
+        static std::shared_ptr<GLShaderProgram> GetSDFShaderProgram();
+
+        /*
+         * Use a shader program for the following vertices.
+         * The batch is drawn first if the program changes. Null uses the default shader program.
+         */
+        static void UseShaderProgram(std::shared_ptr<GLShaderProgram> program_);
+
         // Vertex Array Methods
         // This is only here to fix GLES2 issues
 
@@ -415,6 +461,14 @@ namespace NerdThings::Ngine::Graphics::OpenGL {
 
         // Vertex Methods
 
+        /*
+         * Append textured quads to the batch in bulk.
+         * Each quad has 4 positions and 4 texture coordinates (8 floats each), in the order used by Renderer::DrawTexture.
+         * Positions are offset, then transformed by the current matrix like Vertex.
+         */
+        static void AppendQuads(std::shared_ptr<GLTexture> texture_, const float *positions_, const float *texCoords_,
+                                int quadCount_, Vector2 offset_, Graphics::Color color_);
+
         /*
          * Begin a set of vertices
          */
@@ -492,7 +546,8 @@ namespace NerdThings::Ngine::Graphics::OpenGL {
         static void ClearColor(Graphics::Color color_);
 
         /*
-         * Get OpenGL equivalent texture formats
+         * Get OpenGL equivalent texture formats.
+         * Unsupported formats give TEXTURE_FORMAT_UNSUPPORTED.
          */
         static void GetGLTextureFormats(int format_, unsigned int *glInternalFormat_, unsigned int *glFormat_, unsigned int *glType_);
 
@@ -117,6 +117,11 @@ namespace NerdThings::Ngine::Graphics::OpenGL {
         Uniforms[UNIFORM_TEXTURE] = "texture";
         ConsoleMessage("Loaded default attribute and uniform names.", "NOTICE", "GLShaderProgram");
 
+        // Fix attribute locations so every program works with the same vertex arrays
+        glBindAttribLocation(ID, ATTRIB_POSITION, Attribs[ATTRIB_POSITION]);
+        glBindAttribLocation(ID, ATTRIB_TEXCOORD, Attribs[ATTRIB_TEXCOORD]);
+        glBindAttribLocation(ID, ATTRIB_COLOR, Attribs[ATTRIB_COLOR]);
+
         // Perform link
         // We give the option to not if the above params need tweaks
         if (doLink_) {
@@ -33,25 +33,27 @@
 #define GL_TEXTURE_MAX_ANISOTROPY_EXT       0x84FE
 #endif
 
+#include "../Image.h"
 #include "OpenGL.h"
 
 namespace NerdThings::Ngine::Graphics::OpenGL {
-    GLTexture::GLTexture() {}
+    // Private Methods
 
-    GLTexture::GLTexture(unsigned int width_, unsigned int height_, void *data_, int mipmapCount_,
-                         GLPixelFormat format_) {
+    bool GLTexture::__Create(unsigned int width_, unsigned int height_, int mipmapCount_, GLPixelFormat format_) {
         // Check dimensions
         if (width_ <= 0 || height_ <= 0) {
             ConsoleMessage("Texture was given invalid dimensions of " + std::to_string(width_) + ", " + std::to_string(height_) + ".", "ERROR", "GLTexture");
-            return;
+            return false;
         }
 
         // Unbind any bound textures
         glBindTexture(GL_TEXTURE_2D, 0);
 
-        // Set mipmap count and format
+        // Set mipmap count, format and size
         MipmapCount = mipmapCount_;
         _Format = format_;
+        _Width = width_;
+        _Height = height_;
 
         // Check format support
         if ((!GL::TexCompDXTSupported) && ((format_ == COMPRESSED_DXT1_RGB) || (format_ == COMPRESSED_DXT1_RGBA) ||
@@ -86,49 +88,10 @@ namespace NerdThings::Ngine::Graphics::OpenGL {
 
         // Bind
         Bind();
+        return true;
+    }
 
-        // Generate mipmaps
-        int mipWidth = width_;
-        int mipHeight = height_;
-        int mipOffset = 0;
-
-        unsigned int glInternalFormat, glFormat, glType;
-        GL::GetGLTextureFormats(format_, &glInternalFormat, &glFormat, &glType);
-
-        for (int i = 0; i < mipmapCount_; i++) {
-            unsigned int mipSize = GetPixelDataSize(mipWidth, mipHeight, format_);
-
-            if (glInternalFormat != -1) {
-                if (format_ < COMPRESSED_DXT1_RGB) glTexImage2D(GL_TEXTURE_2D, i, glInternalFormat, mipWidth, mipHeight, 0, glFormat, glType, (unsigned char *)data_ + mipOffset);
-                else glCompressedTexImage2D(GL_TEXTURE_2D, i, glInternalFormat, mipWidth, mipHeight, 0, mipSize, (unsigned char *)data_ + mipOffset);
-
-#if defined(GRAPHICS_OPENGL33)
-                if (format_ == UNCOMPRESSED_GRAYSCALE)
-                {
-                    GLint swizzleMask[] = { GL_RED, GL_RED, GL_RED, GL_ONE };
-                    glTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_RGBA, swizzleMask);
-                }
-                else if (format_ == UNCOMPRESSED_GRAY_ALPHA)
-                {
-#if defined(GRAPHICS_OPENGL21)
-                    GLint swizzleMask[] = { GL_RED, GL_RED, GL_RED, GL_ALPHA };
-#elif defined(GRAPHICS_OPENGL33)
-                    GLint swizzleMask[] = { GL_RED, GL_RED, GL_RED, GL_GREEN };
-#endif
-                    glTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_RGBA, swizzleMask);
-                }
-#endif
-            }
-
-            mipWidth /= 2;
-            mipHeight /= 2;
-            mipOffset += mipSize;
-
-            // Security check for NPOT textures
-            if (mipWidth < 1) mipWidth = 1;
-            if (mipHeight < 1) mipHeight = 1;
-        }
-
+    void GLTexture::__InitParameters() {
         // Init parameters
 #if defined(GRAPHICS_OPENGLES2)
     // NOTE: OpenGL ES 2.0 with no GL_OES_texture_npot support (i.e. WebGL) has limited NPOT support, so CLAMP_TO_EDGE must be used
@@ -157,7 +120,7 @@ namespace NerdThings::Ngine::Graphics::OpenGL {
 #endif
 
 #if defined(GRAPHICS_OPENGL33)
-        if (mipmapCount_ > 1)
+        if (MipmapCount > 1)
         {
             SetParameter(TEXPARAM_MAG_FILTER, FILTER_FUNC_LINEAR);
             SetParameter(TEXPARAM_MIN_FILTER, FILTER_FUNC_MIP_LINEAR);
@@ -170,10 +133,80 @@ namespace NerdThings::Ngine::Graphics::OpenGL {
         }
     }
 
+    void GLTexture::__SetMipmap(int level_, void *data_) {
+        unsigned int glInternalFormat, glFormat, glType;
+        GL::GetGLTextureFormats(_Format, &glInternalFormat, &glFormat, &glType);
+
+        if (glInternalFormat == TEXTURE_FORMAT_UNSUPPORTED) return;
+
+        auto mipWidth = GetMipmapWidth(level_);
+        auto mipHeight = GetMipmapHeight(level_);
+
+        if (_Format < COMPRESSED_DXT1_RGB) glTexImage2D(GL_TEXTURE_2D, level_, glInternalFormat, mipWidth, mipHeight, 0, glFormat, glType, data_);
+        else glCompressedTexImage2D(GL_TEXTURE_2D, level_, glInternalFormat, mipWidth, mipHeight, 0, GetPixelDataSize(mipWidth, mipHeight, _Format), data_);
+
+#if defined(GRAPHICS_OPENGL33)
+        if (_Format == UNCOMPRESSED_GRAYSCALE)
+        {
+            GLint swizzleMask[] = { GL_RED, GL_RED, GL_RED, GL_ONE };
+            glTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_RGBA, swizzleMask);
+        }
+        else if (_Format == UNCOMPRESSED_GRAY_ALPHA)
+        {
+#if defined(GRAPHICS_OPENGL21)
+            GLint swizzleMask[] = { GL_RED, GL_RED, GL_RED, GL_ALPHA };
+#elif defined(GRAPHICS_OPENGL33)
+            GLint swizzleMask[] = { GL_RED, GL_RED, GL_RED, GL_GREEN };
+#endif
+            glTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_RGBA, swizzleMask);
+        }
+#endif
+    }
+
+    // Public Constructors
+
+    GLTexture::GLTexture() {}
+
+    GLTexture::GLTexture(unsigned int width_, unsigned int height_, void *data_, int mipmapCount_,
+                         GLPixelFormat format_) {
+        // Create texture
+        if (!__Create(width_, height_, mipmapCount_, format_)) return;
+
+        // Upload mipmaps
+        int mipOffset = 0;
+
+        for (int i = 0; i < mipmapCount_; i++) {
+            __SetMipmap(i, (unsigned char *)data_ + mipOffset);
+            mipOffset += GetPixelDataSize(GetMipmapWidth(i), GetMipmapHeight(i), format_);
+        }
+
+        // Init parameters
+        __InitParameters();
+    }
+
+    GLTexture::GLTexture(unsigned int width_, unsigned int height_, int mipmapCount_, GLPixelFormat format_) {
+        // Create texture
+        if (!__Create(width_, height_, mipmapCount_, format_)) return;
+
+        // Allocate storage for uncompressed mipmaps, compressed mipmaps are defined when uploaded
+        if (format_ < COMPRESSED_DXT1_RGB) {
+            for (int i = 0; i < mipmapCount_; i++) {
+                __SetMipmap(i, nullptr);
+            }
+        }
+
+        // Init parameters
+        __InitParameters();
+    }
+
+    // Destructor
+
     GLTexture::~GLTexture() {
         Delete();
     }
 
+    // Public Methods
+
     void GLTexture::Bind() {
         // Use texture unit 0
         glActiveTexture(GL_TEXTURE0);
@@ -192,6 +225,20 @@ namespace NerdThings::Ngine::Graphics::OpenGL {
         }
     }
 
+    GLPixelFormat GLTexture::GetFormat() const {
+        return _Format;
+    }
+
+    unsigned int GLTexture::GetMipmapHeight(int level_) const {
+        auto height = _Height >> level_;
+        return height < 1 ? 1 : height;
+    }
+
+    unsigned int GLTexture::GetMipmapWidth(int level_) const {
+        auto width = _Width >> level_;
+        return width < 1 ? 1 : width;
+    }
+
     void GLTexture::SetParameter(GLTextureParameter param_, int value_) {
         // Bind
         Bind();
@@ -222,46 +269,77 @@ namespace NerdThings::Ngine::Graphics::OpenGL {
         }
     }
 
+    void GLTexture::UploadMipmap(int level_, void *data_, int row_, int rowCount_, bool usePixelBuffer_) {
+        if (ID == 0 || level_ < 0 || level_ >= MipmapCount) return;
+
+        // Bind
+        Bind();
+
+        // Compressed formats are always uploaded as a whole level
+        if (_Format >= COMPRESSED_DXT1_RGB) {
+            __SetMipmap(level_, data_);
+            return;
+        }
+
+        auto mipWidth = GetMipmapWidth(level_);
+        auto mipHeight = GetMipmapHeight(level_);
+
+        if (rowCount_ < 0 || row_ + rowCount_ > (int)mipHeight) rowCount_ = mipHeight - row_;
+        if (rowCount_ <= 0) return;
+
+        unsigned int glInternalFormat, glFormat, glType;
+        GL::GetGLTextureFormats(_Format, &glInternalFormat, &glFormat, &glType);
+
+        if (glInternalFormat == TEXTURE_FORMAT_UNSUPPORTED) return;
+
+#if defined(GRAPHICS_OPENGL33)
+        // Stage through a pixel unpack buffer so the driver can copy asynchronously
+        if (usePixelBuffer_ && GL::PBOSupported) {
+            auto dataSize = GetPixelDataSize(mipWidth, rowCount_, _Format);
+            auto buffer = GL::GetPixelUnpackBuffer();
+            auto mapped = buffer->Map(dataSize);
+
+            if (mapped != nullptr) {
+                memcpy(mapped, data_, dataSize);
+
+                // Upload from the buffer if it is still intact
+                if (buffer->Unmap()) {
+                    Bind();
+                    glTexSubImage2D(GL_TEXTURE_2D, level_, 0, row_, mipWidth, rowCount_, glFormat, glType, nullptr);
+                    buffer->Unbind();
+                    return;
+                }
+            }
+
+            // Fall back to a direct upload
+            buffer->Unbind();
+            Bind();
+        }
+#endif
+
+        glTexSubImage2D(GL_TEXTURE_2D, level_, 0, row_, mipWidth, rowCount_, glFormat, glType, data_);
+    }
+
     int GLTexture::GetPixelDataSize(int width_, int height_, GLPixelFormat format_) {
-        auto bpp = 0;
+        // Pixel formats share values with the image formats
+        return Image::GetPixelDataSize(width_, height_, (PixelFormat)format_);
+    }
 
-        switch (format_)
-        {
-            case UNCOMPRESSED_GRAYSCALE: bpp = 8; break;
-            case UNCOMPRESSED_GRAY_ALPHA:
-            case UNCOMPRESSED_R5G6B5:
-            case UNCOMPRESSED_R5G5B5A1:
-            case UNCOMPRESSED_R4G4B4A4: bpp = 16; break;
-            case UNCOMPRESSED_R8G8B8A8: bpp = 32; break;
-            case UNCOMPRESSED_R8G8B8: bpp = 24; break;
-            case UNCOMPRESSED_R32: bpp = 32; break;
-            case UNCOMPRESSED_R32G32B32: bpp = 32*3; break;
-            case UNCOMPRESSED_R32G32B32A32: bpp = 32*4; break;
+    bool GLTexture::IsFormatSupported(GLPixelFormat format_) {
+        switch (format_) {
             case COMPRESSED_DXT1_RGB:
             case COMPRESSED_DXT1_RGBA:
-            case COMPRESSED_ETC1_RGB:
+            case COMPRESSED_DXT3_RGBA:
+            case COMPRESSED_DXT5_RGBA: return GL::TexCompDXTSupported;
+            case COMPRESSED_ETC1_RGB: return GL::TexCompETC1Supported;
             case COMPRESSED_ETC2_RGB:
+            case COMPRESSED_ETC2_EAC_RGBA: return GL::TexCompETC2Supported;
             case COMPRESSED_PVRT_RGB:
-            case COMPRESSED_PVRT_RGBA: bpp = 4; break;
-            case COMPRESSED_DXT3_RGBA:
-            case COMPRESSED_DXT5_RGBA:
-            case COMPRESSED_ETC2_EAC_RGBA:
-            case COMPRESSED_ASTC_4x4_RGBA: bpp = 8; break;
-            case COMPRESSED_ASTC_8x8_RGBA: bpp = 2; break;
-            default: break;
-        }
-
-        auto dataSize = width_*height_*bpp/8;  // Total data size in bytes
-
-        // Most compressed formats works on 4x4 blocks,
-        // if texture is smaller, minimum dataSize is 8 or 16
-        if ((width_ < 4) && (height_ < 4))
-        {
-            if ((format_ >= COMPRESSED_DXT1_RGB) && (format_ < COMPRESSED_DXT3_RGBA)) dataSize = 8;
-            else if ((format_ >= COMPRESSED_DXT3_RGBA) && (format_ < COMPRESSED_ASTC_8x8_RGBA)) dataSize = 16;
+            case COMPRESSED_PVRT_RGBA: return GL::TexCompPVRTSupported;
+            case COMPRESSED_ASTC_4x4_RGBA:
+            case COMPRESSED_ASTC_8x8_RGBA: return GL::TexCompASTCSupported;
+            default: return true;
         }
-
-        return dataSize;
     }
 }
 #endif
@@ -102,6 +102,32 @@ namespace NerdThings::Ngine::Graphics::OpenGL {
          * The pixel format
          */
         GLPixelFormat _Format;
+
+        /*
+         * The texture height
+         */
+        unsigned int _Height = 0;
+
+        /*
+         * The texture width
+         */
+        unsigned int _Width = 0;
+
+        /*
+         * Validate the format and generate the texture.
+         * Returns false if the dimensions are invalid.
+         */
+        bool __Create(unsigned int width_, unsigned int height_, int mipmapCount_, GLPixelFormat format_);
+
+        /*
+         * Set the default wrap and filter parameters
+         */
+        void __InitParameters();
+
+        /*
+         * Define a mipmap level, data may be null for uncompressed formats
+         */
+        void __SetMipmap(int level_, void *data_);
     public:
         // Public Fields
 
@@ -127,6 +153,12 @@ namespace NerdThings::Ngine::Graphics::OpenGL {
          */
         GLTexture(unsigned int width_, unsigned int height_, void *data_, int mipmapCount_ = 1, GLPixelFormat format_ = UNCOMPRESSED_R8G8B8A8);
 
+        /*
+         * Create a texture stored on the GPU without any pixel data.
+         * Data is then provided a mipmap at a time with UploadMipmap().
+         */
+        GLTexture(unsigned int width_, unsigned int height_, int mipmapCount_, GLPixelFormat format_);
+
         // Destructor
 
         /*
@@ -146,15 +178,42 @@ namespace NerdThings::Ngine::Graphics::OpenGL {
          */
         void Delete();
 
+        /*
+         * Get the texture format
+         */
+        GLPixelFormat GetFormat() const;
+
+        /*
+         * Get the height of a mipmap level
+         */
+        unsigned int GetMipmapHeight(int level_) const;
+
+        /*
+         * Get the width of a mipmap level
+         */
+        unsigned int GetMipmapWidth(int level_) const;
+
         /*
          * Set a texture parameter.
          */
         void SetParameter(GLTextureParameter param_, int value_);
 
+        /*
+         * Upload pixel data for a mipmap level.
+         * Uncompressed formats may be uploaded a band of rows at a time, compressed formats must upload the whole level.
+         * If a pixel buffer is requested and supported, the data is staged through a pixel unpack buffer.
+         */
+        void UploadMipmap(int level_, void *data_, int row_ = 0, int rowCount_ = -1, bool usePixelBuffer_ = false);
+
         /*
          * Get the size of pixel data.
          */
         static int GetPixelDataSize(int width_, int height_, GLPixelFormat format_);
+
+        /*
+         * Whether or not the GPU can use the given format
+         */
+        static bool IsFormatSupported(GLPixelFormat format_);
     };
 }
 
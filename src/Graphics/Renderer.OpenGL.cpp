@@ -69,6 +69,9 @@ namespace NerdThings::Ngine::Graphics {
     void Renderer::BeginDrawing() {
         // Setup framebuffer
         GraphicsManager::SetupFramebuffer();
+
+        // Glyphs used from here on belong to the new frame
+        Font::AdvanceFrame();
     }
 
     void Renderer::Clear(Color color_) {
@@ -427,21 +430,22 @@ namespace NerdThings::Ngine::Graphics {
         int letter = 0;             // Current character
         int index = 0;              // Index position in sprite font
 
+        // Rasterize and upload any new glyphs first
+        font_->PrepareGlyphs(string_);
+
+        // Distance field fonts need their own shader
+        if (font_->IsSDF()) OpenGL::GL::UseShaderProgram(OpenGL::GL::GetSDFShaderProgram());
+
         scaleFactor = fontSize_/font_->BaseSize;
 
-        for (int i = 0; i < string_.length(); i += 1)
+        for (int i = 0; i < (int)string_.length(); i++)
         {
             int next = 0;
-            // TODO: UTF8?
-            //letter = GetNextCodepoint(&text_[i], &next);
-            letter = string_[i];
+            letter = Font::GetNextCodepoint(string_, i, next);
             index = font_->GetGlyphIndex(letter);
 
-            // TODO: Some broken UTF8 code??
-            // NOTE: Normally we exit the decoding sequence as soon as a bad byte is found (and return 0x3f)
-            // but we need to draw all of the bad bytes using the '?' symbol so to not skip any we set 'next = 1'
-            //if (letter == 0x3f) next = 1;
-            //i += (next - 1);
+            // NOTE: Bad bytes decode to '?' one at a time, so none are skipped
+            i += (next - 1);
 
             if (letter == '\n')
             {
@@ -451,20 +455,29 @@ namespace NerdThings::Ngine::Graphics {
             }
             else
             {
-                if (letter != ' ')
+                if (letter != ' ' && index >= 0)
                 {
-                    DrawTexture(font_->GetTexture(),
-                                   { position_.X + textOffsetX + font_->Characters[index].OffsetX*scaleFactor,
-                                                position_.Y + textOffsetY + font_->Characters[index].OffsetY*scaleFactor,
-                                                font_->Characters[index].Rectangle.Width*scaleFactor,
-                                                font_->Characters[index].Rectangle.Height*scaleFactor },
-                                                font_->Characters[index].Rectangle, color_, { 0, 0 }, 0.0f);
+                    DrawTexture(font_->GetTexture(font_->GetGlyph(index).Page),
+                                   { position_.X + textOffsetX + font_->GetGlyph(index).OffsetX*scaleFactor,
+                                                position_.Y + textOffsetY + font_->GetGlyph(index).OffsetY*scaleFactor,
+                                                font_->GetGlyph(index).Rectangle.Width*scaleFactor,
+                                                font_->GetGlyph(index).Rectangle.Height*scaleFactor },
+                                                font_->GetGlyph(index).Rectangle, color_, { 0, 0 }, 0.0f);
                 }
 
-                if (font_->Characters[index].AdvanceX == 0) textOffsetX += ((float)font_->Characters[index].Rectangle.Width*scaleFactor + spacing_);
-                else textOffsetX += ((float)font_->Characters[index].AdvanceX*scaleFactor + spacing_);
+                if (font_->GetGlyph(index).AdvanceX == 0) textOffsetX += ((float)font_->GetGlyph(index).Rectangle.Width*scaleFactor + spacing_);
+                else textOffsetX += ((float)font_->GetGlyph(index).AdvanceX*scaleFactor + spacing_);
+
+                // Kerning with the following character
+                if (i + 1 < (int)string_.length())
+                {
+                    int nextBytes = 0;
+                    textOffsetX += font_->GetKerning(index, font_->GetGlyphIndex(Font::GetNextCodepoint(string_, i + 1, nextBytes)))*scaleFactor;
+                }
             }
         }
+
+        if (font_->IsSDF()) OpenGL::GL::UseShaderProgram(nullptr);
     }
 
     void Renderer::DrawTextRect(Font *font_, const std::string &string_, Rectangle rectangle_, float fontSize_,
@@ -482,6 +495,12 @@ namespace NerdThings::Ngine::Graphics {
         int letter = 0;             // Current character
         int index = 0;              // Index position in sprite font
 
+        // Rasterize and upload any new glyphs first
+        font_->PrepareGlyphs(string_);
+
+        // Distance field fonts need their own shader
+        if (font_->IsSDF()) OpenGL::GL::UseShaderProgram(OpenGL::GL::GetSDFShaderProgram());
+
         scaleFactor = fontSize_/font_->BaseSize;
         int startLine = -1;
         int endLine = -1;
@@ -492,13 +511,21 @@ namespace NerdThings::Ngine::Graphics {
         for (auto i = 0, k = 0; i < string_.length(); i++, k++) {
             int glyphWidth = 0;
             int next = 0;
-            letter = string_[i];
+            letter = Font::GetNextCodepoint(string_, i, next);
             index = font_->GetGlyphIndex(letter);
 
+            i += (next - 1);
+
             if (letter != '\n') {
-                glyphWidth = (font_->Characters[index].AdvanceX == 0)?
-                             (int)(font_->Characters[index].Rectangle.Width*scaleFactor + spacing_):
-                             (int)(font_->Characters[index].AdvanceX*scaleFactor + spacing_);
+                glyphWidth = (font_->GetGlyph(index).AdvanceX == 0)?
+                             (int)(font_->GetGlyph(index).Rectangle.Width*scaleFactor + spacing_):
+                             (int)(font_->GetGlyph(index).AdvanceX*scaleFactor + spacing_);
+
+                // Kerning with the following character
+                if (i + 1 < (int)string_.length()) {
+                    int nextBytes = 0;
+                    glyphWidth += (int)(font_->GetKerning(index, font_->GetGlyphIndex(Font::GetNextCodepoint(string_, i + 1, nextBytes)))*scaleFactor);
+                }
             }
 
             if (measureState) {
@@ -561,13 +588,13 @@ namespace NerdThings::Ngine::Graphics {
                     }
 
                     // Draw glyph
-                    if ((letter != ' ') && (letter != '\t'))
+                    if ((letter != ' ') && (letter != '\t') && (index >= 0))
                     {
-                        DrawTexture(font_->Texture.get(), { rectangle_.X + textOffsetX + font_->Characters[index].OffsetX*scaleFactor,
-                                                            rectangle_.Y + textOffsetY + font_->Characters[index].OffsetY*scaleFactor,
-                                                            font_->Characters[index].Rectangle.Width*scaleFactor,
-                                                            font_->Characters[index].Rectangle.Height*scaleFactor },
-                                                            font_->Characters[index].Rectangle,
+                        DrawTexture(font_->GetTexture(font_->GetGlyph(index).Page), { rectangle_.X + textOffsetX + font_->GetGlyph(index).OffsetX*scaleFactor,
+                                                            rectangle_.Y + textOffsetY + font_->GetGlyph(index).OffsetY*scaleFactor,
+                                                            font_->GetGlyph(index).Rectangle.Width*scaleFactor,
+                                                            font_->GetGlyph(index).Rectangle.Height*scaleFactor },
+                                                            font_->GetGlyph(index).Rectangle,
                                                             (!isGlyphSelected)? color_ : selectText_, { 0, 0 }, 0.0f);
                     }
                 }
@@ -586,6 +613,42 @@ namespace NerdThings::Ngine::Graphics {
 
             textOffsetX += glyphWidth;
         }
+
+        if (font_->IsSDF()) OpenGL::GL::UseShaderProgram(nullptr);
+    }
+
+    void Renderer::DrawTextLayout(TextLayout *layout_, Vector2 position_, Color color_) {
+        // Check null
+        if (layout_ == nullptr) throw std::runtime_error("Text layout is null.");
+
+        auto font = layout_->GetFont();
+        if (font == nullptr) return;
+
+        const auto &runs = layout_->GetRuns();
+
+        // Keep cached glyphs resident this frame and upload any the layout added
+        if (font->IsDynamic()) {
+            for (const auto &run : runs)
+                for (auto glyph : run.Glyphs) font->MarkGlyphUsed(glyph);
+            font->UploadGlyphCache();
+        }
+
+        if (font->IsSDF()) OpenGL::GL::UseShaderProgram(OpenGL::GL::GetSDFShaderProgram());
+
+        for (const auto &run : runs) {
+            auto texture = font->GetTexture(run.Page);
+
+            if (texture == nullptr || !texture->IsValid()) {
+                ConsoleMessage("Attempted to draw text with an invalid font texture.", "WARN", "Renderer.OpenGL");
+                continue;
+            }
+
+            OpenGL::GL::AppendQuads(texture->InternalTexture, run.Positions.data(), run.TexCoords.data(),
+                                    (int)run.Positions.size() / 8, position_, color_);
+            OpenGL::GL::StopUsingTexture();
+        }
+
+        if (font->IsSDF()) OpenGL::GL::UseShaderProgram(nullptr);
     }
 
     void
@@ -18,6 +18,7 @@
 #include "../Vector2.h"
 #include "Color.h"
 #include "Font.h"
+#include "TextLayout.h"
 #include "Texture2D.h"
 
 namespace NerdThings::Ngine::Graphics {
@@ -213,6 +214,12 @@ namespace NerdThings::Ngine::Graphics {
                                    Color color_, int selectStart_, int selectLength_,
                                    Color selectText_, Color selectBack_, bool wordWrap_ = true);
 
+        /*
+         * Draw laid out text.
+         * Each atlas page is appended to the batch in one go.
+         */
+        static void DrawTextLayout(TextLayout *layout_, Vector2 position_, Color color_);
+
         /*
          * Draw a texture
          */
@@ -0,0 +1,117 @@
+/**********************************************************************************************
+*
+*   Ngine - The 2D game engine.
+*
+*   Copyright (C) 2019 NerdThings
+*
+*   LICENSE: Apache License 2.0
+*   View: https://github.com/NerdThings/Ngine/blob/master/LICENSE
+*
+**********************************************************************************************/
+
+#include "SkylinePacker.h"
+
+#include <climits>
+
+namespace NerdThings::Ngine::Graphics {
+    // Private Methods
+
+    int SkylinePacker::__Fit(int index_, int width_, int height_) const {
+        auto x = _Skyline[index_].X;
+        if (x + width_ > _Width) return -1;
+
+        // Rest on the highest node spanned
+        auto y = 0;
+        auto widthLeft = width_;
+        for (auto i = index_; widthLeft > 0; i++) {
+            y = std::max(y, _Skyline[i].Y);
+            if (y + height_ > _Height) return -1;
+            widthLeft -= _Skyline[i].Width;
+        }
+
+        return y;
+    }
+
+    // Public Constructor(s)
+
+    SkylinePacker::SkylinePacker(int width_, int height_)
+        : _Height(height_), _Width(width_) {
+        Reset();
+    }
+
+    // Public Methods
+
+    int SkylinePacker::GetHeight() const {
+        return _Height;
+    }
+
+    int SkylinePacker::GetUsedHeight() const {
+        return _UsedHeight;
+    }
+
+    int SkylinePacker::GetWidth() const {
+        return _Width;
+    }
+
+    bool SkylinePacker::Pack(int width_, int height_, int &x_, int &y_) {
+        if (width_ <= 0 || height_ <= 0 || width_ > _Width || height_ > _Height) return false;
+
+        // Find the lowest position, preferring narrower nodes to reduce waste
+        auto bestIndex = -1;
+        auto bestBottom = INT_MAX;
+        auto bestWidth = INT_MAX;
+
+        for (auto i = 0; i < (int)_Skyline.size(); i++) {
+            auto y = __Fit(i, width_, height_);
+            if (y < 0) continue;
+
+            if (y + height_ < bestBottom || (y + height_ == bestBottom && _Skyline[i].Width < bestWidth)) {
+                bestIndex = i;
+                bestBottom = y + height_;
+                bestWidth = _Skyline[i].Width;
+            }
+        }
+
+        if (bestIndex < 0) return false;
+
+        x_ = _Skyline[bestIndex].X;
+        y_ = bestBottom - height_;
+
+        // Raise the skyline under the new rectangle
+        _Skyline.insert(_Skyline.begin() + bestIndex, {x_, bestBottom, width_});
+
+        // Trim or remove the nodes it now covers
+        for (auto i = bestIndex + 1; i < (int)_Skyline.size();) {
+            auto &prev = _Skyline[i - 1];
+            auto &node = _Skyline[i];
+            auto overlap = prev.X + prev.Width - node.X;
+
+            if (overlap <= 0) break;
+
+            if (overlap >= node.Width) {
+                _Skyline.erase(_Skyline.begin() + i);
+            } else {
+                node.X += overlap;
+                node.Width -= overlap;
+                break;
+            }
+        }
+
+        // Merge neighbours at the same height
+        for (auto i = 0; i + 1 < (int)_Skyline.size();) {
+            if (_Skyline[i].Y == _Skyline[i + 1].Y) {
+                _Skyline[i].Width += _Skyline[i + 1].Width;
+                _Skyline.erase(_Skyline.begin() + i + 1);
+            } else i++;
+        }
+
+        _UsedHeight = std::max(_UsedHeight, bestBottom);
+        return true;
+    }
+
+    void SkylinePacker::Reset() {
+        _Skyline.clear();
+        _Skyline.push_back({0, 0, _Width});
+        _UsedHeight = 0;
+    }
+}
@@ -0,0 +1,100 @@
+/**********************************************************************************************
+*
+*   Ngine - The 2D game engine.
+*
+*   Copyright (C) 2019 NerdThings
+*
+*   LICENSE: Apache License 2.0
+*   View: https://github.com/NerdThings/Ngine/blob/master/LICENSE
+*
+**********************************************************************************************/
+
+#ifndef SKYLINEPACKER_H
+#define SKYLINEPACKER_H
+
+#include "../Ngine.h"
+
+#include <vector>
+
+namespace NerdThings::Ngine::Graphics {
+    /*
+     * Packs rectangles into a fixed area using the skyline bottom-left heuristic.
+     * Used for texture atlases.
+     */
+    class NEAPI SkylinePacker {
+        /*
+         * A horizontal segment of the skyline
+         */
+        struct SkylineNode {
+            int X;
+            int Y;
+            int Width;
+        };
+
+        // Private Fields
+
+        /*
+         * Packing area height
+         */
+        int _Height = 0;
+
+        /*
+         * The skyline, ordered left to right
+         */
+        std::vector<SkylineNode> _Skyline;
+
+        /*
+         * The lowest edge reached by a packed rectangle
+         */
+        int _UsedHeight = 0;
+
+        /*
+         * Packing area width
+         */
+        int _Width = 0;
+
+        // Private Methods
+
+        /*
+         * Get the Y position a rectangle would rest at when placed on a node, or -1 if it does not fit
+         */
+        int __Fit(int index_, int width_, int height_) const;
+    public:
+        // Public Constructor(s)
+
+        /*
+         * Create a packer for the given area
+         */
+        SkylinePacker(int width_, int height_);
+
+        // Public Methods
+
+        /*
+         * Get the height of the packing area
+         */
+        int GetHeight() const;
+
+        /*
+         * Get the lowest edge reached by a packed rectangle
+         */
+        int GetUsedHeight() const;
+
+        /*
+         * Get the width of the packing area
+         */
+        int GetWidth() const;
+
+        /*
+         * Pack a rectangle.
+         * Returns false if there is no room left for it.
+         */
+        bool Pack(int width_, int height_, int &x_, int &y_);
+
+        /*
+         * Remove all packed rectangles
+         */
+        void Reset();
+    };
+}
+
+#endif //SKYLINEPACKER_H
@@ -0,0 +1,217 @@
+/**********************************************************************************************
+*
+*   Ngine - The 2D game engine.
+*
+*   Copyright (C) 2019 NerdThings
+*
+*   LICENSE: Apache License 2.0
+*   View: https://github.com/NerdThings/Ngine/blob/master/LICENSE
+*
+**********************************************************************************************/
+
+#include "TextLayout.h"
+
+namespace NerdThings::Ngine::Graphics {
+    // Private Methods
+
+    void TextLayout::__Layout() {
+        _Dirty = false;
+        _Runs.clear();
+        _Size = Vector2();
+
+        if (_Font == nullptr) return;
+        _FontGeneration = _Font->GetGeneration();
+
+        if (_Text.empty() || _Font->BaseSize <= 0) return;
+
+        auto scaleFactor = _FontSize / (float)_Font->BaseSize;
+        auto lineHeight = (float)(_Font->BaseSize + _Font->BaseSize / 2) * scaleFactor;
+        auto glyphHeight = (float)_Font->BaseSize * scaleFactor;
+
+        // Decode characters and their advances
+        struct LayoutItem {
+            int Character;
+            int Glyph;
+            float Advance;
+        };
+
+        std::vector<LayoutItem> items;
+        items.reserve(_Text.length());
+
+        for (auto i = 0; i < (int)_Text.length();) {
+            int next;
+            auto character = Font::GetNextCodepoint(_Text, i, next);
+            auto glyph = _Font->GetGlyphIndex(character);
+            auto &info = _Font->GetGlyph(glyph);
+
+            auto advance = (info.AdvanceX == 0 ? info.Rectangle.Width : (float)info.AdvanceX) * scaleFactor + _Spacing;
+            items.push_back({character, glyph, advance});
+
+            i += next;
+        }
+
+        // Kerning with the following character
+        for (auto i = 0; i + 1 < (int)items.size(); i++)
+            items[i].Advance += _Font->GetKerning(items[i].Glyph, items[i + 1].Glyph) * scaleFactor;
+
+        // Break into lines, wrapping at the last space when a bound is set
+        std::vector<std::pair<int, int>> lines;
+        auto wrap = _Bounds.X > 0;
+        auto start = 0;
+        auto lastSpace = -1;
+        auto x = 0.0f;
+
+        for (auto i = 0; i < (int)items.size(); i++) {
+            auto character = items[i].Character;
+
+            if (character == '\n') {
+                lines.emplace_back(start, i);
+                start = i + 1;
+                lastSpace = -1;
+                x = 0;
+                continue;
+            }
+
+            if (wrap && i > start && x + items[i].Advance > _Bounds.X) {
+                if (lastSpace >= start) {
+                    lines.emplace_back(start, lastSpace);
+                    start = lastSpace + 1;
+                } else {
+                    lines.emplace_back(start, i);
+                    start = i;
+                }
+
+                lastSpace = -1;
+                x = 0;
+                for (auto j = start; j < i; j++) x += items[j].Advance;
+            }
+
+            if (character == ' ' || character == '\t') lastSpace = i;
+            x += items[i].Advance;
+        }
+
+        lines.emplace_back(start, (int)items.size());
+
+        // Build quads
+        for (auto line = 0; line < (int)lines.size(); line++) {
+            auto y = line * lineHeight;
+            if (_Bounds.Y > 0 && y + glyphHeight > _Bounds.Y) break;
+
+            x = 0;
+            for (auto i = lines[line].first; i < lines[line].second; i++) {
+                auto character = items[i].Character;
+                auto &info = _Font->GetGlyph(items[i].Glyph);
+
+                if (character != ' ' && character != '\t' && info.Rectangle.Width > 0 && info.Rectangle.Height > 0) {
+                    auto texture = _Font->GetTexture(info.Page);
+
+                    // Find the run for this page
+                    GlyphRun *run = nullptr;
+                    for (auto &r : _Runs) {
+                        if (r.Page == info.Page) {
+                            run = &r;
+                            break;
+                        }
+                    }
+
+                    if (run == nullptr) {
+                        _Runs.emplace_back();
+                        run = &_Runs.back();
+                        run->Page = info.Page;
+                    }
+
+                    auto left = x + info.OffsetX * scaleFactor;
+                    auto top = y + info.OffsetY * scaleFactor;
+                    auto right = left + info.Rectangle.Width * scaleFactor;
+                    auto bottom = top + info.Rectangle.Height * scaleFactor;
+
+                    auto u0 = info.Rectangle.X / texture->Width;
+                    auto v0 = info.Rectangle.Y / texture->Height;
+                    auto u1 = (info.Rectangle.X + info.Rectangle.Width) / texture->Width;
+                    auto v1 = (info.Rectangle.Y + info.Rectangle.Height) / texture->Height;
+
+                    run->Glyphs.push_back(items[i].Glyph);
+
+                    // Same corner order as Renderer::DrawTexture
+                    run->Positions.insert(run->Positions.end(), {left, top, left, bottom, right, bottom, right, top});
+                    run->TexCoords.insert(run->TexCoords.end(), {u0, v0, u0, v1, u1, v1, u1, v0});
+                }
+
+                x += items[i].Advance;
+            }
+
+            _Size.X = std::max(_Size.X, x);
+            _Size.Y = y + glyphHeight;
+        }
+
+        // Taken last, caching the glyphs above may have evicted others
+        _CacheGeneration = _Font->GetCacheGeneration();
+    }
+
+    bool TextLayout::__NeedsLayout() const {
+        if (_Dirty) return true;
+        if (_Font == nullptr) return false;
+
+        // An evicted font is loaded again into the same object, with a new glyph cache
+        if (_Font->GetGeneration() != _FontGeneration) return true;
+
+        // Evictions can move glyphs the layout refers to
+        return _Font->IsDynamic() && _Font->GetCacheGeneration() != _CacheGeneration;
+    }
+
+    // Public Constructor(s)
+
+    TextLayout::TextLayout() {}
+
+    TextLayout::TextLayout(Font *font_, const std::string &text_, float fontSize_, float spacing_, Vector2 bounds_)
+        : _Bounds(bounds_), _Font(font_), _FontSize(fontSize_), _Spacing(spacing_), _Text(text_) {}
+
+    // Public Methods
+
+    Vector2 TextLayout::GetBounds() const {
+        return _Bounds;
+    }
+
+    Font *TextLayout::GetFont() const {
+        return _Font;
+    }
+
+    float TextLayout::GetFontSize() const {
+        return _FontSize;
+    }
+
+    const std::vector<TextLayout::GlyphRun> &TextLayout::GetRuns() {
+        if (__NeedsLayout()) __Layout();
+        return _Runs;
+    }
+
+    Vector2 TextLayout::GetSize() {
+        if (__NeedsLayout()) __Layout();
+        return _Size;
+    }
+
+    float TextLayout::GetSpacing() const {
+        return _Spacing;
+    }
+
+    const std::string &TextLayout::GetText() const {
+        return _Text;
+    }
+
+    void TextLayout::Invalidate() {
+        _Dirty = true;
+    }
+
+    void TextLayout::Set(Font *font_, const std::string &text_, float fontSize_, float spacing_, Vector2 bounds_) {
+        // An evicted font is loaded again into the same object, so the pointer alone is not enough
+        auto sameFont = _Font == font_ && (font_ == nullptr || font_->GetGeneration() == _FontGeneration);
+        if (sameFont && _FontSize == fontSize_ && _Spacing == spacing_ && _Bounds == bounds_ && _Text == text_) return;
+
+        _Font = font_;
+        _Text = text_;
+        _FontSize = fontSize_;
+        _Spacing = spacing_;
+        _Bounds = bounds_;
+        _Dirty = true;
+    }
+}
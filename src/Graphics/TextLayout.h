@@ -0,0 +1,185 @@
+/**********************************************************************************************
+*
+*   Ngine - The 2D game engine.
+*
+*   Copyright (C) 2019 NerdThings
+*
+*   LICENSE: Apache License 2.0
+*   View: https://github.com/NerdThings/Ngine/blob/master/LICENSE
+*
+**********************************************************************************************/
+
+#ifndef TEXTLAYOUT_H
+#define TEXTLAYOUT_H
+
+#include "../Ngine.h"
+
+#include <vector>
+
+#include "../Vector2.h"
+#include "Font.h"
+
+namespace NerdThings::Ngine::Graphics {
+    /*
+     * Laid out text, ready to be drawn.
+     * Glyph quads are computed once and only recomputed when the font, text, size, spacing or bounds change.
+     * The layout keeps a pointer to the font, so pass the current font with Set each frame if it can be evicted or reloaded.
+     * A different font at the same address is detected by its generation.
+     * Draw with Renderer::DrawTextLayout.
+     */
+    class NEAPI TextLayout {
+    public:
+        /*
+         * Glyph quads that share an atlas page
+         */
+        struct GlyphRun {
+            /*
+             * The atlas page
+             */
+            int Page = 0;
+
+            /*
+             * Glyph indices in the font, one per quad
+             */
+            std::vector<int> Glyphs;
+
+            /*
+             * Quad positions, 4 corners per glyph relative to the layout origin
+             */
+            std::vector<float> Positions;
+
+            /*
+             * Quad texture coordinates, 4 corners per glyph
+             */
+            std::vector<float> TexCoords;
+        };
+    private:
+        // Private Fields
+
+        /*
+         * Layout bounds, 0 means unbounded
+         */
+        Vector2 _Bounds;
+
+        /*
+         * The font glyph cache generation the layout was built against
+         */
+        unsigned int _CacheGeneration = 0;
+
+        /*
+         * Whether or not the layout needs recomputing
+         */
+        bool _Dirty = true;
+
+        /*
+         * The font
+         */
+        Font *_Font = nullptr;
+
+        /*
+         * Generation of the font the layout was built against
+         */
+        unsigned int _FontGeneration = 0;
+
+        /*
+         * The font size
+         */
+        float _FontSize = 0;
+
+        /*
+         * Glyph runs, one per atlas page used
+         */
+        std::vector<GlyphRun> _Runs;
+
+        /*
+         * Measured size of the laid out text
+         */
+        Vector2 _Size;
+
+        /*
+         * Spacing between characters
+         */
+        float _Spacing = 0;
+
+        /*
+         * The text
+         */
+        std::string _Text;
+
+        // Private Methods
+
+        /*
+         * Compute glyph quads
+         */
+        void __Layout();
+
+        /*
+         * Whether the layout is out of date, including glyphs evicted from a dynamic font
+         */
+        bool __NeedsLayout() const;
+    public:
+        // Public Constructor(s)
+
+        /*
+         * Create an empty layout
+         */
+        TextLayout();
+
+        /*
+         * Create a layout.
+         * Text wraps at the bounds width and stops at the bounds height, a bound of 0 is unlimited.
+         */
+        TextLayout(Font *font_, const std::string &text_, float fontSize_, float spacing_, Vector2 bounds_ = Vector2());
+
+        // Public Methods
+
+        /*
+         * Get the layout bounds
+         */
+        Vector2 GetBounds() const;
+
+        /*
+         * Get the font
+         */
+        Font *GetFont() const;
+
+        /*
+         * Get the font size
+         */
+        float GetFontSize() const;
+
+        /*
+         * Get the glyph runs, laying out if required
+         */
+        const std::vector<GlyphRun> &GetRuns();
+
+        /*
+         * Get the size of the laid out text, laying out if required
+         */
+        Vector2 GetSize();
+
+        /*
+         * Get the character spacing
+         */
+        float GetSpacing() const;
+
+        /*
+         * Get the text
+         */
+        const std::string &GetText() const;
+
+        /*
+         * Force the layout to be recomputed on next use.
+         * Needed if the font itself is changed.
+         */
+        void Invalidate();
+
+        /*
+         * Set all layout inputs at once.
+         * The layout is only recomputed if something changed.
+         */
+        void Set(Font *font_, const std::string &text_, float fontSize_, float spacing_, Vector2 bounds_ = Vector2());
+    };
+}
+
+#endif //TEXTLAYOUT_H
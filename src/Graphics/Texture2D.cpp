@@ -14,33 +14,53 @@
 #include "Image.h"
 
 namespace NerdThings::Ngine::Graphics {
-    // Public Constructor(s)
-
-    Texture2D::Texture2D() {}
+    // Private Methods
 
-    Texture2D::Texture2D(unsigned char *data_, unsigned int width_, unsigned height_, PixelFormat format_, int mipmapCount_) {
+    void Texture2D::__Create(unsigned char *data_, unsigned int width_, unsigned height_, PixelFormat format_, int mipmapCount_) {
         Width = width_;
         Height = height_;
 #if defined(GRAPHICS_OPENGL33) || defined(GRAPHICS_OPENGL21) || defined(GRAPHICS_OPENGLES2)
-        // Get format
-        OpenGL::GLPixelFormat frmt = OpenGL::UNCOMPRESSED_GRAYSCALE;
-        if (format_ == UNCOMPRESSED_GRAY_ALPHA) frmt = OpenGL::UNCOMPRESSED_GRAY_ALPHA;
-        else if (format_ == UNCOMPRESSED_R8G8B8) frmt = OpenGL::UNCOMPRESSED_R8G8B8;
-        else if (format_ == UNCOMPRESSED_R8G8B8A8) frmt = OpenGL::UNCOMPRESSED_R8G8B8A8;
-        else throw std::runtime_error("Incompatible format.");
+        // Get format (the values are shared with the GL abstraction)
+        auto frmt = (OpenGL::GLPixelFormat)format_;
 
         InternalTexture = std::make_shared<OpenGL::GLTexture>(width_, height_, data_, mipmapCount_, frmt);
 #endif
     }
 
-    Texture2D::Texture2D(const Filesystem::Path &path_) {
+    void Texture2D::__CreateFromImage(Image &img_) {
+#if defined(GRAPHICS_OPENGL33) || defined(GRAPHICS_OPENGL21) || defined(GRAPHICS_OPENGLES2)
+        // Fall back to decompressing on the CPU
+        if (img_.IsCompressed() && !OpenGL::GLTexture::IsFormatSupported((OpenGL::GLPixelFormat)img_.Format)) {
+            ConsoleMessage("Compressed texture format not supported by the GPU, decompressing.", "WARN", "Texture2D");
+            img_.Decompress();
+        }
+#endif
+
         // Create
-        *this = Texture2D(std::make_shared<Image>(path_));
+        __Create(img_.PixelData, img_.Width, img_.Height, img_.Format, img_.Mipmaps);
+    }
+
+    // Public Constructor(s)
+
+    Texture2D::Texture2D() {}
+
+    Texture2D::Texture2D(unsigned char *data_, unsigned int width_, unsigned height_, PixelFormat format_, int mipmapCount_) {
+        __Create(data_, width_, height_, format_, mipmapCount_);
+    }
+
+    Texture2D::Texture2D(const Filesystem::Path &path_) {
+        // Decode, upload then free the pixels
+        Image img(path_);
+        __CreateFromImage(img);
+        img.Unload();
     }
 
     Texture2D::Texture2D(const std::shared_ptr<Image> &img_) {
-        // Create
-        *this = Texture2D(img_->PixelData, img_->Width, img_->Height, img_->Format, img_->Mipmaps);
+        __CreateFromImage(*img_);
+    }
+
+    Texture2D::Texture2D(const Texture2D &tex_) {
+        *this = tex_;
     }
 
     // Public Methods
@@ -49,6 +69,17 @@ namespace NerdThings::Ngine::Graphics {
         return std::make_shared<Texture2D>(img_);
     }
 
+    int Texture2D::GetDataSize() const {
+        auto dataSize = 0;
+#if defined(GRAPHICS_OPENGL33) || defined(GRAPHICS_OPENGL21) || defined(GRAPHICS_OPENGLES2)
+        if (InternalTexture == nullptr) return 0;
+
+        for (auto i = 0; i < InternalTexture->MipmapCount; i++)
+            dataSize += OpenGL::GLTexture::GetPixelDataSize(InternalTexture->GetMipmapWidth(i), InternalTexture->GetMipmapHeight(i), InternalTexture->GetFormat());
+#endif
+        return dataSize;
+    }
+
     int Texture2D::GetMipmapCount() const {
 #if defined(GRAPHICS_OPENGL33) || defined(GRAPHICS_OPENGL21) || defined(GRAPHICS_OPENGLES2)
         return InternalTexture->MipmapCount;
@@ -56,6 +87,10 @@ namespace NerdThings::Ngine::Graphics {
         return 0;
     }
 
+    bool Texture2D::IsReady() const {
+        return _Ready;
+    }
+
     bool Texture2D::IsValid() const {
         if (InternalTexture != nullptr)
 #if defined(GRAPHICS_OPENGL33) || defined(GRAPHICS_OPENGL21) || defined(GRAPHICS_OPENGLES2)
@@ -73,7 +108,22 @@ namespace NerdThings::Ngine::Graphics {
         return new Texture2D(path_);
     }
 
+    void Texture2D::SetPixelData(unsigned char *data_, int row_, int rowCount_) {
+        // Pending textures will upload their own data
+        if (!_Ready) return;
+#if defined(GRAPHICS_OPENGL33) || defined(GRAPHICS_OPENGL21) || defined(GRAPHICS_OPENGLES2)
+        if (InternalTexture != nullptr)
+            InternalTexture->UploadMipmap(0, data_, row_, rowCount_);
+#endif
+    }
+
     void Texture2D::SetTextureFilter(const TextureFilterMode filterMode_) const {
+        // Don't modify the placeholder, apply when uploaded
+        if (!_Ready) {
+            _PendingFilterMode = filterMode_;
+            return;
+        }
+
         switch(filterMode_) {
 #if defined(GRAPHICS_OPENGL33) || defined(GRAPHICS_OPENGL21) || defined(GRAPHICS_OPENGLES2)
             case FILTER_POINT:
@@ -88,7 +138,7 @@ namespace NerdThings::Ngine::Graphics {
             case FILTER_BILINEAR:
                 if (InternalTexture->MipmapCount > 1) {
                     InternalTexture->SetParameter(OpenGL::TEXPARAM_MIN_FILTER, OpenGL::FILTER_FUNC_LINEAR_MIP_NEAREST);
-                    InternalTexture->SetParameter(OpenGL::TEXPARAM_MAG_FILTER, OpenGL::FILTER_FUNC_NEAREST);
+                    InternalTexture->SetParameter(OpenGL::TEXPARAM_MAG_FILTER, OpenGL::FILTER_FUNC_LINEAR);
                 } else {
                     InternalTexture->SetParameter(OpenGL::TEXPARAM_MIN_FILTER, OpenGL::FILTER_FUNC_LINEAR);
                     InternalTexture->SetParameter(OpenGL::TEXPARAM_MAG_FILTER, OpenGL::FILTER_FUNC_LINEAR);
@@ -96,7 +146,7 @@ namespace NerdThings::Ngine::Graphics {
                 break;
             case FILTER_TRILINEAR:
                 if (InternalTexture->MipmapCount > 1) {
-                    InternalTexture->SetParameter(OpenGL::TEXPARAM_MIN_FILTER, OpenGL::FILTER_FUNC_MIP_NEAREST);
+                    InternalTexture->SetParameter(OpenGL::TEXPARAM_MIN_FILTER, OpenGL::FILTER_FUNC_MIP_LINEAR);
                     InternalTexture->SetParameter(OpenGL::TEXPARAM_MAG_FILTER, OpenGL::FILTER_FUNC_LINEAR);
                 } else {
                     InternalTexture->SetParameter(OpenGL::TEXPARAM_MIN_FILTER, OpenGL::FILTER_FUNC_LINEAR);
@@ -118,6 +168,12 @@ namespace NerdThings::Ngine::Graphics {
     }
 
     void Texture2D::SetTextureWrap(const TextureWrapMode wrapMode_) const {
+        // Don't modify the placeholder, apply when uploaded
+        if (!_Ready) {
+            _PendingWrapMode = wrapMode_;
+            return;
+        }
+
         switch (wrapMode_) {
 #if defined(GRAPHICS_OPENGL33) || defined(GRAPHICS_OPENGL21) || defined(GRAPHICS_OPENGLES2)
             case WRAP_REPEAT:
@@ -144,6 +200,11 @@ namespace NerdThings::Ngine::Graphics {
         // Delete texture data
         Width = 0;
         Height = 0;
+
+        // Cancels any pending upload
+        _Ready = true;
+        _PendingFilterMode = -1;
+        _PendingWrapMode = -1;
 #if defined(GRAPHICS_OPENGL33) || defined(GRAPHICS_OPENGL21) || defined(GRAPHICS_OPENGLES2)
         InternalTexture = nullptr;
 #endif
@@ -164,4 +225,16 @@ namespace NerdThings::Ngine::Graphics {
 #endif
         return true;
     }
+
+    Texture2D &Texture2D::operator=(const Texture2D &tex_) {
+        Height = tex_.Height;
+#if defined(GRAPHICS_OPENGL33) || defined(GRAPHICS_OPENGL21) || defined(GRAPHICS_OPENGLES2)
+        InternalTexture = tex_.InternalTexture;
+#endif
+        Width = tex_.Width;
+        _PendingFilterMode = tex_._PendingFilterMode;
+        _PendingWrapMode = tex_._PendingWrapMode;
+        _Ready = tex_._Ready.load();
+        return *this;
+    }
 }
@@ -14,6 +14,8 @@
 
 #include "../Ngine.h"
 
+#include <atomic>
+
 #if defined(GRAPHICS_OPENGL33) || defined(GRAPHICS_OPENGL21) || defined(GRAPHICS_OPENGLES2)
 #include "OpenGL/Texture.h"
 #endif
@@ -87,6 +89,8 @@ namespace NerdThings::Ngine::Graphics {
      * A 2D Texture stored in the GPU memory
      */
     struct NEAPI Texture2D : public IResource {
+        friend class TextureUploadQueue;
+
         // Public Fields
 
         /*
@@ -120,14 +124,21 @@ namespace NerdThings::Ngine::Graphics {
 
         /*
          * Load a texture file.
+         * The decoded pixels are uploaded and freed straight away.
          */
         Texture2D(const Filesystem::Path &path_);
 
         /*
          * Create a texture from an image.
+         * Compressed images that the GPU does not support are decompressed in place.
          */
         Texture2D(const std::shared_ptr<Image> &img_);
 
+        /*
+         * Copy a texture
+         */
+        Texture2D(const Texture2D &tex_);
+
         // Public Methods
 
         /*
@@ -135,11 +146,22 @@ namespace NerdThings::Ngine::Graphics {
          */
         static std::shared_ptr<Texture2D> FromImage(const std::shared_ptr<Image> &img_);
 
+        /*
+         * Get the size of the texture data in video memory, including mipmaps
+         */
+        int GetDataSize() const;
+
         /*
          * Get the number of mipmaps this texture has
          */
         int GetMipmapCount() const;
 
+        /*
+         * Whether or not the texture data has finished uploading.
+         * A pending texture renders using the upload queue placeholder.
+         */
+        bool IsReady() const;
+
         /*
          * Is the texture valid and ready for use
          */
@@ -156,6 +178,13 @@ namespace NerdThings::Ngine::Graphics {
          */
         static Texture2D *LoadTexture(const Filesystem::Path &path_);
 
+        /*
+         * Replace a band of rows in the top mipmap.
+         * The data must be in the texture's format and start at the given row.
+         * A row count of -1 replaces the whole mipmap.
+         */
+        void SetPixelData(unsigned char *data_, int row_ = 0, int rowCount_ = -1);
+
         /*
          * Set the texture filter mode
          */
@@ -180,7 +209,37 @@ namespace NerdThings::Ngine::Graphics {
         /*
          * Copy a texture
          */
-        Texture2D &operator=(const Texture2D &tex_) = default;
+        Texture2D &operator=(const Texture2D &tex_);
+    private:
+        // Private Fields
+
+        /*
+         * Filter mode to apply once the upload has finished (-1 for none)
+         */
+        mutable int _PendingFilterMode = -1;
+
+        /*
+         * Wrap mode to apply once the upload has finished (-1 for none)
+         */
+        mutable int _PendingWrapMode = -1;
+
+        /*
+         * Whether or not the texture data has finished uploading.
+         * Set by the upload queue, may be read from any thread.
+         */
+        std::atomic<bool> _Ready{true};
+
+        // Private Methods
+
+        /*
+         * Create the internal texture
+         */
+        void __Create(unsigned char *data_, unsigned int width_, unsigned height_, PixelFormat format_, int mipmapCount_);
+
+        /*
+         * Create the internal texture from an image, decompressing if required
+         */
+        void __CreateFromImage(Image &img_);
     };
 }
 
@@ -0,0 +1,190 @@
+/**********************************************************************************************
+*
+*   Ngine - The 2D game engine.
+*
+*   Copyright (C) 2019 NerdThings
+*
+*   LICENSE: Apache License 2.0
+*   View: https://github.com/NerdThings/Ngine/blob/master/LICENSE
+*
+**********************************************************************************************/
+
+#include "TextureUploadQueue.h"
+
+#if defined(GRAPHICS_OPENGL33) || defined(GRAPHICS_OPENGL21) || defined(GRAPHICS_OPENGLES2)
+#include "OpenGL/OpenGL.h"
+#endif
+
+namespace NerdThings::Ngine::Graphics {
+    // Private Fields
+
+    std::deque<TextureUploadQueue::UploadJob> TextureUploadQueue::_ActiveJobs;
+    std::deque<TextureUploadQueue::UploadJob> TextureUploadQueue::_IncomingJobs;
+    std::mutex TextureUploadQueue::_IncomingLock;
+    std::atomic<int> TextureUploadQueue::_PendingCount(0);
+
+    // Private Methods
+
+    void TextureUploadQueue::__Complete(UploadJob &job_, const std::shared_ptr<Texture2D> &target_) {
+#if defined(GRAPHICS_OPENGL33) || defined(GRAPHICS_OPENGL21) || defined(GRAPHICS_OPENGLES2)
+        // Swap in the real texture
+        target_->InternalTexture = job_.Texture;
+#endif
+        target_->_Ready = true;
+
+        // Apply any settings made while pending
+        if (target_->_PendingFilterMode >= 0) target_->SetTextureFilter((TextureFilterMode)target_->_PendingFilterMode);
+        if (target_->_PendingWrapMode >= 0) target_->SetTextureWrap((TextureWrapMode)target_->_PendingWrapMode);
+        target_->_PendingFilterMode = -1;
+        target_->_PendingWrapMode = -1;
+    }
+
+    // Public Fields
+
+    int TextureUploadQueue::ByteBudget = 4 * 1024 * 1024;
+    std::shared_ptr<Texture2D> TextureUploadQueue::Placeholder = nullptr;
+    double TextureUploadQueue::TimeBudget = 2.0;
+    bool TextureUploadQueue::UsePixelBuffers = true;
+
+    // Public Methods
+
+    void TextureUploadQueue::Clear() {
+        std::deque<UploadJob> dropped;
+        {
+            std::lock_guard<std::mutex> lock(_IncomingLock);
+            dropped.swap(_IncomingJobs);
+        }
+
+        for (auto &job : _ActiveJobs) dropped.push_back(std::move(job));
+        _ActiveJobs.clear();
+
+        // Nothing will upload these now, don't leave them waiting
+        for (auto &job : dropped) {
+            auto target = job.Target.lock();
+            if (target != nullptr && !target->_Ready) target->Unload();
+        }
+
+        _PendingCount -= (int)dropped.size();
+    }
+
+    std::shared_ptr<Texture2D> TextureUploadQueue::Enqueue(const std::shared_ptr<Image> &image_) {
+        if (image_ == nullptr || !image_->IsValid())
+            throw std::runtime_error("Cannot upload an invalid image.");
+
+#if defined(GRAPHICS_OPENGL33) || defined(GRAPHICS_OPENGL21) || defined(GRAPHICS_OPENGLES2)
+        // Decompress on this thread if the GPU can't use the format
+        if (image_->IsCompressed() && !OpenGL::GLTexture::IsFormatSupported((OpenGL::GLPixelFormat)image_->Format))
+            image_->Decompress();
+#endif
+
+        // Create pending texture
+        auto texture = std::make_shared<Texture2D>();
+        texture->Width = image_->Width;
+        texture->Height = image_->Height;
+        texture->_Ready = false;
+#if defined(GRAPHICS_OPENGL33) || defined(GRAPHICS_OPENGL21) || defined(GRAPHICS_OPENGLES2)
+        texture->InternalTexture = Placeholder != nullptr ? Placeholder->InternalTexture : OpenGL::GL::DefaultTexture;
+#endif
+
+        // Queue job
+        UploadJob job;
+        job.Source = image_;
+        job.Target = texture;
+
+        std::lock_guard<std::mutex> lock(_IncomingLock);
+        _IncomingJobs.push_back(std::move(job));
+        _PendingCount++;
+        return texture;
+    }
+
+    int TextureUploadQueue::GetPendingCount() {
+        return _PendingCount;
+    }
+
+    void TextureUploadQueue::Process() {
+        // Take incoming jobs
+        {
+            std::lock_guard<std::mutex> lock(_IncomingLock);
+            while (!_IncomingJobs.empty()) {
+                _ActiveJobs.push_back(std::move(_IncomingJobs.front()));
+                _IncomingJobs.pop_front();
+            }
+        }
+
+        if (_ActiveJobs.empty()) return;
+
+#if defined(GRAPHICS_OPENGL33) || defined(GRAPHICS_OPENGL21) || defined(GRAPHICS_OPENGLES2)
+        auto started = std::chrono::high_resolution_clock::now();
+        auto timeBudget = std::chrono::duration<double, std::milli>(TimeBudget);
+        auto uploaded = 0;
+
+        while (!_ActiveJobs.empty()) {
+            auto &job = _ActiveJobs.front();
+
+            // Skip textures that have been dropped or unloaded
+            auto target = job.Target.lock();
+            if (target == nullptr || target->_Ready) {
+                _ActiveJobs.pop_front();
+                _PendingCount--;
+                continue;
+            }
+
+            // Check budget, always upload at least one step a frame
+            if (uploaded > 0 && (uploaded >= ByteBudget || std::chrono::high_resolution_clock::now() - started >= timeBudget))
+                break;
+
+            auto image = job.Source;
+            auto format = (OpenGL::GLPixelFormat)image->Format;
+
+            // Create storage on first step
+            if (job.Texture == nullptr) {
+                job.Texture = std::make_shared<OpenGL::GLTexture>(image->Width, image->Height, image->Mipmaps, format);
+
+                if (job.Texture->ID == 0) {
+                    ConsoleMessage("Failed to create texture for upload.", "WARN", "TextureUploadQueue");
+                    target->Unload();
+                    _ActiveJobs.pop_front();
+                    _PendingCount--;
+                    continue;
+                }
+            }
+
+            auto mipWidth = job.Texture->GetMipmapWidth(job.Mipmap);
+            auto mipHeight = job.Texture->GetMipmapHeight(job.Mipmap);
+            auto mipSize = OpenGL::GLTexture::GetPixelDataSize(mipWidth, mipHeight, format);
+            auto mipData = image->PixelData + job.MipmapOffset;
+
+            if (format < OpenGL::COMPRESSED_DXT1_RGB) {
+                // Upload as many rows as fit the remaining budget
+                auto rowSize = OpenGL::GLTexture::GetPixelDataSize(mipWidth, 1, format);
+                auto rows = (ByteBudget - uploaded) / rowSize;
+                if (rows < 1) rows = 1;
+                if (rows > (int)mipHeight - job.Row) rows = mipHeight - job.Row;
+
+                job.Texture->UploadMipmap(job.Mipmap, mipData + rowSize * job.Row, job.Row, rows, UsePixelBuffers);
+                job.Row += rows;
+                uploaded += rowSize * rows;
+            } else {
+                // Compressed levels go up whole
+                job.Texture->UploadMipmap(job.Mipmap, mipData);
+                job.Row = mipHeight;
+                uploaded += mipSize;
+            }
+
+            // Move to next mipmap
+            if (job.Row >= (int)mipHeight) {
+                job.Mipmap++;
+                job.MipmapOffset += mipSize;
+                job.Row = 0;
+            }
+
+            // Finish
+            if (job.Mipmap >= image->Mipmaps) {
+                __Complete(job, target);
+                _ActiveJobs.pop_front();
+                _PendingCount--;
+            }
+        }
+#endif
+    }
+}
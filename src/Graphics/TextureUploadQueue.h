@@ -0,0 +1,150 @@
+/**********************************************************************************************
+*
+*   Ngine - The 2D game engine.
+*
+*   Copyright (C) 2019 NerdThings
+*
+*   LICENSE: Apache License 2.0
+*   View: https://github.com/NerdThings/Ngine/blob/master/LICENSE
+*
+**********************************************************************************************/
+
+#ifndef TEXTUREUPLOADQUEUE_H
+#define TEXTUREUPLOADQUEUE_H
+
+#include "../Ngine.h"
+
+#include <atomic>
+#include <deque>
+#include <mutex>
+
+#include "Image.h"
+#include "Texture2D.h"
+
+namespace NerdThings::Ngine::Graphics {
+    /*
+     * Uploads textures to the GPU over a number of frames.
+     * Images may be queued from any thread, the queue is processed on the main thread within a per-frame budget.
+     */
+    class NEAPI TextureUploadQueue {
+        /*
+         * A texture being uploaded
+         */
+        struct UploadJob {
+            /*
+             * The image being uploaded
+             */
+            std::shared_ptr<Image> Source;
+
+            /*
+             * The texture to upload to
+             */
+            std::weak_ptr<Texture2D> Target;
+
+#if defined(GRAPHICS_OPENGL33) || defined(GRAPHICS_OPENGL21) || defined(GRAPHICS_OPENGLES2)
+            /*
+             * The texture being filled
+             */
+            std::shared_ptr<OpenGL::GLTexture> Texture;
+#endif
+
+            /*
+             * The next mipmap level to upload
+             */
+            int Mipmap = 0;
+
+            /*
+             * Byte offset of the next mipmap level
+             */
+            int MipmapOffset = 0;
+
+            /*
+             * The next row of the mipmap level to upload
+             */
+            int Row = 0;
+        };
+
+        // Private Fields
+
+        /*
+         * Jobs being processed, only touched by the main thread
+         */
+        static std::deque<UploadJob> _ActiveJobs;
+
+        /*
+         * Jobs queued since the last process
+         */
+        static std::deque<UploadJob> _IncomingJobs;
+
+        /*
+         * Lock for incoming jobs
+         */
+        static std::mutex _IncomingLock;
+
+        /*
+         * Number of incoming and active jobs
+         */
+        static std::atomic<int> _PendingCount;
+
+        // Private Methods
+
+        /*
+         * Finish a job and swap the texture in
+         */
+        static void __Complete(UploadJob &job_, const std::shared_ptr<Texture2D> &target_);
+    public:
+        // Public Fields
+
+        /*
+         * Maximum number of bytes uploaded per frame.
+         * At least one step is always uploaded so that the queue makes progress.
+         */
+        static int ByteBudget;
+
+        /*
+         * Texture shown while an upload is pending.
+         * If null, the default white texture is used.
+         * This should be set before any uploads are queued.
+         */
+        static std::shared_ptr<Texture2D> Placeholder;
+
+        /*
+         * Maximum time spent uploading per frame, in milliseconds
+         */
+        static double TimeBudget;
+
+        /*
+         * Whether or not to stage uploads through pixel buffers when supported
+         */
+        static bool UsePixelBuffers;
+
+        // Public Methods
+
+        /*
+         * Drop all pending uploads.
+         * Pending textures are unloaded, so they become ready and invalid.
+         * Must be called on the main thread.
+         */
+        static void Clear();
+
+        /*
+         * Queue an image for upload.
+         * This may be called from any thread, the returned texture shows the placeholder until it is ready.
+         * Compressed images that the GPU does not support are decompressed on the calling thread.
+         */
+        static std::shared_ptr<Texture2D> Enqueue(const std::shared_ptr<Image> &image_);
+
+        /*
+         * Get the number of textures waiting to be uploaded
+         */
+        static int GetPendingCount();
+
+        /*
+         * Upload pending textures within the frame budget.
+         * Must be called on the main thread, this is called by the game loop every frame.
+         */
+        static void Process();
+    };
+}
+
+#endif //TEXTUREUPLOADQUEUE_H
@@ -20,6 +20,13 @@ namespace NerdThings::Ngine {
      */
     class IResource {
     public:
+        // Destructor
+
+        /*
+         * Resources are deleted through this interface by resource tables.
+         */
+        virtual ~IResource() = default;
+
         // Public Methods
 
         /*
@@ -0,0 +1,167 @@
+/**********************************************************************************************
+*
+*   Ngine - The 2D game engine.
+*
+*   Copyright (C) 2019 NerdThings
+*
+*   LICENSE: Apache License 2.0
+*   View: https://github.com/NerdThings/Ngine/blob/master/LICENSE
+*
+**********************************************************************************************/
+
+#include "ThreadPool.h"
+
+#include <atomic>
+#include <exception>
+
+namespace NerdThings::Ngine {
+    // Private Fields
+
+    std::condition_variable ThreadPool::_Condition;
+    std::mutex ThreadPool::_Lock;
+    bool ThreadPool::_Running = false;
+    std::deque<std::function<void()>> ThreadPool::_Tasks;
+    std::vector<std::thread> ThreadPool::_Workers;
+
+    // Private Methods
+
+    void ThreadPool::__Push(std::function<void()> task_) {
+        Initialize();
+
+        {
+            std::unique_lock<std::mutex> lock(_Lock);
+            _Tasks.push_back(std::move(task_));
+        }
+
+        _Condition.notify_one();
+    }
+
+    void ThreadPool::__WorkerLoop() {
+        while (true) {
+            std::function<void()> task;
+
+            {
+                std::unique_lock<std::mutex> lock(_Lock);
+                _Condition.wait(lock, []() { return !_Running || !_Tasks.empty(); });
+
+                if (!_Running && _Tasks.empty()) return;
+
+                task = std::move(_Tasks.front());
+                _Tasks.pop_front();
+            }
+
+            try {
+                task();
+            } catch (std::exception &e) {
+                ConsoleMessage("Task threw an exception: " + std::string(e.what()), "ERR", "ThreadPool");
+            } catch (...) {
+                ConsoleMessage("Task threw an unknown exception.", "ERR", "ThreadPool");
+            }
+        }
+    }
+
+    // Public Methods
+
+    int ThreadPool::GetThreadCount() {
+        Initialize();
+        std::unique_lock<std::mutex> lock(_Lock);
+        return (int)_Workers.size();
+    }
+
+    void ThreadPool::Initialize(int threadCount_) {
+        std::unique_lock<std::mutex> lock(_Lock);
+        if (_Running) return;
+
+        if (threadCount_ <= 0) {
+            threadCount_ = (int)std::thread::hardware_concurrency() - 1;
+            if (threadCount_ < 1) threadCount_ = 1;
+        }
+
+        _Running = true;
+        for (auto i = 0; i < threadCount_; i++)
+            _Workers.emplace_back(__WorkerLoop);
+
+        ConsoleMessage("Started " + std::to_string(threadCount_) + " worker threads.", "NOTICE", "ThreadPool");
+    }
+
+    void ThreadPool::ParallelFor(int begin_, int end_, const std::function<void(int, int)> &func_, int grain_) {
+        auto count = end_ - begin_;
+        if (count <= 0) return;
+        if (grain_ < 1) grain_ = 1;
+
+        // Split into a few chunks per thread so uneven work balances out
+        auto threads = GetThreadCount();
+        auto chunks = std::min((count + grain_ - 1) / grain_, (threads + 1) * 4);
+
+        if (chunks <= 1) {
+            func_(begin_, end_);
+            return;
+        }
+
+        auto chunkSize = (count + chunks - 1) / chunks;
+        chunks = (count + chunkSize - 1) / chunkSize;
+
+        struct ForState {
+            std::atomic<int> Next{0};
+            std::atomic<int> Done{0};
+            std::atomic<bool> Failed{false};
+            std::exception_ptr Error;
+            std::mutex Lock;
+            std::condition_variable Finished;
+        };
+
+        auto state = std::make_shared<ForState>();
+
+        // Each runner claims chunks until none are left.
+        // func_ is only touched while a chunk is claimed, and every chunk is counted even if it throws.
+        // The caller waits for all of them, so late runners never see a dangling reference.
+        auto runner = [state, begin_, end_, chunks, chunkSize, &func_]() {
+            int chunk;
+            while ((chunk = state->Next.fetch_add(1)) < chunks) {
+                // Skip the remaining chunks once one has failed
+                if (!state->Failed) {
+                    try {
+                        auto from = begin_ + chunk * chunkSize;
+                        func_(from, std::min(end_, from + chunkSize));
+                    } catch (...) {
+                        std::unique_lock<std::mutex> lock(state->Lock);
+                        if (!state->Failed) state->Error = std::current_exception();
+                        state->Failed = true;
+                    }
+                }
+
+                if (state->Done.fetch_add(1) + 1 == chunks) {
+                    std::unique_lock<std::mutex> lock(state->Lock);
+                    state->Finished.notify_all();
+                }
+            }
+        };
+
+        auto helpers = std::min(threads, chunks - 1);
+        for (auto i = 0; i < helpers; i++)
+            __Push(runner);
+
+        // Work on this thread too, then wait for chunks claimed by helpers
+        runner();
+
+        std::unique_lock<std::mutex> lock(state->Lock);
+        state->Finished.wait(lock, [&state, chunks]() { return state->Done.load() == chunks; });
+
+        // Pass the first failure on to the caller
+        if (state->Error != nullptr) std::rethrow_exception(state->Error);
+    }
+
+    void ThreadPool::Shutdown() {
+        {
+            std::unique_lock<std::mutex> lock(_Lock);
+            if (!_Running) return;
+            _Running = false;
+        }
+
+        _Condition.notify_all();
+
+        for (auto &worker : _Workers)
+            worker.join();
+        _Workers.clear();
+    }
+}
@@ -0,0 +1,114 @@
+/**********************************************************************************************
+*
+*   Ngine - The 2D game engine.
+*
+*   Copyright (C) 2019 NerdThings
+*
+*   LICENSE: Apache License 2.0
+*   View: https://github.com/NerdThings/Ngine/blob/master/LICENSE
+*
+**********************************************************************************************/
+
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include "Ngine.h"
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <vector>
+
+namespace NerdThings::Ngine {
+    /*
+     * Shared pool of worker threads.
+     * The pool is started on first use, or with Initialize.
+     */
+    class NEAPI ThreadPool {
+        // Private Fields
+
+        /*
+         * Signalled when a task is queued or the pool stops
+         */
+        static std::condition_variable _Condition;
+
+        /*
+         * Lock for the task queue
+         */
+        static std::mutex _Lock;
+
+        /*
+         * Whether or not the workers are running
+         */
+        static bool _Running;
+
+        /*
+         * Queued tasks
+         */
+        static std::deque<std::function<void()>> _Tasks;
+
+        /*
+         * The worker threads
+         */
+        static std::vector<std::thread> _Workers;
+
+        // Private Methods
+
+        /*
+         * Queue a task, starting the pool if required
+         */
+        static void __Push(std::function<void()> task_);
+
+        /*
+         * Worker thread loop
+         */
+        static void __WorkerLoop();
+    public:
+        // Public Methods
+
+        /*
+         * Queue a function to run on a worker thread.
+         * Returns a future for the result.
+         */
+        template <typename Func>
+        static std::future<std::invoke_result_t<Func>> Enqueue(Func func_) {
+            using ReturnType = std::invoke_result_t<Func>;
+
+            // packaged_task is move-only, std::function needs a copyable target
+            auto task = std::make_shared<std::packaged_task<ReturnType()>>(std::move(func_));
+            auto future = task->get_future();
+            __Push([task]() { (*task)(); });
+            return future;
+        }
+
+        /*
+         * Get the number of worker threads.
+         * This starts the pool if it is not running.
+         */
+        static int GetThreadCount();
+
+        /*
+         * Start the worker threads.
+         * A thread count of 0 uses one less than the number of hardware threads.
+         */
+        static void Initialize(int threadCount_ = 0);
+
+        /*
+         * Run a function over the range [begin, end) in chunks of at least grain elements.
+         * The calling thread takes part and the call returns once every chunk is complete.
+         * Safe to call from a worker thread, the caller will finish the work itself if the pool is busy.
+         * If the function throws, the remaining chunks are skipped and the first exception is rethrown once running chunks finish.
+         */
+        static void ParallelFor(int begin_, int end_, const std::function<void(int, int)> &func_, int grain_ = 1);
+
+        /*
+         * Stop the worker threads.
+         * Queued tasks are completed first.
+         */
+        static void Shutdown();
+    };
+}
+
+#endif //THREADPOOL_H
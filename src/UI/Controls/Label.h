@@ -46,6 +46,11 @@ namespace NerdThings::Ngine::UI::Controls {
          */
         bool _IsFixedSize = false;
 
+        /*
+         * Cached text layout, only recomputed when the text, font or bounds change
+         */
+        Graphics::TextLayout _Layout;
+
         /*
          * The text in the label
          */
@@ -87,9 +92,10 @@ namespace NerdThings::Ngine::UI::Controls {
 
             auto controlContentRect = style.GetContentRect(GetRenderRectangle());
 
-            if (_Font != nullptr && style.DrawDefaults)
-                Graphics::Renderer::DrawTextRect(_Font, _Text, controlContentRect, _FontSize, _FontSpacing,
-                                                 style.ForeColor); // TODO: Wordwrap option
+            if (_Font != nullptr && style.DrawDefaults) {
+                _Layout.Set(_Font, _Text, _FontSize, _FontSpacing, {controlContentRect.Width, controlContentRect.Height}); // TODO: Wordwrap option
+                Graphics::Renderer::DrawTextLayout(&_Layout, {controlContentRect.X, controlContentRect.Y}, style.ForeColor);
+            }
         }
 
         Graphics::Font *GetFont() {
@@ -0,0 +1,276 @@
+/**********************************************************************************************
+*
+*   Ngine - The 2D game engine.
+*
+*   Copyright (C) 2019 NerdThings
+*
+*   LICENSE: Apache License 2.0
+*   View: https://github.com/NerdThings/Ngine/blob/master/LICENSE
+*
+**********************************************************************************************/
+
+#include <Ngine.h>
+
+#include <Audio/AudioDevice.h>
+#include <Audio/Wave.h>
+#include <Filesystem/DirectoryIterator.h>
+#include <Filesystem/Filesystem.h>
+#include <Filesystem/Manifest.h>
+#include <Graphics/Font.h>
+#include <Graphics/Image.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <cstring>
+
+using namespace NGINE_NS;
+using namespace NGINE_NS::Filesystem;
+
+/*
+ * Cook options
+ */
+struct CookOptions {
+    /*
+     * Compress textures to DXT
+     */
+    bool Compress = false;
+
+    /*
+     * Base size of cooked fonts
+     */
+    int FontSize = 36;
+
+    /*
+     * Cook every file, even if its output is up to date
+     */
+    bool Force = false;
+
+    /*
+     * Generate texture mipmaps
+     */
+    bool Mipmaps = true;
+};
+
+/*
+ * Get the size of a file
+ */
+unsigned long long GetFileSize(const Path &path_) {
+    auto file = File(path_);
+    if (!file.Open(MODE_READ, true)) return 0;
+
+    auto size = file.GetSize();
+    file.Close();
+    return (unsigned long long)size;
+}
+
+/*
+ * Get the time a file was last modified, 0 if it does not exist
+ */
+long long GetModifiedTime(const Path &path_) {
+    struct stat info;
+    if (stat(path_.GetString().c_str(), &info) != 0) return 0;
+    return (long long)info.st_mtime;
+}
+
+/*
+ * Check whether an extension is in a list
+ */
+bool HasExtension(const std::vector<std::string> &exts_, const std::string &ext_) {
+    return std::find(exts_.begin(), exts_.end(), ext_) != exts_.end();
+}
+
+/*
+ * Create a directory and any missing parents
+ */
+void CreateDirectories(const Path &path_) {
+    if (path_.GetResourceType() == TYPE_DIRECTORY) return;
+    CreateDirectories(path_.GetParent());
+    Directory(path_).Create();
+}
+
+/*
+ * Copy a file as it is
+ */
+bool CopyFile(const Path &inPath_, const Path &outPath_) {
+    struct stat info;
+    if (stat(inPath_.GetString().c_str(), &info) != 0) return false;
+
+    // Empty files cannot be mapped, so they are copied by creating an empty file
+    std::unique_ptr<FileMapping> mapping;
+    if (info.st_size > 0) {
+        try {
+            mapping = File(inPath_).Map();
+        } catch (std::exception &e) {
+            ConsoleMessage("Failed to read " + inPath_.GetString() + ": " + std::string(e.what()), "ERR", "NgineCook");
+            return false;
+        }
+    }
+
+    auto out = File(outPath_);
+    if (!out.Open(MODE_WRITE, true)) return false;
+
+    auto success = mapping == nullptr || out.WriteBytes((unsigned char *)mapping->GetData(), mapping->GetSize());
+    out.Close();
+    return success;
+}
+
+/*
+ * Rasterize a font into an atlas with glyph metrics
+ */
+bool CookFont(const Path &inPath_, const Path &outPath_, const CookOptions &options_) {
+    auto font = Graphics::Font::RasterizeTTFFont(inPath_, options_.FontSize);
+    if (font == nullptr || font == Graphics::Font::GetDefaultFont()) return false;
+
+    auto success = font->Export(outPath_);
+    font->Unload();
+    delete font;
+    return success;
+}
+
+/*
+ * Decode a sound and convert it to the device format
+ */
+bool CookSound(const Path &inPath_, const Path &outPath_) {
+    auto wave = Audio::Wave::LoadWave(inPath_);
+    auto success = false;
+
+    if (wave->IsValid()) {
+        wave->ConvertFormat(DEVICE_SAMPLE_RATE, 32, DEVICE_CHANNELS);
+        success = wave->Export(outPath_);
+    }
+
+    delete wave;
+    return success;
+}
+
+/*
+ * Decode a texture, generate its mipmaps and optionally compress it
+ */
+bool CookTexture(const Path &inPath_, const Path &outPath_, const CookOptions &options_) {
+    Graphics::Image image(inPath_);
+    if (!image.IsValid()) return false;
+
+    if (options_.Mipmaps && !image.IsCompressed() && image.Mipmaps <= 1) image.GenerateMipmaps();
+
+    // Keep alpha where the image has it
+    if (options_.Compress && !image.IsCompressed()) {
+        auto alpha = image.Format == Graphics::UNCOMPRESSED_R8G8B8A8 || image.Format == Graphics::UNCOMPRESSED_GRAY_ALPHA;
+        image.Compress(alpha ? Graphics::COMPRESSED_DXT5_RGBA : Graphics::COMPRESSED_DXT1_RGB);
+    }
+
+    auto success = image.Export(outPath_);
+    image.Unload();
+    return success;
+}
+
+/*
+ * Cooks a content directory into load-ready native formats with a manifest.
+ * Fonts become nfnt atlases, sounds become nwav in the device format and textures become nimg with mipmaps.
+ * Music is copied as it is, so it still streams. Other files are copied as they are and left out of the manifest.
+ * Outputs newer than their source are kept, use --force to cook everything again after changing options.
+ * Usage: NgineCook <content directory> <output directory> [--compress] [--no-mipmaps] [--font-size <size>] [--force]
+ */
+int main(int argc, char **argv) {
+    if (argc < 3) {
+        ConsoleMessage("Usage: NgineCook <content directory> <output directory> [--compress] [--no-mipmaps] [--font-size <size>] [--force]", "ERR", "NgineCook");
+        return 1;
+    }
+
+    CookOptions options;
+    for (auto i = 3; i < argc; i++) {
+        if (strcmp(argv[i], "--compress") == 0) options.Compress = true;
+        else if (strcmp(argv[i], "--no-mipmaps") == 0) options.Mipmaps = false;
+        else if (strcmp(argv[i], "--font-size") == 0 && i + 1 < argc) options.FontSize = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--force") == 0) options.Force = true;
+        else {
+            ConsoleMessage("Unknown option " + std::string(argv[i]) + ".", "ERR", "NgineCook");
+            return 1;
+        }
+    }
+
+    auto contentDir = Directory(Path(argv[1]));
+    if (!contentDir.Exists()) {
+        ConsoleMessage("Content directory does not exist.", "ERR", "NgineCook");
+        return 1;
+    }
+
+    auto outPath = Path(argv[2]);
+    CreateDirectories(outPath);
+
+    // Same extensions as Resources
+    std::vector<std::string> fntExts = {"ttf", "otf"};
+    std::vector<std::string> musExts = {"ogg", "flac", "mp3"};
+    std::vector<std::string> sndExts = {"wav", "ogg", "flac", "mp3"};
+    std::vector<std::string> texExts = {"png", "bmp", "tga", "gif", "pic", "psd", "dds", "ktx", "qoi", "nimg"};
+
+    Manifest manifest;
+    auto failed = 0;
+    auto skipped = 0;
+
+    DirectoryIterator it(contentDir.GetObjectPath());
+    while (it.Next()) {
+        auto path = Path(it.GetPath());
+        auto relative = it.GetRelativePath();
+        std::string ext = it.GetExtension();
+
+        // Names and manifest paths use forward slashes
+        auto name = it.GetRelativePathNoExtension();
+
+        CreateDirectories((outPath / relative).GetParent());
+
+        // Builds run this every time, so only files that changed are cooked.
+        // Times are in seconds, an output from the same second as its source is cooked again to be safe.
+        auto modified = GetModifiedTime(path);
+        auto upToDate = [&](const Path &out_) {
+            auto cooked = GetModifiedTime(out_);
+            if (options.Force || cooked == 0 || cooked <= modified) return false;
+            skipped++;
+            return true;
+        };
+
+        auto cook = [&](ManifestEntryType type_, const std::string &outExt_, const std::function<bool(const Path &)> &func_) {
+            auto outFile = name + "." + outExt_;
+            if (upToDate(outPath / outFile) || func_(outPath / outFile)) manifest.Add(type_, name, outFile, GetFileSize(outPath / outFile));
+            else {
+                ConsoleMessage("Failed to cook " + relative + ".", "ERR", "NgineCook");
+                failed++;
+            }
+        };
+
+        auto known = false;
+
+        if (HasExtension(fntExts, ext)) {
+            cook(MANIFEST_FONT, "nfnt", [&](const Path &out_) { return CookFont(path, out_, options); });
+            known = true;
+        }
+
+        if (HasExtension(musExts, ext)) {
+            cook(MANIFEST_MUSIC, ext, [&](const Path &out_) { return CopyFile(path, out_); });
+            known = true;
+        }
+
+        if (HasExtension(sndExts, ext)) {
+            cook(MANIFEST_SOUND, "nwav", [&](const Path &out_) { return CookSound(path, out_); });
+            known = true;
+        }
+
+        if (HasExtension(texExts, ext)) {
+            cook(MANIFEST_TEXTURE, "nimg", [&](const Path &out_) { return CookTexture(path, out_, options); });
+            known = true;
+        }
+
+        // Everything else is the game's own data
+        if (!known && !upToDate(outPath / relative) && !CopyFile(path, outPath / relative)) {
+            ConsoleMessage("Failed to copy " + relative + ".", "ERR", "NgineCook");
+            failed++;
+        }
+    }
+
+    if (!manifest.Save(outPath / Manifest::FileName)) {
+        ConsoleMessage("Failed to write the manifest.", "ERR", "NgineCook");
+        return 1;
+    }
+
+    ConsoleMessage("Cooked " + std::to_string(manifest.GetEntries().size()) + " resources, " + std::to_string(skipped) + " files were up to date.", "NOTICE", "NgineCook");
+    return failed == 0 ? 0 : 1;
+}
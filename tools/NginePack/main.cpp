@@ -0,0 +1,39 @@
+/**********************************************************************************************
+*
+*   Ngine - The 2D game engine.
+*
+*   Copyright (C) 2019 NerdThings
+*
+*   LICENSE: Apache License 2.0
+*   View: https://github.com/NerdThings/Ngine/blob/master/LICENSE
+*
+**********************************************************************************************/
+
+#include <Ngine.h>
+
+#include <Filesystem/Archive.h>
+#include <Filesystem/Filesystem.h>
+
+#include <cstring>
+
+using namespace NGINE_NS::Filesystem;
+
+/*
+ * Packs a content directory into an .npak archive.
+ * Usage: NginePack <content directory> <output archive> [--store]
+ */
+int main(int argc, char **argv) {
+    if (argc < 3 || argc > 4 || (argc == 4 && strcmp(argv[3], "--store") != 0)) {
+        ConsoleMessage("Usage: NginePack <content directory> <output archive> [--store]", "ERR", "NginePack");
+        return 1;
+    }
+
+    auto directory = Directory(Path(argv[1]));
+    if (!directory.Exists()) {
+        ConsoleMessage("Content directory does not exist.", "ERR", "NginePack");
+        return 1;
+    }
+
+    // --store disables compression
+    return Archive::Pack(directory, Path(argv[2]), argc != 4) ? 0 : 1;
+}